@@ -0,0 +1,127 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "sirtet.h"
+
+
+// Header of an overflow allocation, which follows it (suitably aligned)
+struct ArenaOverflow {
+    ArenaOverflow *next;
+};
+
+#define ALIGN_UP(n) (((n) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+#define OVERFLOW_HEADER_SZ ALIGN_UP(sizeof(ArenaOverflow))
+
+
+Arena* Arena_init(size_t capacity) {
+
+    Arena *retval = (Arena*)malloc(sizeof(Arena));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for Arena\n");
+        return NULL;
+    }
+
+    capacity = ALIGN_UP(capacity);
+    *retval = (Arena){
+        .memory=NULL,
+        .capacity=0,
+        .used=0,
+        .overflow=NULL,
+        .overflow_used=0
+    };
+
+    if (capacity > 0) {
+        retval->memory = (char*)malloc(capacity);
+        if (retval->memory == NULL) {
+            Sirtet_setError("Error allocating memory for Arena block\n");
+            free(retval);
+            return NULL;
+        }
+        retval->capacity = capacity;
+    }
+    return retval;
+}
+
+
+static void Arena_freeOverflow(Arena *self) {
+    ArenaOverflow *overflow = self->overflow;
+    while (overflow != NULL) {
+        ArenaOverflow *next = overflow->next;
+        free(overflow);
+        overflow = next;
+    }
+    self->overflow = NULL;
+    self->overflow_used = 0;
+}
+
+
+void Arena_deconstruct(Arena *self) {
+    if (self == NULL) {
+        return;
+    }
+    Arena_freeOverflow(self);
+    free(self->memory);
+    free(self);
+}
+
+
+void* Arena_alloc(Arena *self, size_t size) {
+
+    // Zero-sized allocations still get a unique address
+    size = ALIGN_UP(size > 0 ? size : 1);
+
+    if (size <= self->capacity - self->used) {
+        void *retval = self->memory + self->used;
+        self->used += size;
+        return retval;
+    }
+
+    // Block exhausted - keep going from the heap until next reset
+    ArenaOverflow *overflow = (ArenaOverflow*)malloc(OVERFLOW_HEADER_SZ + size);
+    if (overflow == NULL) {
+        Sirtet_setError("Error allocating Arena overflow memory\n");
+        return NULL;
+    }
+    overflow->next = self->overflow;
+    self->overflow = overflow;
+    self->overflow_used += size;
+
+    return (char*)overflow + OVERFLOW_HEADER_SZ;
+}
+
+
+void* Arena_calloc(Arena *self, size_t n, size_t size) {
+    void *retval = Arena_alloc(self, n * size);
+    if (retval != NULL) {
+        memset(retval, 0, n * size);
+    }
+    return retval;
+}
+
+
+void Arena_reset(Arena *self) {
+
+    size_t high_water = Arena_used(self);
+    Arena_freeOverflow(self);
+    self->used = 0;
+
+    if (high_water <= self->capacity) {
+        return;
+    }
+
+    // Grow block so the same workload fits in it next time. If that isn't
+    // possible, keep the old block (and overflow again)
+    char *memory = (char*)malloc(high_water);
+    if (memory == NULL) {
+        return;
+    }
+    free(self->memory);
+    self->memory = memory;
+    self->capacity = high_water;
+}
+
+
+size_t Arena_used(Arena *self) {
+    return self->used + self->overflow_used;
+}
@@ -0,0 +1,54 @@
+/* arena.h
+*
+* Bump allocator over a single block of memory. Allocations are never freed
+* individually; the whole arena is reset (or deconstructed) in one step.
+*
+* An allocation that doesn't fit in the remainder of the block is served
+* from a separate overflow allocation rather than failing. Resetting frees
+* any overflow and grows the block to the most that was ever needed at once,
+* so an arena reused for the same kind of work stops touching the heap after
+* its first use.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+
+
+// Alignment of every allocation (suitable for any scalar type)
+#define ARENA_ALIGN 16
+
+
+typedef struct ArenaOverflow ArenaOverflow;
+
+typedef struct {
+    char *memory;               // Block allocations are bumped from
+    size_t capacity;            // Size of block, in bytes
+    size_t used;                // Bytes of block allocated since last reset
+
+    ArenaOverflow *overflow;    // Allocations that didn't fit in block
+    size_t overflow_used;       // Bytes allocated from overflow since reset
+} Arena;
+
+
+// Initialize an arena over a block of (at least) capacity bytes
+Arena* Arena_init(size_t capacity);
+
+// Free arena and everything allocated from it
+void Arena_deconstruct(Arena *self);
+
+// Allocate size bytes, aligned to ARENA_ALIGN. NULL if heap is exhausted
+void* Arena_alloc(Arena *self, size_t size);
+
+// Allocate zeroed memory for an array of n elements of size bytes each
+void* Arena_calloc(Arena *self, size_t n, size_t size);
+
+// Release everything allocated from arena at once, keeping its block (grown
+// to fit everything allocated since last reset) for reuse
+void Arena_reset(Arena *self);
+
+// Total bytes allocated since last reset, including overflow
+size_t Arena_used(Arena *self);
+
+#endif
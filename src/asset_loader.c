@@ -0,0 +1,214 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "sirtet.h"
+#include "sirtet_audio.h"
+
+
+static double msBetween(Uint64 start, Uint64 stop) {
+    return (double)(stop - start) * 1000 / SDL_GetPerformanceFrequency();
+}
+
+
+// Record a job's failure, unless another already has
+static void fail(AssetLoader *self, const char *errmsg) {
+    if (SDL_AtomicCAS(&self->failed, 0, 1)) {
+        snprintf(self->error, ERRMSG_SZ, "%s", errmsg);
+    }
+}
+
+
+static void runJob(AssetLoader *self, AssetJob *job) {
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // Error is set on this thread - handed over by fail(...)
+    SDL_RWops *src = AssetLoader_open(self, job->name);
+    if (src == NULL) {
+        fail(self, Sirtet_getError());
+    }
+    else if (job->kind == ASSET_JOB_IMAGE) {
+        job->result = SDL_LoadBMP_RW(src, 1);
+        if (job->result == NULL) {
+            char buff[ERRMSG_SZ];
+            snprintf(
+                buff, ERRMSG_SZ,
+                "Error loading image %s:\n    %s\n", job->name, SDL_GetError()
+            );
+            fail(self, buff);
+        }
+    }
+    else {
+        // NOTE: Decodes to the format of the already opened audio device,
+        // but touches no mixer state, so is safe off the main thread
+        job->result = SirtetAudio_loadSoundRW(src);
+        if (SirtetAudio_soundInvalid(job->result)) {
+            fail(self, Sirtet_getError());
+        }
+    }
+
+    job->ms = msBetween(start, SDL_GetPerformanceCounter());
+    SDL_AtomicAdd(&self->n_done, 1);
+}
+
+
+// Worker thread - takes jobs until there are none left
+static int work(void *data) {
+
+    AssetLoader *self = (AssetLoader*)data;
+
+    int idx;
+    while ((idx = SDL_AtomicAdd(&self->next_job, 1)) < self->n_jobs) {
+        runJob(self, &self->jobs[idx]);
+    }
+    return 0;
+}
+
+
+AssetLoader* AssetLoader_init(AssetPack *pack, const char *folder) {
+
+    // memory structure:
+    // [] AssetLoader struct
+    // [] folder
+    // [] error message
+    size_t folder_sz = strlen(folder) + 1;
+    void *mem = calloc(1, sizeof(AssetLoader) + folder_sz + ERRMSG_SZ);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for AssetLoader\n");
+        return NULL;
+    }
+
+    AssetLoader *retval = (AssetLoader*)mem;
+    retval->pack = pack;
+    retval->folder = (char*)mem + sizeof(AssetLoader);
+    retval->error = retval->folder + folder_sz;
+    memcpy(retval->folder, folder, folder_sz);
+
+    SDL_AtomicSet(&retval->next_job, 0);
+    SDL_AtomicSet(&retval->failed, 0);
+    SDL_AtomicSet(&retval->n_done, 0);
+
+    return retval;
+}
+
+
+void AssetLoader_deconstruct(AssetLoader *self) {
+
+    if (self == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < self->n_threads; i++) {
+        if (self->threads[i] != NULL) {
+            SDL_WaitThread(self->threads[i], NULL);
+        }
+    }
+
+    for (int i = 0; i < self->n_jobs; i++) {
+        if (self->jobs[i].result == NULL) {
+            continue;
+        }
+        if (self->jobs[i].kind == ASSET_JOB_IMAGE) {
+            SDL_FreeSurface((SDL_Surface*)self->jobs[i].result);
+        }
+        else {
+            SirtetAudio_unloadSound((SirtetAudio_sound)self->jobs[i].result);
+        }
+    }
+
+    free(self);
+}
+
+
+SDL_RWops* AssetLoader_open(AssetLoader *self, const char *name) {
+    return AssetPack_openAsset(self->pack, self->folder, name);
+}
+
+
+static int addJob(AssetLoader *self, const char *name, AssetJobKind kind) {
+
+    if (self->n_jobs == ASSET_LOADER_MAX_JOBS) {
+        Sirtet_setError("AssetLoader queue is full\n");
+        return -1;
+    }
+
+    self->jobs[self->n_jobs] = (AssetJob){
+        .name=name,
+        .kind=kind,
+        .result=NULL,
+        .ms=0
+    };
+    return self->n_jobs++;
+}
+
+
+int AssetLoader_addImage(AssetLoader *self, const char *name) {
+    return addJob(self, name, ASSET_JOB_IMAGE);
+}
+
+
+int AssetLoader_addSound(AssetLoader *self, const char *name) {
+    return addJob(self, name, ASSET_JOB_SOUND);
+}
+
+
+int AssetLoader_start(AssetLoader *self) {
+
+    int n_threads = SDL_GetCPUCount();
+    n_threads = n_threads < ASSET_LOADER_MAX_THREADS ? n_threads : ASSET_LOADER_MAX_THREADS;
+    n_threads = n_threads < self->n_jobs ? n_threads : self->n_jobs;
+
+    // If threads can't be had, whatever's left is loaded on waiting
+    for (int i = 0; i < n_threads; i++) {
+        SDL_Thread *thread = SDL_CreateThread(work, "asset loader", (void*)self);
+        if (thread == NULL) {
+            break;
+        }
+        self->threads[self->n_threads++] = thread;
+    }
+
+    return 0;
+}
+
+
+bool AssetLoader_done(AssetLoader *self) {
+    return SDL_AtomicGet(&self->n_done) == self->n_jobs;
+}
+
+
+int AssetLoader_wait(AssetLoader *self) {
+
+    // Help out rather than idle
+    work((void*)self);
+
+    for (int i = 0; i < self->n_threads; i++) {
+        SDL_WaitThread(self->threads[i], NULL);
+        self->threads[i] = NULL;
+    }
+
+    if (SDL_AtomicGet(&self->failed)) {
+        Sirtet_setError(self->error);
+        return -1;
+    }
+    return 0;
+}
+
+
+SDL_Surface* AssetLoader_takeImage(AssetLoader *self, int job) {
+    SDL_Surface *retval = (SDL_Surface*)self->jobs[job].result;
+    self->jobs[job].result = NULL;
+    return retval;
+}
+
+
+SirtetAudio_sound AssetLoader_takeSound(AssetLoader *self, int job) {
+    SirtetAudio_sound retval = (SirtetAudio_sound)self->jobs[job].result;
+    self->jobs[job].result = NULL;
+    return retval;
+}
+
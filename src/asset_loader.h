@@ -0,0 +1,89 @@
+/* asset_loader.h
+*
+* Background asset loader. Images and sounds are read & decoded into CPU-side
+* memory (SDL_Surfaces & sound chunks) on worker threads, so the main thread
+* is free to carry on meanwhile - setting up the window & renderer at
+* startup, or running the current state when prefetching for the next (see
+* AssetManager). Only work that must happen on the main thread - uploading
+* surfaces to textures - is left for once the loader is waited on.
+*
+* Assets are read from an AssetPack when one is given, and from files under
+* the asset folder otherwise.
+*/
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "asset_pack.h"
+#include "sirtet_audio.h"
+
+
+#define ASSET_LOADER_MAX_JOBS 32
+#define ASSET_LOADER_MAX_THREADS 4
+
+
+typedef enum {
+    ASSET_JOB_IMAGE,
+    ASSET_JOB_SOUND
+} AssetJobKind;
+
+
+typedef struct {
+    const char *name;           // Asset name, e.g. "img/Logo.bmp"
+    AssetJobKind kind;
+    void *result;               // SDL_Surface* or SirtetAudio_sound, once done
+    double ms;                  // Time taken to read & decode
+} AssetJob;
+
+
+typedef struct {
+    AssetPack *pack;            // Pack to read from, or NULL to read files
+    char *folder;               // Folder to read files from
+
+    AssetJob jobs[ASSET_LOADER_MAX_JOBS];
+    int n_jobs;
+
+    SDL_Thread *threads[ASSET_LOADER_MAX_THREADS];
+    int n_threads;
+    SDL_atomic_t next_job;      // Index of next job for a worker to take
+    SDL_atomic_t failed;        // Set by the first job to fail
+    SDL_atomic_t n_done;        // Number of jobs finished, failed or not
+    char *error;                // Error message of first failed job
+} AssetLoader;
+
+
+// Create a loader reading from pack, or (if NULL) from files under folder.
+// pack must outlive the loader
+AssetLoader* AssetLoader_init(AssetPack *pack, const char *folder);
+
+// Wait for any running workers, and free the loader along with any results
+// not taken
+void AssetLoader_deconstruct(AssetLoader *self);
+
+// Open a read-only SDL_RWops over an asset, or NULL (with error set) if it
+// can't be opened. Safe to call from any thread
+SDL_RWops* AssetLoader_open(AssetLoader *self, const char *name);
+
+// Queue an image or sound to load, returning its job id (or -1 if the queue
+// is full). Only before AssetLoader_start(...)
+int AssetLoader_addImage(AssetLoader *self, const char *name);
+int AssetLoader_addSound(AssetLoader *self, const char *name);
+
+// Start loading queued assets on worker threads. Returns 0 on success
+int AssetLoader_start(AssetLoader *self);
+
+// Whether every queued asset has finished loading, so that waiting won't block
+bool AssetLoader_done(AssetLoader *self);
+
+// Block until all queued assets are loaded. Returns 0 on success, -1 (with
+// error set) if any failed
+int AssetLoader_wait(AssetLoader *self);
+
+// Take ownership of a loaded asset. Only after AssetLoader_wait(...)
+SDL_Surface* AssetLoader_takeImage(AssetLoader *self, int job);
+SirtetAudio_sound AssetLoader_takeSound(AssetLoader *self, int job);
+
+#endif
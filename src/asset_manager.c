@@ -0,0 +1,655 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_loader.h"
+#include "asset_manager.h"
+#include "asset_pack.h"
+#include "backgrounds.h"
+#include "sirtet.h"
+#include "sirtet_audio.h"
+
+
+// Quadrant suffixes of a tiled image, in the order they're composed
+static const char *tile_parts[4] = {
+    "TopLeft.bmp", "TopRight.bmp", "BottomLeft.bmp", "BottomRight.bmp"
+};
+
+
+/******************************************************************************
+ * Helpers
+******************************************************************************/
+
+static double msSince(Uint64 start) {
+    return (
+        (double)(SDL_GetPerformanceCounter() - start) * 1000
+        / SDL_GetPerformanceFrequency()
+    );
+}
+
+
+static AssetEntry* getEntry(AssetManager *self, AssetHandle handle) {
+    if (handle < 0 || handle >= self->count) {
+        Sirtet_setError("Invalid asset handle\n");
+        return NULL;
+    }
+    return &self->entries[handle];
+}
+
+
+static int numParts(AssetEntry *entry) {
+    return entry->desc.kind == ASSET_TILED_IMAGE ? 4 : 1;
+}
+
+
+static bool inFlight(AssetEntry *entry) {
+    return entry->jobs[0] >= 0;
+}
+
+
+// Handle of the described asset, registering it if not yet known
+static AssetHandle find(AssetManager *self, const AssetDesc *desc) {
+
+    for (int i = 0; i < self->count; i++) {
+        AssetDesc *known = &self->entries[i].desc;
+        if (
+            known->kind == desc->kind
+            && strcmp(known->name, desc->name) == 0
+            && (desc->kind != ASSET_FONT || known->ptsize == desc->ptsize)
+        ) {
+            return i;
+        }
+    }
+
+    if (self->count == ASSET_MANAGER_MAX) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ, "Too many assets to manage %s\n", desc->name);
+        Sirtet_setError(buff);
+        return INVALID_ASSET_HANDLE;
+    }
+
+    AssetEntry *entry = &self->entries[self->count];
+    *entry = (AssetEntry){.desc=*desc};
+    for (int i = 0; i < 4; i++) {
+        entry->jobs[i] = -1;
+    }
+    if (desc->kind == ASSET_TILED_IMAGE) {
+        for (int i = 0; i < 4; i++) {
+            snprintf(
+                entry->parts[i], ASSET_PACK_NAME_SZ,
+                "%s%s", desc->name, tile_parts[i]
+            );
+        }
+    }
+    else {
+        snprintf(entry->parts[0], ASSET_PACK_NAME_SZ, "%s", desc->name);
+    }
+
+    return self->count++;
+}
+
+
+static void store(
+    AssetManager *self, AssetEntry *entry, void *resource, size_t bytes,
+    double ms
+) {
+    entry->resource = resource;
+    entry->bytes = bytes;
+    entry->ms = ms;
+    self->resident_bytes += bytes;
+    self->n_loads++;
+}
+
+
+static void unload(AssetManager *self, AssetEntry *entry) {
+
+    if (entry->resource == NULL) {
+        return;
+    }
+
+    switch (entry->desc.kind) {
+        case ASSET_FONT:
+            TTF_CloseFont((TTF_Font*)entry->resource);
+            break;
+        case ASSET_IMAGE:
+        case ASSET_TILED_IMAGE:
+            SDL_DestroyTexture((SDL_Texture*)entry->resource);
+            break;
+        case ASSET_SOUND:
+            SirtetAudio_unloadSound((SirtetAudio_sound)entry->resource);
+            break;
+    }
+
+    self->resident_bytes -= entry->bytes;
+    entry->resource = NULL;
+    entry->bytes = 0;
+}
+
+
+// Compose (for tiled images) & upload decoded surfaces, freeing them.
+// Returns 0 on success, -1 on error
+static int upload(
+    AssetManager *self, AssetEntry *entry, SDL_Surface **surfs, double ms
+) {
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    SDL_Surface *surf = surfs[0];
+    if (entry->desc.kind == ASSET_TILED_IMAGE) {
+        surf = PanningBg_composeQuadrants(surfs[0], surfs[1], surfs[2], surfs[3]);
+        for (int i = 0; i < 4; i++) {
+            SDL_FreeSurface(surfs[i]);
+        }
+        if (surf == NULL) {
+            return -1;
+        }
+    }
+
+    if (self->rend == NULL) {
+        SDL_FreeSurface(surf);
+        Sirtet_setError("No renderer to upload images to\n");
+        return -1;
+    }
+
+    // Textures belong to the renderer, so are made on the main thread
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(self->rend, surf);
+    size_t bytes = (size_t)surf->w * surf->h * 4;
+    SDL_FreeSurface(surf);
+    if (texture == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ, "Error uploading image %s:\n    %s\n",
+            entry->desc.name, SDL_GetError()
+        );
+        Sirtet_setError(buff);
+        return -1;
+    }
+
+    store(self, entry, texture, bytes, ms + msSince(start));
+    return 0;
+}
+
+
+static size_t soundBytes(SirtetAudio_sound sound) {
+    return sound->alen;
+}
+
+
+// Load an asset on the calling (main) thread
+static int loadNow(AssetManager *self, AssetEntry *entry) {
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    AssetDesc *desc = &entry->desc;
+
+    if (desc->kind == ASSET_FONT) {
+
+        // NOTE: Fonts read from their source as glyphs are rendered, so it's
+        // kept open (and the asset pack mapped) for as long as they're loaded
+        SDL_RWops *src = AssetPack_openAsset(self->pack, self->folder, desc->name);
+        if (src == NULL) {
+            return -1;
+        }
+        TTF_Font *font = TTF_OpenFontRW(src, 1, desc->ptsize);
+        if (font == NULL) {
+            char buff[ERRMSG_SZ];
+            snprintf(
+                buff, ERRMSG_SZ, "Error loading font %s:\n    %s\n",
+                desc->name, TTF_GetError()
+            );
+            Sirtet_setError(buff);
+            return -1;
+        }
+        store(self, entry, font, 0, msSince(start));
+        return 0;
+    }
+
+    if (desc->kind == ASSET_SOUND) {
+
+        SDL_RWops *src = AssetPack_openAsset(self->pack, self->folder, desc->name);
+        if (src == NULL) {
+            return -1;
+        }
+        SirtetAudio_sound sound = SirtetAudio_loadSoundRW(src);
+        if (SirtetAudio_soundInvalid(sound)) {
+            return -1;
+        }
+        store(self, entry, sound, soundBytes(sound), msSince(start));
+        return 0;
+    }
+
+    SDL_Surface *surfs[4] = {NULL};
+    int n_parts = numParts(entry);
+    for (int i = 0; i < n_parts; i++) {
+
+        SDL_RWops *src = AssetPack_openAsset(
+            self->pack, self->folder, entry->parts[i]);
+        if (src != NULL) {
+            surfs[i] = SDL_LoadBMP_RW(src, 1);
+            if (surfs[i] == NULL) {
+                char buff[ERRMSG_SZ];
+                snprintf(
+                    buff, ERRMSG_SZ, "Error loading image %s:\n    %s\n",
+                    entry->parts[i], SDL_GetError()
+                );
+                Sirtet_setError(buff);
+            }
+        }
+
+        if (surfs[i] == NULL) {
+            for (int j = 0; j < i; j++) {
+                SDL_FreeSurface(surfs[j]);
+            }
+            return -1;
+        }
+    }
+
+    return upload(self, entry, surfs, msSince(start));
+}
+
+
+// Wait on a running prefetch (if any) & make what it loaded resident.
+// Returns -1 (with error set) if anything failed to load
+static int finishPrefetch(AssetManager *self) {
+
+    AssetLoader *loader = self->loader;
+    if (loader == NULL) {
+        return 0;
+    }
+
+    int retval = AssetLoader_wait(loader);
+
+    for (int i = 0; i < self->count; i++) {
+
+        AssetEntry *entry = &self->entries[i];
+        if (!inFlight(entry)) {
+            continue;
+        }
+
+        // Trimmed while in flight, & still unreferenced - results are freed
+        // along with the loader
+        if (entry->trimmed && entry->refs == 0) {
+            for (int p = 0; p < 4; p++) {
+                entry->jobs[p] = -1;
+            }
+            entry->trimmed = false;
+            continue;
+        }
+        entry->trimmed = false;
+
+        int n_parts = numParts(entry);
+        double ms = 0;
+        for (int p = 0; p < n_parts; p++) {
+            ms += loader->jobs[entry->jobs[p]].ms;
+        }
+
+        if (entry->desc.kind == ASSET_SOUND) {
+            SirtetAudio_sound sound = AssetLoader_takeSound(loader, entry->jobs[0]);
+            if (!SirtetAudio_soundInvalid(sound)) {
+                store(self, entry, sound, soundBytes(sound), ms);
+            }
+            else {
+                entry->prefetch_failed = true;
+            }
+        }
+        else {
+            SDL_Surface *surfs[4] = {NULL};
+            bool decoded = true;
+            for (int p = 0; p < n_parts; p++) {
+                surfs[p] = AssetLoader_takeImage(loader, entry->jobs[p]);
+                decoded = decoded && surfs[p] != NULL;
+            }
+
+            if (!decoded) {
+                for (int p = 0; p < n_parts; p++) {
+                    SDL_FreeSurface(surfs[p]);
+                }
+                entry->prefetch_failed = true;
+            }
+            else if (upload(self, entry, surfs, ms) != 0) {
+                entry->prefetch_failed = true;
+                retval = -1;
+            }
+        }
+
+        for (int p = 0; p < 4; p++) {
+            entry->jobs[p] = -1;
+        }
+    }
+
+    AssetLoader_deconstruct(loader);
+    self->loader = NULL;
+    return retval;
+}
+
+
+/******************************************************************************
+ * AssetManager
+******************************************************************************/
+
+AssetManager* AssetManager_init(AssetPack *pack, const char *folder) {
+
+    // memory structure:
+    // [] AssetManager struct
+    // [] folder
+    size_t folder_sz = strlen(folder) + 1;
+    void *mem = calloc(1, sizeof(AssetManager) + folder_sz);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for AssetManager\n");
+        return NULL;
+    }
+
+    AssetManager *retval = (AssetManager*)mem;
+    retval->pack = pack;
+    retval->folder = (char*)mem + sizeof(AssetManager);
+    memcpy(retval->folder, folder, folder_sz);
+
+    return retval;
+}
+
+
+void AssetManager_deconstruct(AssetManager *self) {
+
+    if (self == NULL) {
+        return;
+    }
+
+    // Results not yet picked up are freed with the loader
+    AssetLoader_deconstruct(self->loader);
+
+    for (int i = 0; i < self->count; i++) {
+        unload(self, &self->entries[i]);
+    }
+    free(self);
+}
+
+
+void AssetManager_setRenderer(AssetManager *self, SDL_Renderer *rend) {
+    self->rend = rend;
+}
+
+
+AssetHandle AssetManager_acquire(AssetManager *self, const AssetDesc *desc) {
+
+    AssetHandle retval = find(self, desc);
+    if (retval != INVALID_ASSET_HANDLE) {
+        self->entries[retval].refs++;
+    }
+    return retval;
+}
+
+
+void AssetManager_release(AssetManager *self, AssetHandle handle) {
+
+    AssetEntry *entry = getEntry(self, handle);
+    if (entry == NULL || entry->refs == 0) {
+        return;
+    }
+
+    entry->refs--;
+    if (entry->refs == 0) {
+        unload(self, entry);
+    }
+}
+
+
+int AssetManager_load(AssetManager *self, AssetHandle handle) {
+
+    AssetEntry *entry = getEntry(self, handle);
+    if (entry == NULL) {
+        return -1;
+    }
+    if (entry->resource != NULL) {
+        return 0;
+    }
+
+    // Already on its way - no sense decoding it twice. Should the prefetch
+    // have failed, the load is retried here to report why
+    if (inFlight(entry)) {
+        finishPrefetch(self);
+        if (entry->resource != NULL) {
+            return 0;
+        }
+    }
+
+    return loadNow(self, entry);
+}
+
+
+// Resource of an asset of the given kind, loading it on first use
+static void* getResource(
+    AssetManager *self, AssetHandle handle, AssetKind kind
+) {
+
+    AssetEntry *entry = getEntry(self, handle);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    AssetKind held = entry->desc.kind;
+    held = held == ASSET_TILED_IMAGE ? ASSET_IMAGE : held;
+    if (held != kind) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ, "Asset %s is not of the kind requested\n",
+            entry->desc.name
+        );
+        Sirtet_setError(buff);
+        return NULL;
+    }
+
+    if (AssetManager_load(self, handle) != 0) {
+        return NULL;
+    }
+    return entry->resource;
+}
+
+
+TTF_Font* AssetManager_font(AssetManager *self, AssetHandle handle) {
+    return (TTF_Font*)getResource(self, handle, ASSET_FONT);
+}
+
+
+SDL_Texture* AssetManager_texture(AssetManager *self, AssetHandle handle) {
+    return (SDL_Texture*)getResource(self, handle, ASSET_IMAGE);
+}
+
+
+SirtetAudio_sound AssetManager_sound(AssetManager *self, AssetHandle handle) {
+    return (SirtetAudio_sound)getResource(self, handle, ASSET_SOUND);
+}
+
+
+bool AssetManager_resident(AssetManager *self, AssetHandle handle) {
+    AssetEntry *entry = getEntry(self, handle);
+    return entry != NULL && entry->resource != NULL;
+}
+
+
+int AssetManager_prefetch(AssetManager *self, const AssetDesc *descs, int n) {
+
+    if (self->loader != NULL) {
+        return 0;
+    }
+
+    int retval = 0;
+    AssetLoader *loader = NULL;
+
+    for (int i = 0; i < n && retval == 0; i++) {
+
+        if (descs[i].kind == ASSET_FONT) {
+            continue;
+        }
+
+        AssetHandle handle = find(self, &descs[i]);
+        if (handle == INVALID_ASSET_HANDLE) {
+            retval = -1;
+            break;
+        }
+
+        AssetEntry *entry = &self->entries[handle];
+        if (entry->resource != NULL || inFlight(entry) || entry->prefetch_failed) {
+            continue;
+        }
+
+        if (loader == NULL) {
+            loader = AssetLoader_init(self->pack, self->folder);
+            if (loader == NULL) {
+                return -1;
+            }
+        }
+
+        // Names are kept in the entry, so outlive the loader
+        int n_parts = numParts(entry);
+        for (int p = 0; p < n_parts; p++) {
+            entry->jobs[p] = (
+                entry->desc.kind == ASSET_SOUND
+                ? AssetLoader_addSound(loader, entry->parts[p])
+                : AssetLoader_addImage(loader, entry->parts[p])
+            );
+            if (entry->jobs[p] < 0) {
+                retval = -1;
+            }
+        }
+
+        // Partly queued assets are left to load on first use
+        if (retval != 0) {
+            for (int p = 0; p < 4; p++) {
+                entry->jobs[p] = -1;
+            }
+        }
+    }
+
+    if (loader == NULL) {
+        return retval;
+    }
+
+    self->loader = loader;
+    AssetLoader_start(loader);
+    return retval;
+}
+
+
+bool AssetManager_busy(AssetManager *self) {
+    return self->loader != NULL;
+}
+
+
+void AssetManager_trim(AssetManager *self) {
+
+    for (int i = 0; i < self->count; i++) {
+
+        AssetEntry *entry = &self->entries[i];
+        if (entry->refs > 0) {
+            continue;
+        }
+
+        if (inFlight(entry)) {
+            entry->trimmed = true;
+        }
+        unload(self, entry);
+    }
+}
+
+
+int AssetManager_poll(AssetManager *self) {
+
+    if (self->loader == NULL || !AssetLoader_done(self->loader)) {
+        return 0;
+    }
+    return finishPrefetch(self);
+}
+
+
+void AssetManager_report(AssetManager *self, FILE *out) {
+
+    int n_resident = 0;
+    fprintf(out, "Resident assets:\n");
+    for (int i = 0; i < self->count; i++) {
+
+        AssetEntry *entry = &self->entries[i];
+        if (entry->resource == NULL) {
+            continue;
+        }
+        n_resident++;
+
+        char label[ASSET_PACK_NAME_SZ + 16];
+        if (entry->desc.kind == ASSET_FONT) {
+            snprintf(
+                label, sizeof(label), "%s (%dpt)",
+                entry->desc.name, entry->desc.ptsize
+            );
+        }
+        else {
+            snprintf(label, sizeof(label), "%s", entry->desc.name);
+        }
+
+        fprintf(
+            out, "    %-32s %2d refs %10.1f KiB %8.2f ms\n",
+            label, entry->refs, entry->bytes / 1024.0, entry->ms
+        );
+    }
+    fprintf(
+        out, "    %d of %d known assets resident: %.1f KiB\n",
+        n_resident, self->count, self->resident_bytes / 1024.0
+    );
+}
+
+
+/******************************************************************************
+ * AssetSet
+******************************************************************************/
+
+int AssetSet_acquire(
+    AssetSet *self, AssetManager *manager, const AssetDesc *descs, int n
+) {
+
+    self->manager = manager;
+    self->count = 0;
+
+    if (n > ASSET_SET_MAX) {
+        Sirtet_setError("Too many assets for one AssetSet\n");
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        AssetHandle handle = AssetManager_acquire(manager, &descs[i]);
+        if (handle == INVALID_ASSET_HANDLE) {
+            AssetSet_release(self);
+            return -1;
+        }
+        self->handles[self->count++] = handle;
+    }
+    return 0;
+}
+
+
+void AssetSet_release(AssetSet *self) {
+    for (int i = 0; i < self->count; i++) {
+        AssetManager_release(self->manager, self->handles[i]);
+    }
+    self->count = 0;
+}
+
+
+bool AssetSet_held(AssetSet *self) {
+    return self->count > 0;
+}
+
+
+TTF_Font* AssetSet_font(AssetSet *self, int i) {
+    return AssetManager_font(self->manager, self->handles[i]);
+}
+
+
+SDL_Texture* AssetSet_texture(AssetSet *self, int i) {
+    return AssetManager_texture(self->manager, self->handles[i]);
+}
+
+
+SirtetAudio_sound AssetSet_sound(AssetSet *self, int i) {
+    return AssetManager_sound(self->manager, self->handles[i]);
+}
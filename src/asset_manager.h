@@ -0,0 +1,176 @@
+/* asset_manager.h
+*
+* Reference counted asset residency. Rather than every asset being loaded at
+* launch & kept for the whole run, each state declares the assets it needs
+* (see AssetSet) and holds references to them for as long as it lives. An
+* asset is loaded on first use, and unloaded as soon as its last reference is
+* released.
+*
+* Assets a state is about to need can be prefetched while the state before it
+* runs - images & sounds are decoded on worker threads (see AssetLoader), and
+* picked up by AssetManager_poll(...) once done. Prefetched assets stay
+* resident, unreferenced, until acquired or let go by AssetManager_trim(...).
+*
+* Handles are indices into the manager's table of known assets, so stay valid
+* for the manager's lifetime whether or not their asset is resident.
+*/
+
+#ifndef ASSET_MANAGER_H
+#define ASSET_MANAGER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "sirtet_audio.h"
+
+
+#define ASSET_MANAGER_MAX 32
+#define ASSET_SET_MAX 8
+
+#define INVALID_ASSET_HANDLE -1
+
+
+typedef enum {
+    ASSET_FONT,             // TTF_Font, opened at desc.ptsize
+    ASSET_IMAGE,            // SDL_Texture from a bmp
+    ASSET_TILED_IMAGE,      // SDL_Texture composed from the four quadrant
+                            // bmps desc.name + "TopLeft.bmp", "TopRight.bmp"...
+    ASSET_SOUND             // SirtetAudio_sound
+} AssetKind;
+
+
+// Describes an asset to load. Two descriptions of the same kind, name (and,
+// for fonts, size) refer to the same asset
+typedef struct {
+    AssetKind kind;
+    const char *name;       // e.g. "img/Logo.bmp". Must outlive the manager
+    int ptsize;             // Fonts only
+} AssetDesc;
+
+
+typedef int AssetHandle;
+
+
+typedef struct {
+    AssetDesc desc;
+    int refs;
+    void *resource;         // TTF_Font*, SDL_Texture* or sound, or NULL
+    size_t bytes;           // Approximate memory held by resource
+    double ms;              // Time taken by its last load
+    bool prefetch_failed;   // If so, it's left to load (& fail) on first use
+    bool trimmed;           // Trimmed while in flight - dropped once picked
+                            // up, unless referenced by then
+
+    // Loader jobs decoding it in the background, or -1 where none
+    int jobs[4];
+    char parts[4][ASSET_PACK_NAME_SZ];  // Quadrant names of tiled images
+} AssetEntry;
+
+
+typedef struct {
+    AssetPack *pack;            // Pack to read from, or NULL to read files
+    char *folder;               // Folder to read files from
+    SDL_Renderer *rend;         // Renderer images are uploaded to
+
+    AssetEntry entries[ASSET_MANAGER_MAX];
+    int count;
+
+    AssetLoader *loader;        // Background decoding in progress, or NULL
+
+    size_t resident_bytes;      // Total bytes of resident assets
+    int n_loads;                // Number of loads, including prefetches
+} AssetManager;
+
+
+// References held on a declared set of assets, e.g. everything a state needs
+typedef struct {
+    AssetManager *manager;
+    AssetHandle handles[ASSET_SET_MAX];
+    int count;
+} AssetSet;
+
+
+/******************************************************************************
+ * AssetManager
+******************************************************************************/
+
+// Create a manager reading from pack, or (if NULL) from files under folder.
+// pack must outlive the manager
+AssetManager* AssetManager_init(AssetPack *pack, const char *folder);
+
+// Unload every asset, referenced or not. Must come before the renderer, TTF &
+// audio are shut down
+void AssetManager_deconstruct(AssetManager *self);
+
+// Set the renderer images are uploaded to. Required before any image loads
+void AssetManager_setRenderer(AssetManager *self, SDL_Renderer *rend);
+
+// Take a reference on the described asset, returning its handle (or
+// INVALID_ASSET_HANDLE, with error set, if too many assets are known).
+// Does not load it
+AssetHandle AssetManager_acquire(AssetManager *self, const AssetDesc *desc);
+
+// Drop a reference, unloading the asset if it was the last
+void AssetManager_release(AssetManager *self, AssetHandle handle);
+
+// Load an asset if not yet resident. Returns 0 on success, -1 on error
+int AssetManager_load(AssetManager *self, AssetHandle handle);
+
+// An asset's resource, loading it on first use. NULL (or NULLSOUND) on error
+TTF_Font* AssetManager_font(AssetManager *self, AssetHandle handle);
+SDL_Texture* AssetManager_texture(AssetManager *self, AssetHandle handle);
+SirtetAudio_sound AssetManager_sound(AssetManager *self, AssetHandle handle);
+
+// Whether an asset is loaded
+bool AssetManager_resident(AssetManager *self, AssetHandle handle);
+
+/**
+ * @brief Start decoding described images & sounds on worker threads, so that
+ *        they're resident by the time they're needed. Fonts are left to
+ *        their first use. Does nothing while a previous prefetch is running,
+ *        so may be called every frame
+ * @return 0 on success, -1 on error
+ */
+int AssetManager_prefetch(AssetManager *self, const AssetDesc *descs, int n);
+
+// Whether a prefetch is still running, so that another would be ignored
+bool AssetManager_busy(AssetManager *self);
+
+// Unload every asset held by no one - ie: prefetched, but never acquired.
+// Those still being decoded are dropped once picked up, unless acquired first
+void AssetManager_trim(AssetManager *self);
+
+// Pick up a finished prefetch, uploading its images. Call once per frame.
+// Returns -1 (with error set) if any prefetched asset failed to load
+int AssetManager_poll(AssetManager *self);
+
+// Print resident assets & the memory they hold
+void AssetManager_report(AssetManager *self, FILE *out);
+
+
+/******************************************************************************
+ * AssetSet
+******************************************************************************/
+
+// Acquire every described asset into self, in order, so that descs[i] is
+// reached through index i. Returns 0 on success, -1 (holding nothing) on error
+int AssetSet_acquire(
+    AssetSet *self, AssetManager *manager, const AssetDesc *descs, int n);
+
+// Release everything held. Safe to call again, or on a set never acquired
+// (if zeroed)
+void AssetSet_release(AssetSet *self);
+
+// Whether the set holds anything
+bool AssetSet_held(AssetSet *self);
+
+// Resource of the i-th asset of the set, loading it on first use
+TTF_Font* AssetSet_font(AssetSet *self, int i);
+SDL_Texture* AssetSet_texture(AssetSet *self, int i);
+SirtetAudio_sound AssetSet_sound(AssetSet *self, int i);
+
+#endif
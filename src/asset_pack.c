@@ -0,0 +1,461 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "asset_pack.h"
+#include "sirtet.h"
+#include "utilities.h"
+
+
+/******************************************************************************
+ * Helpers
+******************************************************************************/
+
+
+static uint32_t readU32(const unsigned char *src) {
+    return (
+        (uint32_t)src[0]
+        | ((uint32_t)src[1] << 8)
+        | ((uint32_t)src[2] << 16)
+        | ((uint32_t)src[3] << 24)
+    );
+}
+
+
+static void writeU32(unsigned char *dst, uint32_t val) {
+    dst[0] = (unsigned char)(val & 0xFF);
+    dst[1] = (unsigned char)((val >> 8) & 0xFF);
+    dst[2] = (unsigned char)((val >> 16) & 0xFF);
+    dst[3] = (unsigned char)((val >> 24) & 0xFF);
+}
+
+
+static inline const unsigned char* entryAt(AssetPack *self, Uint32 idx) {
+    return self->data + ASSET_PACK_HEADER_SZ + idx * ASSET_PACK_ENTRY_SZ;
+}
+
+
+// Check everything a lookup relies on, so lookups needn't
+static int validate(AssetPack *self) {
+
+    const unsigned char *data = self->data;
+
+    if (
+        self->size < ASSET_PACK_HEADER_SZ
+        || memcmp(data, ASSET_PACK_MAGIC, 4) != 0
+    ) {
+        Sirtet_setError("Error reading asset pack: Not an asset pack\n");
+        return -1;
+    }
+    if (readU32(data + 4) != ASSET_PACK_VERSION) {
+        Sirtet_setError("Error reading asset pack: Unsupported version\n");
+        return -1;
+    }
+
+    Uint32 count = readU32(data + 8);
+    if (count > (self->size - ASSET_PACK_HEADER_SZ) / ASSET_PACK_ENTRY_SZ) {
+        Sirtet_setError("Error reading asset pack: Index is truncated\n");
+        return -1;
+    }
+
+    size_t index_sz = (size_t)count * ASSET_PACK_ENTRY_SZ;
+    if (checksumCrc32(data + ASSET_PACK_HEADER_SZ, index_sz) != readU32(data + 12)) {
+        Sirtet_setError("Error reading asset pack: Index is corrupt\n");
+        return -1;
+    }
+
+    self->count = count;
+    for (Uint32 i = 0; i < count; i++) {
+
+        const unsigned char *entry = entryAt(self, i);
+        const char *name = (const char*)entry;
+        size_t offset = readU32(entry + ASSET_PACK_NAME_SZ);
+        size_t size = readU32(entry + ASSET_PACK_NAME_SZ + 4);
+
+        if (
+            memchr(name, '\0', ASSET_PACK_NAME_SZ) == NULL
+            || offset > self->size || size > self->size - offset
+            || (i > 0 && strcmp((const char*)entryAt(self, i - 1), name) >= 0)
+        ) {
+            Sirtet_setError("Error reading asset pack: Bad index entry\n");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/******************************************************************************
+ * AssetPack
+******************************************************************************/
+
+
+AssetPack* AssetPack_initFromMemory(const void *data, size_t size) {
+
+    AssetPack *retval = (AssetPack*)malloc(sizeof(AssetPack));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for AssetPack\n");
+        return NULL;
+    }
+
+    *retval = (AssetPack){
+        .data=(const unsigned char*)data,
+        .size=size,
+        .count=0,
+        .mapped=false,
+        .owned=false
+    };
+
+    if (validate(retval) != 0) {
+        free(retval);
+        return NULL;
+    }
+    return retval;
+}
+
+
+AssetPack* AssetPack_initFromFile(const char *path) {
+
+    char buff[ERRMSG_SZ];
+
+#ifdef __linux__
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        snprintf(buff, ERRMSG_SZ, "Could not open asset pack %s\n", path);
+        Sirtet_setError(buff);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        Sirtet_setError("Error reading asset pack: Empty file\n");
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        snprintf(buff, ERRMSG_SZ, "Could not map asset pack %s\n", path);
+        Sirtet_setError(buff);
+        return NULL;
+    }
+
+    AssetPack *retval = AssetPack_initFromMemory(data, size);
+    if (retval == NULL) {
+        munmap(data, size);
+        return NULL;
+    }
+    retval->mapped = true;
+    return retval;
+
+#else
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        snprintf(buff, ERRMSG_SZ, "Could not open asset pack %s\n", path);
+        Sirtet_setError(buff);
+        return NULL;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    void *data = size > 0 ? malloc((size_t)size) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        free(data);
+        fclose(f);
+        Sirtet_setError("Error reading asset pack\n");
+        return NULL;
+    }
+    fclose(f);
+
+    AssetPack *retval = AssetPack_initFromMemory(data, (size_t)size);
+    if (retval == NULL) {
+        free(data);
+        return NULL;
+    }
+    retval->owned = true;
+    return retval;
+
+#endif
+}
+
+
+#ifdef SIRTET_EMBED_ASSETS
+
+// Defined by tools/embed_assets.S
+extern const unsigned char embedded_asset_pack[];
+extern const Uint64 embedded_asset_pack_size;
+
+AssetPack* AssetPack_initEmbedded() {
+    return AssetPack_initFromMemory(
+        embedded_asset_pack, (size_t)embedded_asset_pack_size);
+}
+
+#endif
+
+
+void AssetPack_deconstruct(AssetPack *self) {
+
+    if (self == NULL) {
+        return;
+    }
+
+#ifdef __linux__
+    if (self->mapped) {
+        munmap((void*)self->data, self->size);
+    }
+#endif
+    if (self->owned) {
+        free((void*)self->data);
+    }
+    free(self);
+}
+
+
+const void* AssetPack_find(AssetPack *self, const char *name, size_t *out_size) {
+
+    // Index is sorted by name
+    Uint32 lo = 0;
+    Uint32 hi = self->count;
+    while (lo < hi) {
+
+        Uint32 mid = lo + (hi - lo) / 2;
+        const unsigned char *entry = entryAt(self, mid);
+        int cmp = strcmp(name, (const char*)entry);
+
+        if (cmp == 0) {
+            if (out_size != NULL) {
+                *out_size = readU32(entry + ASSET_PACK_NAME_SZ + 4);
+            }
+            return self->data + readU32(entry + ASSET_PACK_NAME_SZ);
+        }
+        if (cmp < 0) {
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+
+    return NULL;
+}
+
+
+SDL_RWops* AssetPack_openRW(AssetPack *self, const char *name) {
+
+    size_t size;
+    const void *data = AssetPack_find(self, name, &size);
+    if (data == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(buff, ERRMSG_SZ, "Asset %s missing from asset pack\n", name);
+        Sirtet_setError(buff);
+        return NULL;
+    }
+
+    SDL_RWops *retval = SDL_RWFromConstMem(data, (int)size);
+    if (retval == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(buff, ERRMSG_SZ, "Error opening asset %s: %s\n", name, SDL_GetError());
+        Sirtet_setError(buff);
+    }
+    return retval;
+}
+
+
+SDL_RWops* AssetPack_openAsset(
+    AssetPack *self, const char *folder, const char *name) {
+
+    if (self != NULL) {
+        return AssetPack_openRW(self, name);
+    }
+
+    char path[FILEPATH_SZ];
+    snprintf(path, FILEPATH_SZ, "%s/%s", folder, name);
+    SDL_RWops *retval = SDL_RWFromFile(path, "rb");
+    if (retval == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(buff, ERRMSG_SZ, "Could not open asset %s\n", name);
+        Sirtet_setError(buff);
+    }
+    return retval;
+}
+
+
+/******************************************************************************
+ * Building
+******************************************************************************/
+
+
+static int compareNames(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+
+// Append the file at path to out, checking it's still size bytes long
+static int copyFile(FILE *out, const char *path, size_t size) {
+
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) {
+        return -1;
+    }
+
+    char buff[64 * 1024];
+    size_t copied = 0;
+    size_t nread;
+    while ((nread = fread(buff, 1, sizeof(buff), in)) > 0) {
+        if (fwrite(buff, 1, nread, out) != nread) {
+            fclose(in);
+            return -1;
+        }
+        copied += nread;
+    }
+    fclose(in);
+
+    return copied == size ? 0 : -1;
+}
+
+
+// Write a pack of already-sorted, already-checked names
+static int writePack(
+    FILE *out, const char *root, const char **names, size_t n,
+    unsigned char *index
+) {
+
+    char path[FILEPATH_SZ];
+
+    // Sizes come first, as the index precedes the data
+    size_t offset = ASSET_PACK_HEADER_SZ + n * ASSET_PACK_ENTRY_SZ;
+    for (size_t i = 0; i < n; i++) {
+
+        snprintf(path, FILEPATH_SZ, "%s/%s", root, names[i]);
+        FILE *in = fopen(path, "rb");
+        if (in == NULL) {
+            char buff[ERRMSG_SZ];
+            snprintf(buff, ERRMSG_SZ, "Could not open asset %s\n", names[i]);
+            Sirtet_setError(buff);
+            return -1;
+        }
+        fseek(in, 0, SEEK_END);
+        long size = ftell(in);
+        fclose(in);
+
+        if (size < 0 || offset + (size_t)size > UINT32_MAX) {
+            Sirtet_setError("Error building asset pack: Assets too large\n");
+            return -1;
+        }
+
+        unsigned char *entry = index + i * ASSET_PACK_ENTRY_SZ;
+        strcpy((char*)entry, names[i]);
+        writeU32(entry + ASSET_PACK_NAME_SZ, (uint32_t)offset);
+        writeU32(entry + ASSET_PACK_NAME_SZ + 4, (uint32_t)size);
+        offset += (size_t)size;
+    }
+
+    size_t index_sz = n * ASSET_PACK_ENTRY_SZ;
+    unsigned char header[ASSET_PACK_HEADER_SZ];
+    memcpy(header, ASSET_PACK_MAGIC, 4);
+    writeU32(header + 4, ASSET_PACK_VERSION);
+    writeU32(header + 8, (uint32_t)n);
+    writeU32(header + 12, checksumCrc32(index, index_sz));
+
+    if (
+        fwrite(header, 1, ASSET_PACK_HEADER_SZ, out) != ASSET_PACK_HEADER_SZ
+        || fwrite(index, 1, index_sz, out) != index_sz
+    ) {
+        Sirtet_setError("Error writing asset pack\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        snprintf(path, FILEPATH_SZ, "%s/%s", root, names[i]);
+        size_t size = readU32(index + i * ASSET_PACK_ENTRY_SZ + ASSET_PACK_NAME_SZ + 4);
+        if (copyFile(out, path, size) != 0) {
+            char buff[ERRMSG_SZ];
+            snprintf(buff, ERRMSG_SZ, "Error packing asset %s\n", names[i]);
+            Sirtet_setError(buff);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+int AssetPack_build(
+    const char *out_path, const char *root, const char *const *names, size_t n
+) {
+
+    for (size_t i = 0; i < n; i++) {
+        if (strlen(names[i]) >= ASSET_PACK_NAME_SZ) {
+            char buff[ERRMSG_SZ];
+            snprintf(buff, ERRMSG_SZ, "Asset name %s is too long to pack\n", names[i]);
+            Sirtet_setError(buff);
+            return -1;
+        }
+    }
+
+    // Sorted copy of names, so assets can be found by binary search
+    const char **sorted = (const char**)malloc((n + 1) * sizeof(const char*));
+    unsigned char *index = (unsigned char*)calloc(n + 1, ASSET_PACK_ENTRY_SZ);
+    if (sorted == NULL || index == NULL) {
+        free(sorted);
+        free(index);
+        Sirtet_setError("Error allocating memory to build asset pack\n");
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = names[i];
+    }
+    qsort(sorted, n, sizeof(const char*), compareNames);
+
+    int retval = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (strcmp(sorted[i - 1], sorted[i]) == 0) {
+            Sirtet_setError("Error building asset pack: Duplicate asset name\n");
+            retval = -1;
+        }
+    }
+
+    FILE *out = NULL;
+    if (retval == 0) {
+        out = fopen(out_path, "wb");
+        if (out == NULL) {
+            char buff[ERRMSG_SZ];
+            snprintf(buff, ERRMSG_SZ, "Could not open %s for writing\n", out_path);
+            Sirtet_setError(buff);
+            retval = -1;
+        }
+    }
+
+    if (retval == 0) {
+        retval = writePack(out, root, sorted, n, index);
+        if (fclose(out) != 0 && retval == 0) {
+            Sirtet_setError("Error writing asset pack\n");
+            retval = -1;
+        }
+        // Don't leave a partial pack to be picked up at startup
+        if (retval != 0) {
+            remove(out_path);
+        }
+    }
+
+    free(sorted);
+    free(index);
+    return retval;
+}
@@ -0,0 +1,87 @@
+/* asset_pack.h
+*
+* Packed asset archive. Every asset file is concatenated into one file behind
+* an index, so loading them all at startup costs one open and one map rather
+* than an open per asset (or two, for fonts loaded at two sizes). Assets are
+* handed out in place, without copying, as SDL_RWops over the mapped data,
+* for use with TTF_OpenFontRW, SDL_LoadBMP_RW, Mix_LoadWAV_RW & the like.
+*
+* Pack layout (integers are little-endian u32):
+*   magic ("SRPK"), version, entry count, CRC-32 of index
+*   index - one entry per asset, sorted by name:
+*       name (null-padded to ASSET_PACK_NAME_SZ), offset, size
+*   asset data, at the offsets given in the index
+*
+* Packs are built by AssetPack_build(...) (see tools/pack_assets.c), and may
+* be linked into the executable itself (see tools/embed_assets.S).
+*/
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+
+#define ASSET_PACK_MAGIC "SRPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_HEADER_SZ 16
+
+// Appended to an asset folder's path to give the path of its pack
+#define ASSET_PACK_EXT ".pack"
+
+// Bytes per index entry, and of the name within it (including terminator)
+#define ASSET_PACK_ENTRY_SZ 64
+#define ASSET_PACK_NAME_SZ (ASSET_PACK_ENTRY_SZ - 8)
+
+
+typedef struct {
+    const unsigned char *data;  // Whole pack, header & all
+    size_t size;                // Bytes of data
+    Uint32 count;               // Number of assets
+    bool mapped;                // Whether data is a memory map to release
+    bool owned;                 // Whether data is a heap copy to free
+} AssetPack;
+
+
+// Open & map the pack at path. The pack stays mapped until deconstructed
+AssetPack* AssetPack_initFromFile(const char *path);
+
+// Use a pack already in memory, which must outlive the AssetPack
+AssetPack* AssetPack_initFromMemory(const void *data, size_t size);
+
+#ifdef SIRTET_EMBED_ASSETS
+// Use the pack linked into the executable. Touches no files
+AssetPack* AssetPack_initEmbedded();
+#endif
+
+// Release the pack. Anything found in it (including open RWops) is invalid
+// from here on
+void AssetPack_deconstruct(AssetPack *self);
+
+// Locate an asset by name (e.g. "fonts/VT323.ttf"), returning its data and
+// storing its size in out_size. Returns NULL if no such asset
+const void* AssetPack_find(AssetPack *self, const char *name, size_t *out_size);
+
+// Open a read-only SDL_RWops over an asset's data, or NULL if no such asset
+SDL_RWops* AssetPack_openRW(AssetPack *self, const char *name);
+
+// Open an asset from the pack or, if self is NULL, from its file under folder.
+// Returns NULL (with error set) if it can't be opened
+SDL_RWops* AssetPack_openAsset(
+    AssetPack *self, const char *folder, const char *name);
+
+/**
+ * @brief Write a pack of the given asset files to out_path
+ * @param out_path - Path of pack file to write
+ * @param root - Folder asset names are relative to
+ * @param names - Names of assets to pack, relative to root. Names longer
+ *                than ASSET_PACK_NAME_SZ - 1 characters are refused
+ * @param n - Number of names
+ * @return 0 on success, -1 on error
+ */
+int AssetPack_build(
+    const char *out_path, const char *root, const char *const *names, size_t n);
+
+#endif
@@ -4,175 +4,189 @@
 #include <stdio.h>
 
 #include "sirtet.h"
+#include "utilities.h"
 #include "backgrounds.h"
 
-PanningBg *PanningBg_init(
-    float xvel, float yvel,
-    SDL_Texture *topleft, SDL_Texture *topright,
-    SDL_Texture *bottomleft, SDL_Texture *bottomright
-) {
 
+// Wrap value into [0, period) without a loop (or libm's fmodf)
+static float wrapf(float value, int period) {
+    value -= (float)period * (int)(value / (float)period);
+    if (value < 0) {
+        value += (float)period;
+    }
+    return value;
+}
 
-    PanningBg *retval = calloc(1, sizeof(PanningBg));
+// Wrap value into [0, period)
+static int wrapi(int value, int period) {
+    value %= period;
+    return value < 0 ? value + period : value;
+}
 
 
-    retval->xvel = xvel;
-    retval->yvel = yvel;
+PanningBg *PanningBg_init(float xvel, float yvel, SDL_Texture *texture) {
 
-    retval->xpos = 0;
-    retval->ypos = 0;
+    PanningBg *retval = calloc(1, sizeof(PanningBg));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for PanningBg\n");
+        return NULL;
+    }
+
+    if (PanningBg_build(retval, xvel, yvel, texture) != 0) {
+        free(retval);
+        return NULL;
+    }
 
     return retval;
 }
 
 
+int PanningBg_build(
+    PanningBg *self, float xvel, float yvel, SDL_Texture *texture) {
 
-int PanningBg_deconstruct(PanningBg *self) {
-    free(self);
-    return 0;
-}
+    *self = (PanningBg){
+        .xvel = xvel,
+        .yvel = yvel,
+        .xpos = 0,
+        .ypos = 0,
+        .texture = texture,
+        .tex_w = 0,
+        .tex_h = 0
+    };
 
-int PanningBg_move(PanningBg *self, SDL_Rect *containing_window) {
+    // Size is cached once, rather than queried every frame
+    if (SDL_QueryTexture(texture, NULL, NULL, &self->tex_w, &self->tex_h) != 0
+        || self->tex_w <= 0 || self->tex_h <= 0) {
 
+        char errbuff[STATIC_ARRMAX];
+        snprintf(
+            errbuff, STATIC_ARRMAX,
+            "Error building PanningBg: %s\n", SDL_GetError()
+        );
+        Sirtet_setError(errbuff);
+        return -1;
+    }
 
-    float left_extrm = (float)containing_window->x;
-    float right_extrm = left_extrm + (float)containing_window->w;
+    return 0;
+}
 
-    float top_extrm = (float)containing_window->y;
-    float bottom_extrm = top_extrm + (float)containing_window->h;
 
-    self->xpos += self->xvel;
-    self->ypos += self->yvel;
 
-    int loopn = 0;
+int PanningBg_deconstruct(PanningBg *self) {
+    free(self);
+    return 0;
+}
 
-    SDL_Texture *swaptx;
+int PanningBg_move(PanningBg *self) {
 
-    if (self->xpos > right_extrm) {
+    self->xpos = wrapf(self->xpos + self->xvel, self->tex_w);
+    self->ypos = wrapf(self->ypos + self->yvel, self->tex_h);
 
-        while (self->xpos > right_extrm && loopn++ < 1000000) {
-            self->xpos -= (right_extrm - left_extrm);
-        }
+    return 0;
+}
 
-        swaptx = self->topleft;
-        self->topleft = self->topright;
-        self->topright = swaptx;
+int PanningBg_draw(
+    PanningBg *self, SDL_Renderer *rend, SDL_Rect *containing_window) {
 
-        swaptx = self->bottomleft;
-        self->bottomleft = self->bottomright;
-        self->bottomright = swaptx;
+    if (self->texture == NULL) {
+        Sirtet_setError("Error drawing PanningBg: no texture\n");
+        return -1;
     }
 
-    if (self->xpos < left_extrm) {
-        while (self->xpos < left_extrm && loopn++ < 1000000) {
-            self->xpos += (right_extrm - left_extrm);
-        }
-
-        swaptx = self->topleft;
-        self->topleft = self->topright;
-        self->topright = swaptx;
+    const int tex_w = self->tex_w;
+    const int tex_h = self->tex_h;
 
-        swaptx = self->bottomleft;
-        self->bottomleft = self->bottomright;
-        self->bottomright = swaptx;
+    // Texture coordinates sampled at the window's top left. Tile is
+    // centered on the window's origin when offset is 0
+    const int u0 = wrapi(tex_w / 2 - (int)self->xpos, tex_w);
+    const int v0 = wrapi(tex_h / 2 - (int)self->ypos, tex_h);
 
-    }
+    // At most 2x2 copies, when window is no larger than texture
+    int dst_y = containing_window->y;
+    int v = v0;
+    while (dst_y < containing_window->y + containing_window->h) {
 
-    if (self->ypos > bottom_extrm) {
-        while (self->ypos > bottom_extrm && loopn++ < 1000000) {
-            self->ypos -= (bottom_extrm - top_extrm);
-        }
+        int span_h = MIN2(
+            tex_h - v, containing_window->y + containing_window->h - dst_y);
 
-        swaptx = self->topleft;
-        self->topleft = self->bottomleft;
-        self->bottomleft = swaptx;
+        int dst_x = containing_window->x;
+        int u = u0;
+        while (dst_x < containing_window->x + containing_window->w) {
 
+            int span_w = MIN2(
+                tex_w - u, containing_window->x + containing_window->w - dst_x);
 
-        swaptx = self->topright;
-        self->topright = self->bottomright;
-        self->bottomright = swaptx;
-    }
+            SDL_Rect src = {.x=u, .y=v, .w=span_w, .h=span_h};
+            SDL_Rect dst = {.x=dst_x, .y=dst_y, .w=span_w, .h=span_h};
+            SDL_RenderCopy(rend, self->texture, &src, &dst);
 
-    if (self->ypos < top_extrm) {
-        while (self->ypos < top_extrm && loopn++ < 1000000) {
-            self->ypos += (bottom_extrm - top_extrm);
+            dst_x += span_w;
+            u = 0;
         }
 
-        swaptx = self->topleft;
-        self->topleft = self->bottomleft;
-        self->bottomleft = swaptx;
-
-
-        swaptx = self->topright;
-        self->topright = self->bottomright;
-        self->bottomright = swaptx;
+        dst_y += span_h;
+        v = 0;
     }
 
+    if (DEBUG_ENABLED) {
 
-    assert(loopn < 1000000);
-
+        int orig_x = containing_window->x + (int)self->xpos;
+        int orig_y = containing_window->y + (int)self->ypos;
+        SDL_Rect dbg_rect = {.x=orig_x - 2, .y=orig_y - 2, .w = 4, .h = 4};
+        SDL_SetRenderDrawColor(rend, 255, 0, 0, 255);
+        SDL_RenderDrawRect(rend, &dbg_rect);
+    }
 
     return 0;
 }
 
-int PanningBg_draw(
-    PanningBg *self, SDL_Renderer *rend, SDL_Rect *containing_window) {
 
-    float left_extrm = (float)containing_window->x;
-    float right_extrm = left_extrm + (float)containing_window->w;
+SDL_Surface* PanningBg_composeQuadrants(
+    SDL_Surface *topleft, SDL_Surface *topright,
+    SDL_Surface *bottomleft, SDL_Surface *bottomright
+) {
 
-    float top_extrm = (float)containing_window->y;
-    float bottom_extrm = top_extrm + (float)containing_window->h;
+    const int w = topleft->w;
+    const int h = topleft->h;
 
-    if (
-        self->xpos < left_extrm ||
-        self->xpos > right_extrm ||
-        self->ypos < top_extrm || 
-        self->ypos > bottom_extrm ) {
+    SDL_Surface *quadrants[4] = {topleft, topright, bottomleft, bottomright};
+    for (int i = 0; i < 4; i++) {
+        if (quadrants[i]->w != w || quadrants[i]->h != h) {
+            Sirtet_setError(
+                "Error composing background: quadrant sizes differ\n");
+            return NULL;
+        }
+    }
 
+    SDL_Surface *composite = SDL_CreateRGBSurfaceWithFormat(
+        0, 2 * w, 2 * h, 32, SDL_PIXELFORMAT_RGBA32
+    );
+    if (composite == NULL) {
         char errbuff[STATIC_ARRMAX];
         snprintf(
             errbuff, STATIC_ARRMAX,
-            "Error drawing PanningBg: (%f, %f) out of bounds",
-            self->xpos, self->ypos
+            "Error composing background: %s\n", SDL_GetError()
         );
         Sirtet_setError(errbuff);
-        return -1;
+        return NULL;
     }
 
-
-    int orig_x = (int)self->xpos;
-    int orig_y = (int)self->ypos;
-
-    if (DEBUG_ENABLED) {
-
-        SDL_Rect dbg_rect = {.x=orig_x - 2, .y=orig_y - 2, .w = 4, .h = 4};
-        // SDL_RenderDrawRect(SDL_Renderer *renderer, const SDL_Rect *rect)
-        // SDL_SetRenderDrawColor(SDL_Renderer *renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
-        SDL_SetRenderDrawColor(rend, 255, 0, 0, 255);
-        SDL_RenderDrawRect(rend, &dbg_rect);
+    for (int i = 0; i < 4; i++) {
+        SDL_Rect dst = {.x=(i % 2) * w, .y=(i / 2) * h, .w=w, .h=h};
+
+        // straight copy - quadrants are opaque
+        SDL_SetSurfaceBlendMode(quadrants[i], SDL_BLENDMODE_NONE);
+        if (SDL_BlitSurface(quadrants[i], NULL, composite, &dst) != 0) {
+            char errbuff[STATIC_ARRMAX];
+            snprintf(
+                errbuff, STATIC_ARRMAX,
+                "Error composing background: %s\n", SDL_GetError()
+            );
+            Sirtet_setError(errbuff);
+            SDL_FreeSurface(composite);
+            return NULL;
+        }
     }
 
-
-
-    int w, h;
-
-    SDL_QueryTexture(self->topleft, NULL, NULL, &w, &h);
-    SDL_Rect tl_dst = {.x=orig_x - w, .y=orig_y - h, .w = w, .h = h};
-
-    SDL_QueryTexture(self->topright, NULL, NULL, &w, &h);
-    SDL_Rect tr_dst = {.x=orig_x, .y=orig_y - h, .w = w, .h = h};
-
-    SDL_QueryTexture(self->bottomleft, NULL, NULL, &w, &h);
-    SDL_Rect bl_dst = {.x=orig_x - w, .y=orig_y, .w = w, .h = h};
-
-    SDL_QueryTexture(self->bottomright, NULL, NULL, &w, &h);
-    SDL_Rect br_dst = {.x=orig_x, .y=orig_y, .w = w, .h = h};
-
-    SDL_RenderCopy(rend, self->topleft, NULL, &tl_dst);
-    SDL_RenderCopy(rend, self->topright, NULL, &tr_dst);
-    SDL_RenderCopy(rend, self->bottomleft, NULL, &bl_dst);
-    SDL_RenderCopy(rend, self->bottomright, NULL, &br_dst);
-
-    return 0;
+    return composite;
 }
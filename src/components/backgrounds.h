@@ -11,44 +11,54 @@
 
 #include <SDL2/SDL.h>
 
-// A struct to represent a slowly panning background
+// A struct to represent a slowly panning background.
+// The texture is treated as one tile of an infinitely repeating plane
 typedef struct {
 
     float xvel;
     float yvel;
 
+    // Offset of the tiled plane, kept within [0, tex_w) and [0, tex_h)
     float xpos;
     float ypos;
 
-
-    SDL_Texture *topleft;
-    SDL_Texture *topright;
-    SDL_Texture *bottomleft;
-    SDL_Texture *bottomright;
-
+    SDL_Texture *texture;
+    int tex_w;
+    int tex_h;
 
 } PanningBg;
 
 
 // Initialize a PanningBg struct and return a pointer to it 
-PanningBg *PanningBg_init(
-    float xvel, float yvel,
-    SDL_Texture *topleft, SDL_Texture *topright,
-    SDL_Texture *bottomleft, SDL_Texture *bottomright
-);
+PanningBg *PanningBg_init(float xvel, float yvel, SDL_Texture *texture);
+
+// Build a PanningBg in place (e.g. when embedded in another struct)
+int PanningBg_build(
+    PanningBg *self, float xvel, float yvel, SDL_Texture *texture);
 
 
 // Free memory allocated for a PanningBg struct through PanningBg_init
 int PanningBg_deconstruct(PanningBg *self);
 
 
-// Move center focus point of background by configured velocity
-int PanningBg_move(PanningBg *self, SDL_Rect *containing_window);
+// Move background by configured velocity, wrapping around its tile size
+int PanningBg_move(PanningBg *self);
 
-// Draw the PanningBg at its current position
+// Draw the PanningBg at its current position, filling containing_window
 int PanningBg_draw(
     PanningBg *self, SDL_Renderer *rend, SDL_Rect *containing_window);
 
 
+/**
+ * @brief Compose four equally sized quadrant images into a single surface
+ *        twice as wide and tall, to be used as a PanningBg tile.
+ * @return Newly allocated SDL_Surface, or NULL on error
+ */
+SDL_Surface* PanningBg_composeQuadrants(
+    SDL_Surface *topleft, SDL_Surface *topright,
+    SDL_Surface *bottomleft, SDL_Surface *bottomright
+);
+
+
 
 #endif
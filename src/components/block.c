@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <string.h>
 
 #include "block.h"
 #include "sirtet.h"
@@ -43,27 +44,62 @@
 ******************************************************************************/
 BlockDb* BlockDb_init(int size) {
 
-    BlockDb *retval = (BlockDb*)malloc(sizeof(BlockDb));
+    size_t nbytes = BlockDb_requiredBytes(size);
+    void *mem = malloc(nbytes);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for BlockDb\n");
+        return NULL;
+    }
+    return BlockDb_build(mem, nbytes, size);
+}
+
+
+size_t BlockDb_requiredBytes(int size) {
+    return (
+        sizeof(BlockDb)
+        + size * sizeof(long)
+        + size * sizeof(Point)
+        + size * sizeof(int) * 2
+        + size * sizeof(SDL_Color)
+    );
+}
+
+
+BlockDb* BlockDb_build(void *data, size_t data_size, int size) {
+
+    if (
+        data == NULL || size < 0
+        || data_size < BlockDb_requiredBytes(size)
+    ) {
+        return NULL;
+    }
+
+    // memory structure (widest alignment first):
+    // [] BlockDb struct
+    // [] contents
+    // [] positions
+    // [] ids
+    // [] sizes
+    // [] colors
+    char *mem = (char*)data;
+    BlockDb *retval = (BlockDb*)mem;
+    mem += sizeof(BlockDb);
 
     *retval = (BlockDb){
         .max_ids=size,
         .head=0,
-        .ids=(int*)calloc(size, sizeof(int)),
-        .sizes=(int*)malloc(size * sizeof(int)),
-        .contents=(long*)malloc(size * sizeof(long)),
-        .positions=(Point*)malloc(size * sizeof(Point)),
-        .colors=(SDL_Color*)malloc(size * sizeof(SDL_Color))
+        .contents=(long*)mem,
+        .positions=(Point*)(mem + size * sizeof(long)),
+        .ids=(int*)(mem + size * (sizeof(long) + sizeof(Point))),
+        .sizes=(int*)(mem + size * (sizeof(long) + sizeof(Point) + sizeof(int))),
+        .colors=(SDL_Color*)(
+            mem + size * (sizeof(long) + sizeof(Point) + 2 * sizeof(int)))
     };
+    memset(retval->ids, 0, size * sizeof(int));
     return retval;
 }
 
 int BlockDb_deconstruct(BlockDb *self) {
-
-    free(self->ids);
-    free(self->sizes);
-    free(self->contents);
-    free(self->positions);
-    free(self->colors);
     free(self);
     return 0;
 }
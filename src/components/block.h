@@ -43,6 +43,13 @@ BlockDb* BlockDb_init(int size);
 // Deconstruct a BlockDb and free its allocated memory
 int BlockDb_deconstruct(BlockDb *self);
 
+// Number of bytes needed to build a BlockDb of the given size
+size_t BlockDb_requiredBytes(int size);
+
+// Build a BlockDb of the given size within a provided block of memory, of at
+// least BlockDb_requiredBytes(size) bytes. Returns NULL if it doesn't fit
+BlockDb* BlockDb_build(void *data, size_t data_size, int size);
+
 /******************************************************************************
 ******************************************************************************/
 
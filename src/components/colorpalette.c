@@ -7,6 +7,34 @@
 
 ColorPalette* ColorPalette_init(
     const char *name, size_t size, SDL_Color *src) {
+
+    size_t nbytes = ColorPalette_requiredBytes(name, size);
+
+    void *mem = malloc(nbytes);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for ColorPalette\n");
+        return NULL;
+    }
+    return ColorPalette_build(mem, nbytes, name, size, src);
+}
+
+size_t ColorPalette_requiredBytes(const char *name, size_t size) {
+
+    size_t nbytes = 0;
+
+    // use the struct size itself in case of padding
+    nbytes += sizeof(ColorPalette);
+    // Array values packed at end of same memory block
+    nbytes += (strlen(name) + 1) * sizeof(char); 
+    nbytes += sizeof(SDL_Color) * size;
+
+    return nbytes;
+}
+
+ColorPalette* ColorPalette_build(
+    void *data, size_t data_size,
+    const char *name, size_t size, SDL_Color *src
+) {
     // memory structure:
     // [] size
     // [] name (prt)
@@ -18,24 +46,18 @@ ColorPalette* ColorPalette_init(
     // []
     // ...
     // []
-    
-    size_t nbytes = 0;
-    size_t namelen = strlen(name);
 
-    // use the struct size itself in case of padding
-    nbytes += sizeof(ColorPalette);
-    // Array values packed at end of same memory block
-    nbytes += (strlen(name) + 1) * sizeof(char); 
-    nbytes += sizeof(SDL_Color) * size;
+    size_t nbytes = ColorPalette_requiredBytes(name, size);
+    if (data == NULL || data_size < nbytes) {
+        Sirtet_setError("Insufficient memory to build ColorPalette\n");
+        return NULL;
+    }
 
+    size_t namelen = strlen(name);
     size_t name_offset = sizeof(ColorPalette);
     size_t colors_offset = name_offset + (sizeof(char) * (namelen + 1));
 
-    void *mem = malloc(nbytes);
-    if (mem == NULL) {
-        Sirtet_setError("Error allocating memory for ColorPalette\n");
-        return NULL;
-    }
+    void *mem = data;
     memset(mem, '\0', nbytes);
 
     ColorPalette *retval = (ColorPalette*)mem;
@@ -35,6 +35,16 @@ ColorPalette* ColorPalette_initCopy(ColorPalette *src);
 // Free color palette
 void ColorPalette_deconstruct(ColorPalette *self);
 
+// Number of bytes needed to build a ColorPalette
+size_t ColorPalette_requiredBytes(const char *name, size_t size);
+
+// Build a ColorPalette within a provided block of memory, of at least
+// ColorPalette_requiredBytes(...) bytes. Returns NULL if it doesn't fit
+ColorPalette* ColorPalette_build(
+    void *data, size_t data_size,
+    const char *name, size_t size, SDL_Color *src
+);
+
 
 int ColorPalette_getColor(ColorPalette *self, size_t idx, SDL_Color *outcol);
 SDL_Color* ColorPalette_getColorPtr(ColorPalette *self, size_t idx);
@@ -1,6 +1,7 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "sirtet.h"
 #include "grid.h"
@@ -13,42 +14,64 @@
 
 GameGrid *GameGrid_init(int width, int height) {
 
-    GameGrid *retval = (GameGrid*)malloc(sizeof(GameGrid));
-    if (retval == NULL) {
+    size_t nbytes = GameGrid_requiredBytes(width, height);
+    void *mem = malloc(nbytes);
+    if (mem == NULL) {
         return NULL;
     }
-    retval->width = width;
-    retval->height = height;
+    return GameGrid_build(mem, nbytes, width, height);
+} 
 
-    retval->framerate = DEFAULT_GRID_FRAMERATE;
-    retval->cooldown = 0;   
-    retval->is_animating = false;
+int GameGrid_deconstruct(GameGrid *self) {
+    free(self);
+    return 0;
+}
 
+size_t GameGrid_requiredBytes(int width, int height) {
+    return (
+        sizeof(GameGrid)
+        + (width * height + 2 * height) * sizeof(int)
+        + height * sizeof(bool)
+    );
+}
 
-    retval->contents = (int*)malloc(width * height * sizeof(int));
-    retval->to_remove = (int*)calloc(height, sizeof(int));
-    retval->removed = (int*)calloc(height, sizeof(int));
+GameGrid *GameGrid_build(void *data, size_t data_size, int width, int height) {
 
     if (
-        retval->contents == NULL
-        || retval->to_remove == NULL
-        || retval->removed == NULL
+        data == NULL || width < 0 || height < 0
+        || data_size < GameGrid_requiredBytes(width, height)
     ) {
-        GameGrid_deconstruct(retval);
         return NULL;
     }
 
-    GameGrid_clear(retval);
-    return retval;
-} 
+    // memory structure:
+    // [] GameGrid struct
+    // [] contents
+    // [] to_remove
+    // [] removed
+    // [] dirty_rows
+    GameGrid *retval = (GameGrid*)data;
+    int *ints = (int*)((char*)data + sizeof(GameGrid));
 
-int GameGrid_deconstruct(GameGrid *self) {
+    retval->width = width;
+    retval->height = height;
 
-    free(self->contents);
-    free(self->to_remove);
-    free(self->removed);
-    free(self);
-    return 0;
+    retval->framerate = DEFAULT_GRID_FRAMERATE;
+    retval->cooldown = 0;   
+    retval->is_animating = false;
+    retval->any_dirty = false;
+
+    retval->contents = ints;
+    retval->to_remove = ints + width * height;
+    retval->removed = ints + width * height + height;
+    retval->dirty_rows = (bool*)(ints + width * height + 2 * height);
+
+    memset(retval->to_remove, 0, height * sizeof(int));
+    memset(retval->removed, 0, height * sizeof(int));
+    memset(retval->dirty_rows, 0, height * sizeof(bool));
+
+    GameGrid_clear(retval);
+    return retval;
 }
 
 /******************************************************************************
@@ -147,6 +170,7 @@ int GameGrid_commitBlock(GameGrid *self, BlockDb *db, int block_id) {
         // 2d access
         int grid_idx = grid_coords.x + (self->width * grid_coords.y);
         self->contents[grid_idx] = block_id;
+        GameGrid_markRowDirty(self, grid_coords.y);
     }
 
     BlockDb_setBlockContents(db, block_id, 0L);
@@ -159,6 +183,7 @@ int GameGrid_clear(GameGrid* grid) {
          grid->contents[idx] = INVALID_BLOCK_ID;
     };
 
+    GameGrid_markAllDirty(grid);
     return 0;
 }  
 
@@ -176,6 +201,7 @@ int GameGrid_reset(GameGrid* grid, BlockDb *db) {
         grid->contents[grid_idx] = INVALID_BLOCK_ID;
     }
 
+    GameGrid_markAllDirty(grid);
     return 0;
 }  
 
@@ -228,6 +254,11 @@ int GameGrid_resolveRowsDown(GameGrid *self, BlockDb *db) {
             }
         }
 
+        // rows are only actually moved once a full one has been skipped
+        if (num_full_rows > 0) {
+            GameGrid_markRowDirty(self, write_ptr);
+        }
+
         // both read and writes move
         if (read_ptr >= 0) {
             read_ptr--;
@@ -285,6 +316,11 @@ int GameGrid_resolveRowsUp(GameGrid *self, BlockDb *db) {
             }
         }
 
+        // rows are only actually moved once a full one has been skipped
+        if (num_full_rows > 0) {
+            GameGrid_markRowDirty(self, write_ptr);
+        }
+
         // both read and writes move
         if (read_ptr < self->height) {
             read_ptr++;
@@ -438,6 +474,9 @@ int GameGrid_runAnimationFrame(GameGrid *self) {
     for (int x = 0; x < self->height; x++) {
 
         if (self->removed[x] == self->to_remove[x]) {
+            if (self->removed[x] != 0) {
+                GameGrid_markRowDirty(self, x);
+            }
             self->removed[x] = 0;
             self->to_remove[x] = 0;
             continue;
@@ -445,6 +484,7 @@ int GameGrid_runAnimationFrame(GameGrid *self) {
 
         animation_complete = false;
         self->removed[x]++;
+        GameGrid_markRowDirty(self, x);
     }
 
     if (animation_complete) {
@@ -457,3 +497,43 @@ int GameGrid_runAnimationFrame(GameGrid *self) {
     return 0;
 }
 
+
+/******************************************************************************
+ * Presentation invalidation
+******************************************************************************/
+
+// Flag a row as needing redrawn
+void GameGrid_markRowDirty(GameGrid *self, int row) {
+    if (row < 0 || row >= self->height) {
+        return;
+    }
+    self->dirty_rows[row] = true;
+    self->any_dirty = true;
+}
+
+// Flag every row as needing redrawn
+void GameGrid_markAllDirty(GameGrid *self) {
+    for (int row = 0; row < self->height; row++) {
+        self->dirty_rows[row] = true;
+    }
+    self->any_dirty = true;
+}
+
+// Identify if a row has changed since dirty flags were last cleared
+bool GameGrid_isRowDirty(GameGrid *self, int row) {
+    if (row < 0 || row >= self->height) {
+        return false;
+    }
+    return self->dirty_rows[row];
+}
+
+// Clear all dirty flags, once a presentation of the grid is up to date
+void GameGrid_clearDirty(GameGrid *self) {
+    if (!self->any_dirty) {
+        return;
+    }
+    for (int row = 0; row < self->height; row++) {
+        self->dirty_rows[row] = false;
+    }
+    self->any_dirty = false;
+}
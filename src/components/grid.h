@@ -35,12 +35,24 @@ typedef struct {
                         // of cells needing removed
     int *removed;       // Array (corresponding to row indices) of number of cells removed
 
+    /* Presentation invalidation */
+    bool any_dirty;     // Flag to indicate at least one row is dirty
+    bool *dirty_rows;   // Array (corresponding to row indices) of flags marking
+                        // rows whose displayed cells changed since last cleared
+
 } GameGrid;
 
 
 GameGrid *GameGrid_init(int width, int height);
 int GameGrid_deconstruct(GameGrid *self);
 
+// Number of bytes needed to build a GameGrid of the given dimensions
+size_t GameGrid_requiredBytes(int width, int height);
+
+// Build a GameGrid within a provided block of memory, of at least
+// GameGrid_requiredBytes(...) bytes. Returns NULL if it doesn't fit
+GameGrid *GameGrid_build(void *data, size_t data_size, int width, int height);
+
 /******************************************************************************
  * Content management
 ******************************************************************************/
@@ -96,4 +108,16 @@ int GameGrid_prepareAnimationAllRows(GameGrid *self, int framerate);
 // Run one frame of the GameGrid animation
 int GameGrid_runAnimationFrame(GameGrid *self);
 
+// Flag a row as needing redrawn
+void GameGrid_markRowDirty(GameGrid *self, int row);
+
+// Flag every row as needing redrawn
+void GameGrid_markAllDirty(GameGrid *self);
+
+// Identify if a row has changed since dirty flags were last cleared
+bool GameGrid_isRowDirty(GameGrid *self, int row);
+
+// Clear all dirty flags, once a presentation of the grid is up to date
+void GameGrid_clearDirty(GameGrid *self);
+
 #endif
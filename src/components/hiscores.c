@@ -1,8 +1,19 @@
 #include <SDL2/SDL_render.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif _WIN32
+#include <windows.h>
+#include <io.h>
+#endif
+
 #include "hiscores.h"
 #include "utilities.h"
 #include "sirtet.h"  // May be removed if used later as a general-purpose tool
@@ -47,10 +58,14 @@ ScoreList* ScoreList_init(size_t size, size_t namelen) {
 
 
 void ScoreList_deconstruct(ScoreList *self) {
+    if (self == NULL) {
+        return;
+    }
     free(self->names);
     free(self->scores);
     free(self->strbuff);
     free(self->intbuff);
+    free(self);
 }
 
 
@@ -80,6 +95,59 @@ int ScoreList_add(ScoreList *self, char *name, int score) {
     return 0;
 }
 
+int ScoreList_rankOf(ScoreList *self, int score) {
+
+    // First entry scoring strictly less - scores are descending
+    size_t lo = 0;
+    size_t hi = self->len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (self->scores[mid] >= score) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return (int)(lo < self->size ? lo : self->size);
+}
+
+
+int ScoreList_insert(ScoreList *self, const char *name, int score) {
+
+    size_t namelen = self->namelen;
+    size_t inputlen = strlen(name);
+    if (inputlen > namelen) {
+        Sirtet_setError("Name too long to insert into ScoreList\n");
+        return -1;
+    }
+
+    size_t rank = (size_t)ScoreList_rankOf(self, score);
+    if (rank >= self->size) {
+        return -1;
+    }
+
+    // Shift lower entries down one, dropping the last if already full
+    size_t name_sz = namelen + 1;
+    size_t kept = self->len < self->size ? self->len : self->size - 1;
+    size_t n_moved = kept - rank;
+
+    memmove(
+        self->scores + rank + 1, self->scores + rank, n_moved * sizeof(int));
+    memmove(
+        self->names + (rank + 1) * name_sz, self->names + rank * name_sz,
+        n_moved * name_sz * sizeof(char)
+    );
+
+    self->scores[rank] = score;
+    char *nameptr = self->names + rank * name_sz;
+    memset(nameptr, 0, name_sz * sizeof(char));
+    memcpy(nameptr, name, inputlen * sizeof(char));
+
+    self->len = kept + 1;
+    return (int)rank;
+}
+
 // Remove the final element of the scorelist, returning a status code
 int ScoreList_pop(ScoreList *self, char *out_name, int *out_score) {
 
@@ -131,12 +199,175 @@ int ScoreList_sort(ScoreList *self) {
 
 
 
-enum HsParseState {
-    AwaitingName,
-    ParsingName,
-    AwaitingNum,
-    ParsingNum
-};
+int ScoreList_copy(ScoreList *dst, const ScoreList *src) {
+
+    if (dst->namelen != src->namelen || dst->size < src->len) {
+        Sirtet_setError("ScoreList_copy passed mismatched ScoreLists\n");
+        return -1;
+    }
+
+    memcpy(dst->scores, src->scores, src->len * sizeof(int));
+    memcpy(
+        dst->names, src->names,
+        src->len * (src->namelen + 1) * sizeof(char)
+    );
+    dst->len = src->len;
+    return 0;
+}
+
+
+// Read the rest of a stream into a null-terminated buffer, in as few reads as
+// the stream allows. Caller frees. Returns NULL on error
+static char* readStream(FILE *f, size_t *out_len) {
+
+    // Seekable files are read in one go. Streams that aren't (pipes) are
+    // read into a buffer grown as they go
+    size_t cap = 4096;
+    bool sized = false;
+    long start = ftell(f);
+    if (start >= 0 && fseek(f, 0, SEEK_END) == 0) {
+        long end = ftell(f);
+        if (end >= start && fseek(f, start, SEEK_SET) == 0) {
+            cap = (size_t)(end - start) + 1;
+            sized = true;
+        }
+    }
+
+    char *buff = (char*)malloc(cap);
+    size_t len = 0;
+    while (buff != NULL) {
+
+        // A short read means end of stream (or an error, checked below)
+        len += fread(buff + len, sizeof(char), cap - len - 1, f);
+        if (sized || len < cap - 1) {
+            break;
+        }
+
+        char *grown = (char*)realloc(buff, cap * 2);
+        if (grown == NULL) {
+            free(buff);
+        }
+        buff = grown;
+        cap *= 2;
+    }
+
+    if (buff == NULL) {
+        Sirtet_setError("Error allocating memory to read scores\n");
+        return NULL;
+    }
+    if (ferror(f)) {
+        Sirtet_setError("Error reading score file\n");
+        free(buff);
+        return NULL;
+    }
+
+    buff[len] = '\0';
+    *out_len = len;
+    return buff;
+}
+
+
+static inline bool isSpace(char chr) {
+    return chr == ' ' || chr == '\t' || chr == '\r' || chr == '\n';
+}
+
+
+// Upper bound on the number of rows in text, for sizing a list to read it
+static size_t countRows(const char *text, size_t len) {
+
+    size_t rows = 0;
+    const char *cur = text;
+    const char *end = text + len;
+    while ((cur = memchr(cur, '\n', end - cur)) != NULL) {
+        rows++;
+        cur++;
+    }
+    // Last row needn't end in a newline
+    return rows + 1;
+}
+
+
+/**
+ * @brief Parse "NAME SCORE" rows of text straight into the list's storage,
+ *        past its current entries. Entries only count as added once all of
+ *        text has parsed, so on error the list is left as it was
+ * @param text - Null-terminated text to parse
+ */
+static int ScoreList_parseText(ScoreList *self, const char *text) {
+
+    size_t name_sz = self->namelen + 1;
+    size_t idx = self->len;
+    const char *cur = text;
+
+    while (true) {
+
+        while (isSpace(*cur)) {
+            cur++;
+        }
+        if (*cur == '\0') {
+            break;
+        }
+
+        if (idx == self->size) {
+            Sirtet_setError("Error parsing score file: Too many entries\n");
+            return -1;
+        }
+
+        char *name = self->names + idx * name_sz;
+        memset(name, 0, name_sz * sizeof(char));
+        int parsed = parseName(cur, name, self->namelen);
+        if (parsed < 0) {
+            Sirtet_setError("Error parsing score file: Name too long\n");
+            return -1;
+        }
+        cur += parsed;
+
+        while (isSpace(*cur)) {
+            cur++;
+        }
+        // parseInt cast is safe - it only reads
+        parsed = parseInt((char*)cur, &self->scores[idx]);
+        if (parsed < 0) {
+            return -1;
+        }
+        cur += parsed;
+
+        if (*cur != '\0' && !isSpace(*cur)) {
+            Sirtet_setError("Error parsing score file: Malformed score\n");
+            return -1;
+        }
+        idx++;
+    }
+
+    self->len = idx;
+    return 0;
+}
+
+
+ScoreList* ScoreList_initFromFile(FILE *f, size_t size, size_t namelen) {
+
+    if (f == NULL) {
+        Sirtet_setError("ScoreList_initFromFile passed a NULL file pointer\n");
+        return NULL;
+    }
+
+    size_t len;
+    char *text = readStream(f, &len);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    size_t rows = countRows(text, len);
+    ScoreList *retval = ScoreList_init(rows > size ? rows : size, namelen);
+    if (retval != NULL && ScoreList_parseText(retval, text) != 0) {
+        ScoreList_deconstruct(retval);
+        retval = NULL;
+    }
+
+    free(text);
+    return retval;
+}
+
 
 // Read rows from a highscores file into provided ScoreList
 int ScoreList_readFile(ScoreList *self, FILE *f) {
@@ -151,89 +382,15 @@ int ScoreList_readFile(ScoreList *self, FILE *f) {
         return -1;
     }
 
-    char *newname = self->strbuff;
-    int score;
-    bool neg;
-    int nameidx = 0;
-    char chr;
-    enum HsParseState curstate = AwaitingName;
-
-    do {
-        chr = fgetc(f);
-
-        switch (curstate) {
-            case AwaitingName:
-                if (chr != ' ' && chr != '\0' && chr != '\n' && chr != EOF) {
-                    nameidx = 0;
-                    newname[nameidx++] = chr;
-                    curstate = ParsingName;
-                }
-                break;
-
-            case ParsingName:
-                if (chr == ' ' || chr == '\0' || chr == '\n' || chr == EOF) {
-                    newname[nameidx] = '\0';
-                    curstate = AwaitingNum;
-                }
-                else {
-                    if (nameidx >= self->namelen) {
-                        Sirtet_setError(
-                            "Error parsing score file: Name too long\n"
-                        );
-                        return -1;
-                    }
-                    newname[nameidx++] = chr;
-                }
-                break;
-
-            case AwaitingNum:
-                if (chr == '-') {
-                    neg = true;
-                    score = 0;
-                    curstate = ParsingNum;
-                }
-                else if (chr >= '0' && chr <= '9') {
-                    neg = false;
-                    score = (chr - '0');
-                    curstate = ParsingNum;
-                }
-                break;
-
-            case ParsingNum:
-                if (chr >= '0' && chr <= '9') {
-                    int digit = chr - '0';
-                    if (neg) {
-                        if (score < ((INT_MIN + digit) / 10)) {
-                            Sirtet_setError(
-                                "Error parsing score file: "
-                                "Parsed score below MIN_INT value\n"
-                            );
-                            return -1;
-                        }
-                        score = (score * 10) - (chr - '0');
-                    }
-                    else {
-                        if (score > ((INT_MAX - digit) / 10)) {
-                            Sirtet_setError(
-                                "Error parsing score file: "
-                                "Parsed score exceeds INT_MAX\n"
-                            );
-                            return -1;
-                        }
-                        score = (score * 10) + (chr - '0');
-                    }
-                }
-                else {
-                    // end
-                    if (ScoreList_add(self, newname, score) != 0) {
-                        return -1;
-                    }
-                    curstate = AwaitingName;
-                }
-                break;
-        }
-    } while (chr != EOF);
-    return 0;
+    size_t len;
+    char *text = readStream(f, &len);
+    if (text == NULL) {
+        return -1;
+    }
+
+    int retval = ScoreList_parseText(self, text);
+    free(text);
+    return retval;
 }
 
 
@@ -264,6 +421,260 @@ int ScoreList_toFile(ScoreList *self, FILE *f) {
 
 
 
+/******************************************************************************
+ * ScoreList binary files
+******************************************************************************/
+
+
+static uint32_t readU32(const unsigned char *src) {
+    return (
+        (uint32_t)src[0]
+        | ((uint32_t)src[1] << 8)
+        | ((uint32_t)src[2] << 16)
+        | ((uint32_t)src[3] << 24)
+    );
+}
+
+
+static void writeU32(unsigned char *dst, uint32_t val) {
+    dst[0] = (unsigned char)(val & 0xFF);
+    dst[1] = (unsigned char)((val >> 8) & 0xFF);
+    dst[2] = (unsigned char)((val >> 16) & 0xFF);
+    dst[3] = (unsigned char)((val >> 24) & 0xFF);
+}
+
+
+int ScoreList_readBinaryData(ScoreList *self, const void *data, size_t size) {
+
+    if (self == NULL) {
+        Sirtet_setError("ScoreList_readBinaryData passed a NULL ScoreList\n");
+        return -1;
+    }
+
+    const unsigned char *bytes = (const unsigned char*)data;
+
+    if (
+        data == NULL
+        || size < HISCORES_HEADER_SZ
+        || memcmp(bytes, HISCORES_MAGIC, 4) != 0
+    ) {
+        Sirtet_setError("Error reading hiscores: Not a hiscores file\n");
+        return -1;
+    }
+
+    uint32_t version = readU32(bytes + 4);
+    uint32_t namelen = readU32(bytes + 8);
+    uint32_t count = readU32(bytes + 12);
+    uint32_t crc = readU32(bytes + 16);
+
+    if (version != HISCORES_VERSION) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ,
+            "Error reading hiscores: Unsupported version %u\n",
+            (unsigned int)version
+        );
+        Sirtet_setError(buff);
+        return -1;
+    }
+
+    // Checked against size before any multiplication can overflow
+    size_t record_sz = 4 + (size_t)namelen + 1;
+    if (
+        namelen >= size
+        || count > (size - HISCORES_HEADER_SZ) / record_sz
+        || HISCORES_HEADER_SZ + count * record_sz != size
+    ) {
+        Sirtet_setError("Error reading hiscores: File is truncated\n");
+        return -1;
+    }
+
+    const unsigned char *records = bytes + HISCORES_HEADER_SZ;
+    if (checksumCrc32(records, count * record_sz) != crc) {
+        Sirtet_setError("Error reading hiscores: Checksum mismatch\n");
+        return -1;
+    }
+
+    if (self->len + count > self->size) {
+        Sirtet_setError("Error reading hiscores: Too many entries\n");
+        return -1;
+    }
+
+    // Validate every name before adding any, so a bad file adds nothing
+    for (uint32_t i = 0; i < count; i++) {
+        const char *name = (const char*)(records + i * record_sz + 4);
+        size_t len = strnlen(name, namelen + 1);
+        if (len > namelen || len > self->namelen) {
+            Sirtet_setError("Error reading hiscores: Name too long\n");
+            return -1;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const unsigned char *record = records + i * record_sz;
+        ScoreList_add(
+            self, (char*)(record + 4), (int32_t)readU32(record)
+        );
+    }
+
+    return 0;
+}
+
+
+int ScoreList_readBinary(ScoreList *self, const char *path) {
+
+    char buff[ERRMSG_SZ];
+
+#ifdef __linux__
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        snprintf(buff, ERRMSG_SZ, "Could not open hiscores file %s\n", path);
+        Sirtet_setError(buff);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        Sirtet_setError("Error reading hiscores: Empty file\n");
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        snprintf(buff, ERRMSG_SZ, "Could not map hiscores file %s\n", path);
+        Sirtet_setError(buff);
+        return -1;
+    }
+
+    int retval = ScoreList_readBinaryData(self, data, size);
+    munmap(data, size);
+    return retval;
+
+#else
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        snprintf(buff, ERRMSG_SZ, "Could not open hiscores file %s\n", path);
+        Sirtet_setError(buff);
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    void *data = size > 0 ? malloc((size_t)size) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        free(data);
+        fclose(f);
+        Sirtet_setError("Error reading hiscores file\n");
+        return -1;
+    }
+    fclose(f);
+
+    int retval = ScoreList_readBinaryData(self, data, (size_t)size);
+    free(data);
+    return retval;
+
+#endif
+}
+
+
+// Flush f's contents through to disk, so a rename can't land before them
+static int flushToDisk(FILE *f) {
+    if (fflush(f) != 0) {
+        return -1;
+    }
+#ifdef __linux__
+    return fsync(fileno(f));
+#elif _WIN32
+    return _commit(_fileno(f));
+#else
+    return 0;
+#endif
+}
+
+
+int ScoreList_writeBinary(ScoreList *self, const char *path) {
+
+    if (self == NULL) {
+        Sirtet_setError("ScoreList_writeBinary passed a NULL ScoreList\n");
+        return -1;
+    }
+
+    size_t name_sz = self->namelen + 1;
+    size_t record_sz = 4 + name_sz;
+    size_t nbytes = HISCORES_HEADER_SZ + self->len * record_sz;
+
+    unsigned char *data = (unsigned char*)calloc(nbytes, 1);
+    if (data == NULL) {
+        Sirtet_setError("Error allocating memory for hiscores file\n");
+        return -1;
+    }
+
+    unsigned char *records = data + HISCORES_HEADER_SZ;
+    for (size_t i = 0; i < self->len; i++) {
+        unsigned char *record = records + i * record_sz;
+        writeU32(record, (uint32_t)self->scores[i]);
+        memcpy(record + 4, self->names + i * name_sz, name_sz);
+    }
+
+    memcpy(data, HISCORES_MAGIC, 4);
+    writeU32(data + 4, HISCORES_VERSION);
+    writeU32(data + 8, (uint32_t)self->namelen);
+    writeU32(data + 12, (uint32_t)self->len);
+    writeU32(data + 16, checksumCrc32(records, self->len * record_sz));
+
+    char tmp_path[FILEPATH_SZ];
+    if (snprintf(tmp_path, FILEPATH_SZ, "%s.tmp", path) >= FILEPATH_SZ) {
+        free(data);
+        Sirtet_setError("Hiscores file path too long\n");
+        return -1;
+    }
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (f == NULL) {
+        free(data);
+        Sirtet_setError("Error opening temporary hiscores file\n");
+        return -1;
+    }
+
+    bool written = (
+        fwrite(data, 1, nbytes, f) == nbytes
+        && flushToDisk(f) == 0
+    );
+    written = (fclose(f) == 0) && written;
+    free(data);
+
+    if (!written) {
+        remove(tmp_path);
+        Sirtet_setError("Error writing temporary hiscores file\n");
+        return -1;
+    }
+
+#ifdef _WIN32
+    bool replaced = MoveFileExA(
+        tmp_path, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+    );
+#else
+    bool replaced = (rename(tmp_path, path) == 0);
+#endif
+
+    if (!replaced) {
+        remove(tmp_path);
+        Sirtet_setError("Error replacing hiscores file\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
 /******************************************************************************
  * ScoreDisplay methods
 ******************************************************************************/
@@ -271,12 +682,48 @@ int ScoreList_toFile(ScoreList *self, FILE *f) {
 
 ScoreDisplay *ScoreDisplay_init(
     ScoreList *sl, 
-    int first, int last, int rank_start,
-    SDL_Renderer *rend,
+    int first, int last, int rank_start, size_t pool_size,
     TTF_Font *lbl_font, const SDL_Color *lbl_col
 ) {
 
-    ScoreDisplay *retval = malloc(sizeof(ScoreDisplay));
+    size_t nbytes = ScoreDisplay_requiredBytes(sl, pool_size);
+    void *mem = malloc(nbytes);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory in ScoreDisplay_init\n");
+        return NULL;
+    }
+
+    ScoreDisplay *retval = ScoreDisplay_build(
+        mem, nbytes, sl, first, last, rank_start, pool_size,
+        lbl_font, lbl_col
+    );
+    if (retval == NULL) {
+        free(mem);
+    }
+    return retval;
+}
+
+
+size_t ScoreDisplay_requiredBytes(ScoreList *sl, size_t pool_size) {
+
+    // memory structure:
+    // [] ScoreDisplay struct
+    // [] row label pool
+    // [] name buffer
+    return (
+        sizeof(ScoreDisplay)
+        + pool_size * sizeof(ScoreDisplayRow)
+        + (sl->namelen + 1) * sizeof(char)
+    );
+}
+
+
+ScoreDisplay *ScoreDisplay_build(
+    void *data, size_t data_size,
+    ScoreList *sl, 
+    int first, int last, int rank_start, size_t pool_size,
+    TTF_Font *lbl_font, const SDL_Color *lbl_col
+) {
 
     if (
         first > last ||
@@ -294,107 +741,227 @@ ScoreDisplay *ScoreDisplay_init(
         Sirtet_setError(buff);
         return NULL;
     }
-    retval->n_lbls = (last - first + 1);
-
 
-    size_t arrsz = retval->n_lbls * sizeof(SDL_Texture*);
-    retval->rank_lbls = malloc(arrsz);
-    retval->name_lbls = malloc(arrsz);
-    retval->score_lbls = malloc(arrsz);
-
-    char rankbuff[12];
-    char scorebuff[12];
-    char *namebuff = calloc(sl->namelen + 1, sizeof(char));
-    if (namebuff == NULL) {
-        Sirtet_setError("Error allocating memory in ScoreDisplay_init\n");
+    size_t nbytes = ScoreDisplay_requiredBytes(sl, pool_size);
+    if (data == NULL || data_size < nbytes) {
+        Sirtet_setError("Insufficient memory to build ScoreDisplay\n");
         return NULL;
     }
+    memset(data, 0, nbytes);
+
+    ScoreDisplay *retval = (ScoreDisplay*)data;
+    ScoreDisplayRow *pool = (ScoreDisplayRow*)(
+        (char*)data + sizeof(ScoreDisplay));
+
+    *retval = (ScoreDisplay){
+        .sl=sl,
+        .first=first,
+        .rank_start=rank_start,
+        .n_lbls=(last - first + 1),
+        .top=0,
+        .lbl_font=lbl_font,
+        .lbl_col=*lbl_col,
+        .pool_size=pool_size,
+        .pool=pool,
+        .uses=0,
+        .namebuff=(char*)(pool + pool_size)
+    };
+
+    for (size_t i = 0; i < pool_size; i++) {
+        pool[i].row = -1;
+    }
+    return retval;
+}
 
-    for (
-        int lbl_i = 0, rank = rank_start, sl_i = first;
-        lbl_i < retval->n_lbls && sl_i <= last;
-        lbl_i++, rank++, sl_i++
-    ) {
 
-        int score;
-        if (ScoreList_get(sl, sl_i, namebuff, &score) != 0) {
-            free(retval);
-            return NULL;
+// Destroy one pooled row's labels, marking its slot unused
+static void ScoreDisplayRow_clear(ScoreDisplayRow *slot) {
+    SDL_Texture **lbls[3] = {
+        &slot->rank_lbl, &slot->name_lbl, &slot->score_lbl
+    };
+    for (int j = 0; j < 3; j++) {
+        if (*lbls[j] != NULL) {
+            SDL_DestroyTexture(*lbls[j]);
+            *lbls[j] = NULL;
         }
+    }
+    slot->row = -1;
+}
+
+
+void ScoreDisplay_destroyLabels(ScoreDisplay *self) {
+    for (size_t i = 0; i < self->pool_size; i++) {
+        ScoreDisplayRow_clear(&self->pool[i]);
+    }
+}
 
-        snprintf(scorebuff, 12, "%d", score);
-        snprintf(rankbuff, 12, "%d", rank);
 
-        SDL_Surface *namesurf = TTF_RenderText_Solid(
-            lbl_font, namebuff, *lbl_col);
+int ScoreDisplay_deconstruct(ScoreDisplay *self) {
+    if (self == NULL) {
+        return 0;
+    }
+
+    ScoreDisplay_destroyLabels(self);
+    free(self);
 
-        SDL_Surface *scoresurf = TTF_RenderText_Solid(
-            lbl_font, scorebuff, *lbl_col);
+    return 0;
+}
 
-        SDL_Surface *ranksurf = TTF_RenderText_Solid(
-            lbl_font, rankbuff, *lbl_col);
 
+int ScoreDisplay_scrollTo(ScoreDisplay *self, int top) {
+    int max_top = self->n_lbls > 0 ? (int)self->n_lbls - 1 : 0;
+    self->top = top < 0 ? 0 : (top > max_top ? max_top : top);
+    return self->top;
+}
+
+
+// Pooled labels for row, or NULL if not rasterized
+static ScoreDisplayRow* ScoreDisplay_findRow(ScoreDisplay *self, int row) {
+    for (size_t i = 0; i < self->pool_size; i++) {
+        if (self->pool[i].row == row) {
+            return &self->pool[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Rasterize row's labels into the least recently used slot not
+ *        used since (and including) use count keep_from
+ * @return The slot rasterized into, or NULL on error (or if every slot is
+ *         in use)
+ */
+static ScoreDisplayRow* ScoreDisplay_rasterize(
+    ScoreDisplay *self, SDL_Renderer *rend, int row, Uint64 keep_from
+) {
+
+    ScoreDisplayRow *slot = NULL;
+    for (size_t i = 0; i < self->pool_size; i++) {
+        ScoreDisplayRow *cand = &self->pool[i];
+        if (cand->row >= 0 && cand->last_used >= keep_from) {
+            continue;
+        }
         if (
-            namesurf == NULL ||
-            scoresurf == NULL ||
-            ranksurf == NULL
+            slot == NULL
+            || cand->row < 0
+            || (slot->row >= 0 && cand->last_used < slot->last_used)
         ) {
-            char errbuff[128];
-            snprintf(
-                errbuff, 128, 
-                "Error creating labels for ScoreDisplay:\n%s\n",
-                TTF_GetError()
-            );
-            return NULL;
+            slot = cand;
         }
+    }
+    if (slot == NULL) {
+        Sirtet_setError("ScoreDisplay has no free row labels\n");
+        return NULL;
+    }
+    ScoreDisplayRow_clear(slot);
+
+    char rankbuff[12];
+    char scorebuff[12];
+    char *namebuff = self->namebuff;
+
+    int score;
+    if (ScoreList_get(self->sl, self->first + row, namebuff, &score) != 0) {
+        Sirtet_setError("ScoreDisplay row is no longer in ScoreList\n");
+        return NULL;
+    }
 
-        retval->name_lbls[lbl_i] = SDL_CreateTextureFromSurface(
-            rend, namesurf);
-        retval->score_lbls[lbl_i] = SDL_CreateTextureFromSurface(
-            rend, scoresurf);
-        retval->rank_lbls[lbl_i] = SDL_CreateTextureFromSurface(
-            rend, ranksurf);
+    snprintf(scorebuff, 12, "%d", score);
+    snprintf(rankbuff, 12, "%d", self->rank_start + row);
 
+    SDL_Surface *namesurf = TTF_RenderText_Solid(
+        self->lbl_font, namebuff, self->lbl_col);
+
+    SDL_Surface *scoresurf = TTF_RenderText_Solid(
+        self->lbl_font, scorebuff, self->lbl_col);
+
+    SDL_Surface *ranksurf = TTF_RenderText_Solid(
+        self->lbl_font, rankbuff, self->lbl_col);
+
+    if (
+        namesurf == NULL ||
+        scoresurf == NULL ||
+        ranksurf == NULL
+    ) {
+        char errbuff[128];
+        snprintf(
+            errbuff, 128, 
+            "Error creating labels for ScoreDisplay:\n%s\n",
+            TTF_GetError()
+        );
+        Sirtet_setError(errbuff);
         SDL_FreeSurface(namesurf);
         SDL_FreeSurface(scoresurf);
         SDL_FreeSurface(ranksurf);
+        return NULL;
+    }
 
-        if (
-            retval->name_lbls[lbl_i] == NULL ||
-            retval->score_lbls[lbl_i] == NULL ||
-            retval->rank_lbls[lbl_i] == NULL
-        ) {
-            char errbuff[128];
-            snprintf(
-                errbuff, 128, 
-                "Error creating labels for ScoreDisplay:\n%s\n",
-                SDL_GetError()
-            );
-            return NULL;
-        }
+    slot->name_lbl = SDL_CreateTextureFromSurface(rend, namesurf);
+    slot->score_lbl = SDL_CreateTextureFromSurface(rend, scoresurf);
+    slot->rank_lbl = SDL_CreateTextureFromSurface(rend, ranksurf);
+
+    SDL_FreeSurface(namesurf);
+    SDL_FreeSurface(scoresurf);
+    SDL_FreeSurface(ranksurf);
+
+    if (
+        slot->name_lbl == NULL ||
+        slot->score_lbl == NULL ||
+        slot->rank_lbl == NULL
+    ) {
+        char errbuff[128];
+        snprintf(
+            errbuff, 128, 
+            "Error creating labels for ScoreDisplay:\n%s\n",
+            SDL_GetError()
+        );
+        Sirtet_setError(errbuff);
+        ScoreDisplayRow_clear(slot);
+        return NULL;
     }
-    free(namebuff);
-    return retval;
+
+    slot->row = row;
+    return slot;
 }
 
 
-int ScoreDisplay_deconstruct(ScoreDisplay *self) {
-    if (self == NULL) {
-        return 0;
+// Number of rows that will be drawn for a requested n, from the top row
+static int ScoreDisplay_pageRows(ScoreDisplay *self, int n) {
+    int remaining = (int)self->n_lbls - self->top;
+    if (n <= 0 || n > remaining) {
+        n = remaining;
     }
+    return MIN2(n, (int)self->pool_size);
+}
 
-    for (int i = 0; i < self->n_lbls; i++) {
-        SDL_DestroyTexture(self->name_lbls[i]);
-        SDL_DestroyTexture(self->score_lbls[i]);
-        SDL_DestroyTexture(self->rank_lbls[i]);
-    }
 
-    free(self->name_lbls);
-    free(self->score_lbls);
-    free(self->rank_lbls);
+int ScoreDisplay_prefetch(ScoreDisplay *self, int n, SDL_Renderer *rend) {
 
-    free(self);
+    int page = ScoreDisplay_pageRows(self, n);
+    int start = self->top + page;
+    int end = MIN2(start + page, (int)self->n_lbls);
+
+    // Rows drawn last are kept, along with anything already prefetched
+    Uint64 keep_from = self->uses;
+
+    for (int row = start; row < end; row++) {
+        if (ScoreDisplay_findRow(self, row) != NULL) {
+            continue;
+        }
 
+        // Pool only holds the current page - nowhere to prefetch into
+        if (page * 2 > (int)self->pool_size) {
+            return 0;
+        }
+
+        ScoreDisplayRow *slot = ScoreDisplay_rasterize(
+            self, rend, row, keep_from);
+        if (slot == NULL) {
+            return -1;
+        }
+        slot->last_used = self->uses;
+        return 1;
+    }
     return 0;
 }
 
@@ -409,18 +976,27 @@ int ScoreDisplay_draw(
 
     int yoffset = 0;
 
-    if (n <= 0 || n > self->n_lbls) {
-        n = self->n_lbls;
-    }
+    n = ScoreDisplay_pageRows(self, n);
+    Uint64 use = ++self->uses;
 
     for (int lbl_i = 0; lbl_i < n; lbl_i++) {
 
+        int row = self->top + lbl_i;
+        ScoreDisplayRow *slot = ScoreDisplay_findRow(self, row);
+        if (slot == NULL) {
+            slot = ScoreDisplay_rasterize(self, rend, row, use);
+            if (slot == NULL) {
+                return -1;
+            }
+        }
+        slot->last_used = use;
+
         SDL_Rect rankdst = {
             .x=draw_window->x,
             .y=draw_window->y + yoffset
         };
         SDL_QueryTexture(
-            self->rank_lbls[lbl_i], NULL, NULL, &rankdst.w, &rankdst.h);
+            slot->rank_lbl, NULL, NULL, &rankdst.w, &rankdst.h);
 
 
         SDL_Rect namedst = {
@@ -428,18 +1004,18 @@ int ScoreDisplay_draw(
             .y=draw_window->y + yoffset
         };
         SDL_QueryTexture(
-            self->name_lbls[lbl_i], NULL, NULL, &namedst.w, &namedst.h);
+            slot->name_lbl, NULL, NULL, &namedst.w, &namedst.h);
 
 
         SDL_Rect scoredst;
         SDL_QueryTexture(
-            self->score_lbls[lbl_i], NULL, NULL, &scoredst.w, &scoredst.h);
+            slot->score_lbl, NULL, NULL, &scoredst.w, &scoredst.h);
         scoredst.x = (draw_window->x + draw_window->w - scoredst.w);
         scoredst.y = draw_window->y + yoffset;
 
-        SDL_RenderCopy(rend, self->rank_lbls[lbl_i], NULL, &rankdst);
-        SDL_RenderCopy(rend, self->name_lbls[lbl_i], NULL, &namedst);
-        SDL_RenderCopy(rend, self->score_lbls[lbl_i], NULL, &scoredst);
+        SDL_RenderCopy(rend, slot->rank_lbl, NULL, &rankdst);
+        SDL_RenderCopy(rend, slot->name_lbl, NULL, &namedst);
+        SDL_RenderCopy(rend, slot->score_lbl, NULL, &scoredst);
 
         yoffset += MAX3(rankdst.h, namedst.h, scoredst.h);
     }
@@ -455,5 +1031,3 @@ int ScoreDisplay_draw(
 
     return 0;
 }
-
-
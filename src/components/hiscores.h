@@ -16,6 +16,18 @@
 #include <SDL2/SDL_ttf.h>
 
 
+/* Binary hiscores file layout. All integers are little-endian.
+ *
+ *   header:  char magic[4], u32 version, u32 namelen, u32 count, u32 crc
+ *   records: count fixed-width records of i32 score, char name[namelen + 1]
+ *
+ * crc is the CRC-32 of the records. Names are nul-padded.
+ */
+#define HISCORES_MAGIC "SRHS"
+#define HISCORES_VERSION 1
+#define HISCORES_HEADER_SZ 20
+
+
 typedef struct {
     size_t len;
     size_t size;
@@ -28,39 +40,99 @@ typedef struct {
 } ScoreList;
 
 
-// A struct representing a display of the above
+// Rasterized labels of one row of a ScoreDisplay
 typedef struct {
+    int row;                    // Row labels are for, -1 if slot is unused
+    Uint64 last_used;           // Display's use count when row last used
+    SDL_Texture *rank_lbl;
+    SDL_Texture *name_lbl;
+    SDL_Texture *score_lbl;
+} ScoreDisplayRow;
+
+
+// A struct representing a display of the above. Rows are only rasterized
+// once drawn (or prefetched), into a fixed pool of row labels that are
+// recycled least-recently-used first
+typedef struct {
+
+    ScoreList *sl;              // List rows are read from when rasterized
+    int first;                  // Index of ScoreList shown as first row
+    int rank_start;             // Rank number shown on first row
+    size_t n_lbls;              // Number of rows
+    int top;                    // First row currently shown
 
-    size_t n_lbls;
-    SDL_Texture **name_lbls;
-    SDL_Texture **score_lbls;
-    SDL_Texture **rank_lbls;
+    TTF_Font *lbl_font;
+    SDL_Color lbl_col;
 
+    size_t pool_size;           // Number of rows that can be rasterized
+    ScoreDisplayRow *pool;
+    Uint64 uses;                // Number of draws & prefetches so far
+    char *namebuff;             // Buffer for names read from ScoreList
 
-} ScoreDisplay; 
+} ScoreDisplay;
 
 
 /******************************************************************************
  * ScoreList methods
 ******************************************************************************/
 
+// Initialize a ScoreList from the rows of a text file, sized to hold at least
+// `size` entries and every row of the file
 ScoreList* ScoreList_initFromFile(FILE *f, size_t size, size_t namelen);
 
 // Initialize a ScoreList with the given parameters
 ScoreList* ScoreList_init(size_t size, size_t namelen);
 
-// Destroy a ScoreList and free all its memory
+// Destroy a ScoreList and free all its memory. Does nothing if NULL
 void ScoreList_deconstruct(ScoreList *self);
 
 // Write to the given opened file
 int ScoreList_toFile(ScoreList *self, FILE *f);
 
-// Read contents of a text file into existing ScoreList
+// Read contents of a text file into existing ScoreList. The file is read
+// whole before parsing, and nothing is added unless every row parses & fits
 int ScoreList_readFile(ScoreList *self, FILE *f);
 
+/**
+ * @brief Read a binary hiscores file (see HISCORES_MAGIC) into an existing
+ *        ScoreList. The file is memory-mapped where supported. Nothing is
+ *        added unless the whole file is valid
+ * @param self - ScoreList to add the file's entries to
+ * @param path - Path of file to read
+ * @return 0 on success, -1 if file is missing, invalid or doesn't fit
+ */
+int ScoreList_readBinary(ScoreList *self, const char *path);
+
+// Read binary hiscores file contents from memory (as ScoreList_readBinary)
+int ScoreList_readBinaryData(ScoreList *self, const void *data, size_t size);
+
+/**
+ * @brief Write ScoreList as a binary hiscores file. Contents are written to
+ *        a temporary file next to path, which then replaces path in one
+ *        step, so path is only ever the old table or the new one
+ * @return 0 on success, -1 on error (leaving any file at path untouched)
+ */
+int ScoreList_writeBinary(ScoreList *self, const char *path);
+
 // Add an entry to score list, returning a status code
 int ScoreList_add(ScoreList *self, char *name, int score);
 
+/**
+ * @brief Insert an entry into a ScoreList sorted in descending order, keeping
+ *        it sorted. Entries tied with score stay ahead of the new entry. If
+ *        the list is full, its lowest entry is dropped to make room
+ * @param self - ScoreList to insert into, sorted by ScoreList_sort
+ * @param name - Name of new entry
+ * @param score - Score of new entry
+ * @return Index (rank) the entry was inserted at, or -1 if it was not
+ *         inserted (name too long, or score too low to make a full list)
+ */
+int ScoreList_insert(ScoreList *self, const char *name, int score);
+
+// Index a new entry with the given score would be inserted at in a
+// descending-sorted ScoreList. Equals self->size if it wouldn't fit
+int ScoreList_rankOf(ScoreList *self, int score);
+
 // Remove the final element of the scorelist, returning a status code
 int ScoreList_pop(ScoreList *self, char *out_name, int *out_score);
 
@@ -70,6 +142,10 @@ int ScoreList_get(ScoreList *self, size_t idx, char *out_name, int *out_score);
 // Sort scoreList in descending order by score
 int ScoreList_sort(ScoreList *self);
 
+// Replace contents of dst with those of src. dst must have the same name
+// length, and room for all of src's entries
+int ScoreList_copy(ScoreList *dst, const ScoreList *src);
+
 
 
 /******************************************************************************
@@ -77,16 +153,18 @@ int ScoreList_sort(ScoreList *self);
 ******************************************************************************/
 
 /**
- * @brief Create a ScoreDisplay from an existing ScoreList
+ * @brief Create a ScoreDisplay from an existing ScoreList. No labels are
+ *        rasterized until rows are drawn
  * @param sl - ScoreList to use as basis
  * @param first - First index of ScoreList to read from
  * @param last - Final index of ScoreList to read from
  * @param rank_start - First rank number to show (in labels)
+ * @param pool_size - Most rows to keep rasterized at once. Must be at least
+ *                    the number of rows drawn at once
  */
 ScoreDisplay *ScoreDisplay_init(
     ScoreList *sl, 
-    int first, int last, int rank_start,
-    SDL_Renderer *rend,
+    int first, int last, int rank_start, size_t pool_size,
     TTF_Font *lbl_font, const SDL_Color *lbl_col
 );
 
@@ -95,9 +173,41 @@ ScoreDisplay *ScoreDisplay_init(
  */
 int ScoreDisplay_deconstruct(ScoreDisplay *self);
 
+// Number of bytes needed to build a ScoreDisplay over ScoreList sl, keeping
+// up to pool_size rows rasterized
+size_t ScoreDisplay_requiredBytes(ScoreList *sl, size_t pool_size);
+
+/**
+ * @brief Build a ScoreDisplay (as ScoreDisplay_init) within a provided block
+ *        of memory, of at least ScoreDisplay_requiredBytes(...) bytes.
+ *        Its labels must still be destroyed with ScoreDisplay_destroyLabels
+ */
+ScoreDisplay *ScoreDisplay_build(
+    void *data, size_t data_size,
+    ScoreList *sl, 
+    int first, int last, int rank_start, size_t pool_size,
+    TTF_Font *lbl_font, const SDL_Color *lbl_col
+);
+
+// Destroy a ScoreDisplay's label textures, without freeing its memory
+void ScoreDisplay_destroyLabels(ScoreDisplay *self);
+
+// Scroll so that row top is drawn first, returning the (clamped) top row
+int ScoreDisplay_scrollTo(ScoreDisplay *self, int top);
+
+/**
+ * @brief Rasterize the next row of the page after the n rows drawn from the
+ *        current top, if not already, so scrolling down finds it ready.
+ *        Rasterizes at most one row per call, never evicting visible rows
+ * @return 1 if a row was rasterized, 0 if the next page is ready (or there
+ *         isn't one), -1 on error
+ */
+int ScoreDisplay_prefetch(ScoreDisplay *self, int n, SDL_Renderer *rend);
+
 /**
  * @param self - ScoreDisplay to draw
- * @param n - Number of labels to draw. 0 or negative to draw all
+ * @param n - Number of rows to draw, from the current top row. 0 or
+ *            negative to draw all (up to pool size)
  * @param rend - SDL Renderer pointer to draw with
  * @param draw_window - Pointer to dimensions to draw within
  * @param out_dim - Pointer to rectangle that will be written into
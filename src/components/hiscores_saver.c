@@ -0,0 +1,192 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hiscores.h"
+#include "hiscores_saver.h"
+#include "sirtet.h"
+
+
+// Worker thread - writes submitted scores until told to quit
+static int HiscoresSaver_work(void *data) {
+
+    HiscoresSaver *self = (HiscoresSaver*)data;
+
+    SDL_LockMutex(self->lock);
+    while (true) {
+
+        while (self->n_saved == self->n_submitted && !self->quit) {
+            SDL_CondWait(self->wake, self->lock);
+        }
+        if (self->n_saved == self->n_submitted) {
+            break;
+        }
+
+        // Let a burst of submissions settle, so only the last is written
+        Uint64 seen;
+        do {
+            seen = self->n_submitted;
+            if (self->hurry || self->quit) {
+                break;
+            }
+            SDL_CondWaitTimeout(self->wake, self->lock, HISCORES_SAVE_SETTLE_MS);
+        } while (self->n_submitted != seen);
+
+        ScoreList_copy(self->writing, self->pending);
+        Uint64 saving = self->n_submitted;
+        self->hurry = false;
+        SDL_UnlockMutex(self->lock);
+
+        // Slow part, with the lock released so submissions never wait on it
+        int status = ScoreList_writeBinary(self->writing, self->path);
+
+        SDL_LockMutex(self->lock);
+        if (status != 0) {
+            // Error was set on this thread - hand it over to the main one
+            self->failed = true;
+            snprintf(self->error, ERRMSG_SZ, "%s", Sirtet_getError());
+        }
+        self->n_saved = saving;
+        self->n_writes++;
+        SDL_CondBroadcast(self->written);
+    }
+    SDL_UnlockMutex(self->lock);
+
+    return 0;
+}
+
+
+HiscoresSaver* HiscoresSaver_init(
+    const char *path, size_t size, size_t namelen
+) {
+
+    // memory structure:
+    // [] HiscoresSaver struct
+    // [] path
+    // [] error message
+    size_t path_sz = strlen(path) + 1;
+    size_t nbytes = sizeof(HiscoresSaver) + path_sz + ERRMSG_SZ;
+
+    void *mem = calloc(1, nbytes);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for HiscoresSaver\n");
+        return NULL;
+    }
+
+    HiscoresSaver *retval = (HiscoresSaver*)mem;
+    retval->path = (char*)mem + sizeof(HiscoresSaver);
+    retval->error = retval->path + path_sz;
+    memcpy(retval->path, path, path_sz);
+
+    retval->pending = ScoreList_init(size, namelen);
+    retval->writing = ScoreList_init(size, namelen);
+    retval->lock = SDL_CreateMutex();
+    retval->wake = SDL_CreateCond();
+    retval->written = SDL_CreateCond();
+
+    if (
+        retval->pending == NULL || retval->writing == NULL
+        || retval->lock == NULL || retval->wake == NULL
+        || retval->written == NULL
+    ) {
+        Sirtet_setError("Error creating HiscoresSaver\n");
+        HiscoresSaver_deconstruct(retval);
+        return NULL;
+    }
+
+    retval->thread = SDL_CreateThread(
+        HiscoresSaver_work, "hiscores saver", (void*)retval);
+    if (retval->thread == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ,
+            "Error starting HiscoresSaver thread: %s\n", SDL_GetError()
+        );
+        HiscoresSaver_deconstruct(retval);
+        Sirtet_setError(buff);
+        return NULL;
+    }
+
+    return retval;
+}
+
+
+int HiscoresSaver_deconstruct(HiscoresSaver *self) {
+
+    if (self == NULL) {
+        return 0;
+    }
+
+    if (self->thread != NULL) {
+        SDL_LockMutex(self->lock);
+        self->quit = true;
+        SDL_CondSignal(self->wake);
+        SDL_UnlockMutex(self->lock);
+        SDL_WaitThread(self->thread, NULL);
+    }
+
+    int retval = self->failed ? HiscoresSaver_poll(self) : 0;
+
+    if (self->pending != NULL) {
+        ScoreList_deconstruct(self->pending);
+    }
+    if (self->writing != NULL) {
+        ScoreList_deconstruct(self->writing);
+    }
+    if (self->lock != NULL) {
+        SDL_DestroyMutex(self->lock);
+    }
+    if (self->wake != NULL) {
+        SDL_DestroyCond(self->wake);
+    }
+    if (self->written != NULL) {
+        SDL_DestroyCond(self->written);
+    }
+    free(self);
+
+    return retval;
+}
+
+
+int HiscoresSaver_submit(HiscoresSaver *self, const ScoreList *scores) {
+
+    SDL_LockMutex(self->lock);
+    int retval = ScoreList_copy(self->pending, scores);
+    if (retval == 0) {
+        self->n_submitted++;
+        SDL_CondSignal(self->wake);
+    }
+    SDL_UnlockMutex(self->lock);
+
+    return retval;
+}
+
+
+int HiscoresSaver_poll(HiscoresSaver *self) {
+
+    SDL_LockMutex(self->lock);
+    int retval = 0;
+    if (self->failed) {
+        Sirtet_setError(self->error);
+        self->failed = false;
+        retval = -1;
+    }
+    SDL_UnlockMutex(self->lock);
+
+    return retval;
+}
+
+
+void HiscoresSaver_flush(HiscoresSaver *self) {
+
+    SDL_LockMutex(self->lock);
+    Uint64 target = self->n_submitted;
+    while (self->n_saved < target) {
+        self->hurry = true;
+        SDL_CondSignal(self->wake);
+        SDL_CondWait(self->written, self->lock);
+    }
+    SDL_UnlockMutex(self->lock);
+}
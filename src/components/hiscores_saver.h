@@ -0,0 +1,70 @@
+/* hiscores_saver.h
+ *
+ * Background hiscores persistence. The main thread submits copies of a
+ * ScoreList and carries on; a worker thread writes them out (including the
+ * fsync, which can stall for a long time on slow storage) with
+ * ScoreList_writeBinary.
+ *
+ * Submissions are coalesced: only the newest copy is kept, and the worker
+ * waits for submissions to settle before writing, so a burst of updates
+ * costs a single write. A failed write is held until the main thread next
+ * calls HiscoresSaver_poll(...), which raises it with Sirtet_setError.
+ */
+
+#ifndef HISCORES_SAVER_H
+#define HISCORES_SAVER_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "hiscores.h"
+
+
+// Time, in ms, the worker waits for further submissions before writing
+#define HISCORES_SAVE_SETTLE_MS 200
+
+
+typedef struct {
+    char *path;                 // File scores are written to
+
+    SDL_Thread *thread;
+    SDL_mutex *lock;            // Guards everything below, but `writing`
+    SDL_cond *wake;             // Signalled on submission, flush or exit
+    SDL_cond *written;          // Signalled when worker finishes a write
+
+    ScoreList *pending;         // Newest submitted scores
+    Uint64 n_submitted;         // Submissions so far
+    Uint64 n_saved;             // Submissions written (or failed) so far
+    Uint64 n_writes;            // Writes performed so far
+    bool hurry;                 // Write pending scores without settling
+    bool quit;                  // Write pending scores, then exit
+
+    bool failed;                // Whether a write failed since last poll
+    char *error;                // Error message of failed write
+
+    ScoreList *writing;         // Worker's copy, being written
+} HiscoresSaver;
+
+
+/**
+ * @brief Start a saver writing to path, for ScoreLists of up to size
+ *        entries with names of namelen characters
+ */
+HiscoresSaver* HiscoresSaver_init(const char *path, size_t size, size_t namelen);
+
+// Write any pending scores, stop the worker and free the saver. Returns 0
+// on success, -1 (with error set) if any write failed since last poll
+int HiscoresSaver_deconstruct(HiscoresSaver *self);
+
+// Queue a copy of scores to be written, replacing any not yet written.
+// Returns 0 on success, -1 if scores don't fit the saver
+int HiscoresSaver_submit(HiscoresSaver *self, const ScoreList *scores);
+
+// Report a failed write, if any since last poll, by setting the error and
+// returning -1. Returns 0 otherwise. Called once per frame
+int HiscoresSaver_poll(HiscoresSaver *self);
+
+// Block until everything submitted so far has been written
+void HiscoresSaver_flush(HiscoresSaver *self);
+
+#endif
@@ -0,0 +1,686 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hiscores.h"
+#include "leaderboard.h"
+#include "sirtet.h"
+#include "utilities.h"
+
+
+// Levels of runs Leaderboard_sortFile merges through. Each level holds runs
+// LEADERBOARD_MERGE_WAYS times longer than the last, so this is never reached
+#define MERGE_LEVELS 8
+
+
+/******************************************************************************
+ * Line parsing
+******************************************************************************/
+
+
+// Read a line of f into line, without its line ending. Returns 1 if a line
+// was read, 0 at end of stream, -1 if line is longer than size allows
+static int readLine(FILE *f, char *line, size_t size) {
+
+    if (fgets(line, (int)size, f) == NULL) {
+        return 0;
+    }
+
+    size_t len = strlen(line);
+    bool ended = len > 0 && line[len - 1] == '\n';
+    if (!ended && !feof(f)) {
+        return -1;
+    }
+
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+        line[--len] = '\0';
+    }
+    return 1;
+}
+
+
+// Parse a "NAME SCORE" line. Returns 1 if an entry was parsed, 0 for a
+// blank line, -1 if malformed
+static int parseLine(
+    char *line, size_t namelen, char *out_name, int *out_score
+) {
+
+    char *cur = line;
+    while (*cur == ' ' || *cur == '\t') {
+        cur++;
+    }
+    if (*cur == '\0') {
+        return 0;
+    }
+
+    size_t len = 0;
+    while (cur[len] != '\0' && cur[len] != ' ' && cur[len] != '\t') {
+        len++;
+    }
+    if (len > namelen) {
+        Sirtet_setError("Error parsing scores: Name too long\n");
+        return -1;
+    }
+    memcpy(out_name, cur, len);
+    out_name[len] = '\0';
+    cur += len;
+
+    while (*cur == ' ' || *cur == '\t') {
+        cur++;
+    }
+    int parsed = parseInt(cur, out_score);
+    if (parsed < 0) {
+        return -1;
+    }
+    cur += parsed;
+
+    while (*cur == ' ' || *cur == '\t') {
+        cur++;
+    }
+    if (*cur != '\0') {
+        Sirtet_setError("Error parsing scores: Unexpected text after score\n");
+        return -1;
+    }
+    return 1;
+}
+
+
+/******************************************************************************
+ * Leaderboard
+******************************************************************************/
+
+
+Leaderboard* Leaderboard_init(size_t namelen) {
+
+    Leaderboard *retval = (Leaderboard*)malloc(sizeof(Leaderboard));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard\n");
+        return NULL;
+    }
+
+    *retval = (Leaderboard){
+        .namelen=namelen,
+        .len=0,
+        .capacity=0,
+        .root=0,
+        .rng=0x9E3779B9u,
+        .nodes=(LeaderboardNode*)calloc(1, sizeof(LeaderboardNode)),
+        .names=(char*)calloc(namelen + 1, sizeof(char))
+    };
+
+    if (retval->nodes == NULL || retval->names == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard\n");
+        Leaderboard_deconstruct(retval);
+        return NULL;
+    }
+    return retval;
+}
+
+
+void Leaderboard_deconstruct(Leaderboard *self) {
+    if (self == NULL) {
+        return;
+    }
+    free(self->nodes);
+    free(self->names);
+    free(self);
+}
+
+
+// Make room for at least one more entry
+static int Leaderboard_reserve(Leaderboard *self) {
+
+    if (self->len < self->capacity) {
+        return 0;
+    }
+
+    size_t capacity = self->capacity > 0 ? 2 * self->capacity : 64;
+    if (capacity >= UINT32_MAX) {
+        Sirtet_setError("Leaderboard is full\n");
+        return -1;
+    }
+
+    // One extra for the sentinel
+    LeaderboardNode *nodes = (LeaderboardNode*)realloc(
+        self->nodes, (capacity + 1) * sizeof(LeaderboardNode));
+    if (nodes == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard entries\n");
+        return -1;
+    }
+    self->nodes = nodes;
+
+    char *names = (char*)realloc(
+        self->names, (capacity + 1) * (self->namelen + 1) * sizeof(char));
+    if (names == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard entries\n");
+        return -1;
+    }
+    self->names = names;
+
+    self->capacity = capacity;
+    return 0;
+}
+
+
+// xorshift32 - treap balance only needs priorities to look random
+static Uint32 Leaderboard_nextPriority(Leaderboard *self) {
+    Uint32 x = self->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->rng = x;
+    return x;
+}
+
+
+static void Leaderboard_recount(Leaderboard *self, Uint32 idx) {
+    LeaderboardNode *nodes = self->nodes;
+    nodes[idx].count = (
+        1 + nodes[nodes[idx].left].count + nodes[nodes[idx].right].count
+    );
+}
+
+
+// Rotate idx's left child up into its place, returning the new subtree root
+static Uint32 Leaderboard_rotateRight(Leaderboard *self, Uint32 idx) {
+    LeaderboardNode *nodes = self->nodes;
+    Uint32 child = nodes[idx].left;
+    nodes[idx].left = nodes[child].right;
+    nodes[child].right = idx;
+    Leaderboard_recount(self, idx);
+    Leaderboard_recount(self, child);
+    return child;
+}
+
+
+// Rotate idx's right child up into its place, returning the new subtree root
+static Uint32 Leaderboard_rotateLeft(Leaderboard *self, Uint32 idx) {
+    LeaderboardNode *nodes = self->nodes;
+    Uint32 child = nodes[idx].right;
+    nodes[idx].right = nodes[child].left;
+    nodes[child].left = idx;
+    Leaderboard_recount(self, idx);
+    Leaderboard_recount(self, child);
+    return child;
+}
+
+
+// Insert node into subtree at root, returning the subtree's new root
+static Uint32 Leaderboard_insertNode(
+    Leaderboard *self, Uint32 root, Uint32 node
+) {
+
+    if (root == 0) {
+        return node;
+    }
+
+    LeaderboardNode *nodes = self->nodes;
+    if (nodes[node].score > nodes[root].score) {
+        nodes[root].left = Leaderboard_insertNode(self, nodes[root].left, node);
+        Leaderboard_recount(self, root);
+        if (nodes[nodes[root].left].priority > nodes[root].priority) {
+            root = Leaderboard_rotateRight(self, root);
+        }
+    }
+    else {
+        nodes[root].right = Leaderboard_insertNode(
+            self, nodes[root].right, node);
+        Leaderboard_recount(self, root);
+        if (nodes[nodes[root].right].priority > nodes[root].priority) {
+            root = Leaderboard_rotateLeft(self, root);
+        }
+    }
+    return root;
+}
+
+
+int Leaderboard_add(Leaderboard *self, const char *name, int score) {
+
+    size_t inputlen = strlen(name);
+    if (inputlen > self->namelen) {
+        Sirtet_setError("Name too long to add to Leaderboard\n");
+        return -1;
+    }
+
+    if (Leaderboard_reserve(self) != 0) {
+        return -1;
+    }
+
+    size_t rank = Leaderboard_rankOf(self, score);
+
+    Uint32 idx = (Uint32)(++self->len);
+    self->nodes[idx] = (LeaderboardNode){
+        .score=score,
+        .priority=Leaderboard_nextPriority(self),
+        .left=0,
+        .right=0,
+        .count=1
+    };
+
+    char *nameptr = self->names + idx * (self->namelen + 1);
+    memset(nameptr, 0, (self->namelen + 1) * sizeof(char));
+    memcpy(nameptr, name, inputlen * sizeof(char));
+
+    self->root = Leaderboard_insertNode(self, self->root, idx);
+    return (int)rank;
+}
+
+
+size_t Leaderboard_rankOf(Leaderboard *self, int score) {
+
+    // Count entries scoring at least as much
+    LeaderboardNode *nodes = self->nodes;
+    size_t rank = 0;
+    Uint32 cur = self->root;
+    while (cur != 0) {
+        if (nodes[cur].score >= score) {
+            rank += nodes[nodes[cur].left].count + 1;
+            cur = nodes[cur].right;
+        }
+        else {
+            cur = nodes[cur].left;
+        }
+    }
+    return rank;
+}
+
+
+int Leaderboard_get(
+    Leaderboard *self, size_t rank, char *out_name, int *out_score
+) {
+
+    if (rank >= self->len) {
+        return -1;
+    }
+
+    LeaderboardNode *nodes = self->nodes;
+    Uint32 cur = self->root;
+    while (cur != 0) {
+        size_t above = nodes[nodes[cur].left].count;
+        if (rank < above) {
+            cur = nodes[cur].left;
+        }
+        else if (rank == above) {
+            break;
+        }
+        else {
+            rank -= above + 1;
+            cur = nodes[cur].right;
+        }
+    }
+
+    if (out_name != NULL) {
+        strcpy(out_name, self->names + cur * (self->namelen + 1));
+    }
+    if (out_score != NULL) {
+        *out_score = nodes[cur].score;
+    }
+    return 0;
+}
+
+
+int Leaderboard_toScoreList(Leaderboard *self, ScoreList *out) {
+
+    if (out->len != 0) {
+        Sirtet_setError("Leaderboard_toScoreList passed a non-empty list\n");
+        return -1;
+    }
+    if (out->namelen < self->namelen) {
+        Sirtet_setError("Leaderboard names too long for ScoreList\n");
+        return -1;
+    }
+
+    size_t n = MIN2(self->len, out->size);
+    for (size_t rank = 0; rank < n; rank++) {
+        int score;
+        Leaderboard_get(self, rank, out->strbuff, &score);
+        if (ScoreList_add(out, out->strbuff, score) != 0) {
+            return -1;
+        }
+    }
+    return (int)n;
+}
+
+
+int Leaderboard_ingest(Leaderboard *self, FILE *f) {
+
+    size_t line_sz = self->namelen + 32;
+    char *line = (char*)malloc(line_sz + self->namelen + 1);
+    if (line == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard_ingest\n");
+        return -1;
+    }
+    char *name = line + line_sz;
+
+    int added = 0;
+    int status;
+    while ((status = readLine(f, line, line_sz)) > 0) {
+
+        int score;
+        int parsed = parseLine(line, self->namelen, name, &score);
+        if (parsed == 0) {
+            continue;
+        }
+        if (parsed < 0 || Leaderboard_add(self, name, score) < 0) {
+            free(line);
+            return -1;
+        }
+        added++;
+    }
+
+    free(line);
+    if (status < 0) {
+        Sirtet_setError("Error parsing scores: Line too long\n");
+        return -1;
+    }
+    return added;
+}
+
+
+/******************************************************************************
+ * External sort
+******************************************************************************/
+
+
+// An entry, as held in memory & in run files while sorting
+typedef struct {
+    Uint64 seq;             // Position in input stream, for stable ties
+    int score;
+    char name[];
+} SortRecord;
+
+
+static int SortRecord_compare(const void *a, const void *b) {
+    const SortRecord *rec_a = (const SortRecord*)a;
+    const SortRecord *rec_b = (const SortRecord*)b;
+    if (rec_a->score != rec_b->score) {
+        return rec_a->score > rec_b->score ? -1 : 1;
+    }
+    return rec_a->seq < rec_b->seq ? -1 : (rec_a->seq > rec_b->seq);
+}
+
+
+static void closeRuns(FILE **runs, int n) {
+    for (int i = 0; i < n; i++) {
+        fclose(runs[i]);
+    }
+}
+
+
+/**
+ * @brief Merge sorted run files into out, either as more records (for a
+ *        later merge) or as the final "NAME SCORE" lines
+ * @return Number of records written, or -1 on error
+ */
+static long mergeRuns(
+    FILE **runs, int n, FILE *out, bool as_text, size_t rec_sz
+) {
+
+    char *heads = (char*)malloc(n * rec_sz);
+    bool *valid = (bool*)malloc(n * sizeof(bool));
+    if (heads == NULL || valid == NULL) {
+        free(heads);
+        free(valid);
+        Sirtet_setError("Error allocating memory to merge sorted runs\n");
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        rewind(runs[i]);
+        valid[i] = fread(heads + i * rec_sz, rec_sz, 1, runs[i]) == 1;
+    }
+
+    // Runs are few, so the next record is found by scanning every head
+    long written = 0;
+    while (true) {
+        int best = -1;
+        for (int i = 0; i < n; i++) {
+            if (
+                valid[i] && (
+                    best < 0
+                    || SortRecord_compare(
+                        heads + i * rec_sz, heads + best * rec_sz) < 0
+                )
+            ) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        SortRecord *rec = (SortRecord*)(heads + best * rec_sz);
+        bool ok = (
+            as_text
+            ? fprintf(out, "%s %d\n", rec->name, rec->score) > 0
+            : fwrite(rec, rec_sz, 1, out) == 1
+        );
+        if (!ok) {
+            free(heads);
+            free(valid);
+            Sirtet_setError("Error writing sorted scores\n");
+            return -1;
+        }
+        written++;
+
+        valid[best] = fread(rec, rec_sz, 1, runs[best]) == 1;
+    }
+
+    free(heads);
+    free(valid);
+    return written;
+}
+
+
+// Add a sorted run to a level, merging full levels into the next
+static int pushRun(
+    FILE *levels[MERGE_LEVELS][LEADERBOARD_MERGE_WAYS], int *counts,
+    FILE *run, size_t rec_sz
+) {
+
+    for (int level = 0; level < MERGE_LEVELS; level++) {
+
+        levels[level][counts[level]++] = run;
+        if (counts[level] < LEADERBOARD_MERGE_WAYS) {
+            return 0;
+        }
+
+        FILE *merged = tmpfile();
+        if (merged == NULL) {
+            Sirtet_setError("Error creating temporary file for sorting\n");
+            return -1;
+        }
+        long n = mergeRuns(
+            levels[level], counts[level], merged, false, rec_sz);
+        closeRuns(levels[level], counts[level]);
+        counts[level] = 0;
+        if (n < 0) {
+            fclose(merged);
+            return -1;
+        }
+        run = merged;
+    }
+
+    fclose(run);
+    Sirtet_setError("Too many scores to sort\n");
+    return -1;
+}
+
+
+// Write a sorted buffer of records out to a new run file
+static FILE* writeRun(char *records, size_t n, size_t rec_sz) {
+
+    FILE *run = tmpfile();
+    if (run == NULL) {
+        Sirtet_setError("Error creating temporary file for sorting\n");
+        return NULL;
+    }
+    if (fwrite(records, rec_sz, n, run) != n) {
+        fclose(run);
+        Sirtet_setError("Error writing temporary file for sorting\n");
+        return NULL;
+    }
+    return run;
+}
+
+
+// Working memory of a Leaderboard_sortFile(...)
+typedef struct {
+    size_t namelen;
+    size_t run_len;         // Most records sorted in memory at once
+    size_t rec_sz;          // Bytes per SortRecord, including name
+    char *line;             // Line buffer, of line_sz chars
+    size_t line_sz;
+    char *records;          // In-memory run, of run_len records
+
+    FILE *levels[MERGE_LEVELS][LEADERBOARD_MERGE_WAYS];
+    int counts[MERGE_LEVELS];
+} SortState;
+
+
+// Sort in to out, leaving any open run files in state for the caller
+static long sortStream(SortState *state, FILE *in, FILE *out) {
+
+    size_t rec_sz = state->rec_sz;
+    Uint64 seq = 0;
+    size_t n_buffered = 0;
+    bool spilled = false;
+
+    /*** Sort input in runs of run_len ***/
+
+    int status;
+    while ((status = readLine(in, state->line, state->line_sz)) > 0) {
+
+        SortRecord *rec = (SortRecord*)(state->records + n_buffered * rec_sz);
+        int parsed = parseLine(
+            state->line, state->namelen, rec->name, &rec->score);
+        if (parsed < 0) {
+            return -1;
+        }
+        if (parsed == 0) {
+            continue;
+        }
+        rec->seq = seq++;
+
+        if (++n_buffered < state->run_len) {
+            continue;
+        }
+
+        qsort(state->records, n_buffered, rec_sz, SortRecord_compare);
+        FILE *run = writeRun(state->records, n_buffered, rec_sz);
+        if (run == NULL) {
+            return -1;
+        }
+        if (pushRun(state->levels, state->counts, run, rec_sz) != 0) {
+            return -1;
+        }
+        n_buffered = 0;
+        spilled = true;
+    }
+
+    if (status < 0) {
+        Sirtet_setError("Error parsing scores: Line too long\n");
+        return -1;
+    }
+
+    qsort(state->records, n_buffered, rec_sz, SortRecord_compare);
+
+    // Everything fit in memory - no merging needed
+    if (!spilled) {
+        for (size_t i = 0; i < n_buffered; i++) {
+            SortRecord *rec = (SortRecord*)(state->records + i * rec_sz);
+            if (fprintf(out, "%s %d\n", rec->name, rec->score) < 0) {
+                Sirtet_setError("Error writing sorted scores\n");
+                return -1;
+            }
+        }
+        return (long)n_buffered;
+    }
+
+    if (n_buffered > 0) {
+        FILE *run = writeRun(state->records, n_buffered, rec_sz);
+        if (run == NULL) {
+            return -1;
+        }
+        if (pushRun(state->levels, state->counts, run, rec_sz) != 0) {
+            return -1;
+        }
+    }
+
+    /*** Merge remaining runs, level by level, into out ***/
+
+    int top = MERGE_LEVELS - 1;
+    while (top > 0 && state->counts[top] == 0) {
+        top--;
+    }
+
+    for (int level = 0; level < top; level++) {
+
+        int count = state->counts[level];
+        if (count == 0) {
+            continue;
+        }
+
+        FILE *merged = tmpfile();
+        if (merged == NULL) {
+            Sirtet_setError("Error creating temporary file for sorting\n");
+            return -1;
+        }
+        long n = mergeRuns(state->levels[level], count, merged, false, rec_sz);
+        closeRuns(state->levels[level], count);
+        state->counts[level] = 0;
+        if (n < 0) {
+            fclose(merged);
+            return -1;
+        }
+
+        // Levels are never left full, so this always fits
+        state->levels[level + 1][state->counts[level + 1]++] = merged;
+    }
+
+    return mergeRuns(
+        state->levels[top], state->counts[top], out, true, rec_sz);
+}
+
+
+long Leaderboard_sortFile(
+    FILE *in, FILE *out, size_t namelen, size_t run_len
+) {
+
+    SortState *state = (SortState*)calloc(1, sizeof(SortState));
+    if (state == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard_sortFile\n");
+        return -1;
+    }
+
+    state->namelen = namelen;
+    state->run_len = run_len > 0 ? run_len : 1;
+
+    // Records stay aligned for their seq when packed back to back
+    size_t rec_sz = sizeof(SortRecord) + namelen + 1;
+    state->rec_sz = (
+        (rec_sz + sizeof(Uint64) - 1) / sizeof(Uint64) * sizeof(Uint64)
+    );
+
+    state->line_sz = namelen + 32;
+    state->line = (char*)malloc(state->line_sz);
+    state->records = (char*)calloc(state->run_len, state->rec_sz);
+
+    long retval = -1;
+    if (state->line == NULL || state->records == NULL) {
+        Sirtet_setError("Error allocating memory for Leaderboard_sortFile\n");
+    }
+    else {
+        retval = sortStream(state, in, out);
+    }
+
+    for (int level = 0; level < MERGE_LEVELS; level++) {
+        closeRuns(state->levels[level], state->counts[level]);
+    }
+    free(state->line);
+    free(state->records);
+    free(state);
+    return retval;
+}
@@ -0,0 +1,96 @@
+/* leaderboard.h
+ *
+ * Unbounded score table, for aggregating scores from many sources. Where a
+ * ScoreList is a small fixed-size array, a Leaderboard is an order-statistics
+ * tree (a treap whose nodes count their subtrees), so adding an entry, the
+ * rank of a score, and the entry at a given rank are all O(log n) however
+ * many entries it holds. A ScoreList can be filled from its top entries.
+ *
+ * Score streams are read in the same "NAME SCORE" line format as hiscores
+ * text files, so they can come from a file or a pipe alike. Streams too
+ * large to hold in memory can be put in order with Leaderboard_sortFile,
+ * which sorts them through temporary files.
+ */
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+
+#include "hiscores.h"
+
+
+// Most sorted runs Leaderboard_sortFile merges at once
+#define LEADERBOARD_MERGE_WAYS 64
+
+
+typedef struct {
+    int score;
+    Uint32 priority;        // Heap order of treap, random
+    Uint32 left;            // Index of higher-ranked subtree, 0 if none
+    Uint32 right;           // Index of lower-ranked subtree, 0 if none
+    Uint32 count;           // Number of entries in subtree rooted here
+} LeaderboardNode;
+
+
+typedef struct {
+    size_t namelen;         // Longest name allowed, in characters
+    size_t len;             // Number of entries
+    size_t capacity;        // Number of entries there is memory for
+
+    Uint32 root;            // Index of root node, 0 if empty
+    Uint32 rng;             // State of priority generator
+
+    LeaderboardNode *nodes; // Entry nodes. nodes[0] is an empty sentinel
+    char *names;            // Entry names, (namelen + 1) chars per node
+} Leaderboard;
+
+
+// Initialize an empty leaderboard for names of up to namelen characters
+Leaderboard* Leaderboard_init(size_t namelen);
+
+// Free a leaderboard and all its entries
+void Leaderboard_deconstruct(Leaderboard *self);
+
+/**
+ * @brief Add an entry to the leaderboard. Entries tied with score stay
+ *        ahead of the new entry
+ * @return Rank (0 for highest) entry was added at, or -1 on error
+ */
+int Leaderboard_add(Leaderboard *self, const char *name, int score);
+
+// Rank a new entry with the given score would be added at
+size_t Leaderboard_rankOf(Leaderboard *self, int score);
+
+// Retrieve the entry at the given rank. Returns 0 on success, -1 if no such
+// rank
+int Leaderboard_get(
+    Leaderboard *self, size_t rank, char *out_name, int *out_score);
+
+// Fill an empty ScoreList with the leaderboard's top entries (as many as
+// fit), in rank order. Returns number of entries copied, or -1 on error
+int Leaderboard_toScoreList(Leaderboard *self, ScoreList *out);
+
+/**
+ * @brief Add every "NAME SCORE" line of a stream to the leaderboard, reading
+ *        until end of stream. Blank lines are skipped
+ * @return Number of entries added, or -1 on a malformed line (entries read
+ *         before it remain added)
+ */
+int Leaderboard_ingest(Leaderboard *self, FILE *f);
+
+/**
+ * @brief Write the "NAME SCORE" lines of a stream to out, sorted in
+ *        descending order by score (ties keep their order in the stream).
+ *        At most run_len entries are held in memory at once; longer
+ *        streams are sorted in runs, spilled to temporary files, and merged
+ * @param in - Stream to read lines from
+ * @param out - Stream to write sorted lines to
+ * @param namelen - Longest name allowed, in characters
+ * @param run_len - Most entries to sort in memory at once
+ * @return Number of entries written, or -1 on error
+ */
+long Leaderboard_sortFile(FILE *in, FILE *out, size_t namelen, size_t run_len);
+
+#endif
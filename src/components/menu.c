@@ -82,9 +82,42 @@ TextMenu* TextMenu_init(
     SirtetAudio_sound move_sound
 ) {
 
-    TextMenu *menu = (TextMenu*)malloc(sizeof(TextMenu));
+    size_t size = TextMenu_requiredBytes(max_options, max_lbl_size);
+    void *mem = malloc(size);
+    if (mem == NULL) {
+        return NULL;
+    }
+
+    return TextMenu_build(mem, size, max_options, max_lbl_size, move_sound);
+}
+
+void TextMenu_deconstruct(TextMenu *self) {
+    Menu_clearLabels(self->menu);
+    free(self);
+}
+
 
-    menu->menu = Menu_init(max_options, move_sound);
+TextMenu* TextMenu_build(
+    void *data, size_t data_size,
+    size_t max_options, size_t max_lbl_size,
+    SirtetAudio_sound move_sound
+) {
+
+    size_t size = TextMenu_requiredBytes(max_options, max_lbl_size);
+    if (data == NULL || data_size < size) {
+        return NULL;
+    }
+    memset(data, 0, size);
+
+    // memory structure:
+    // [] TextMenu struct
+    // [] Menu (see Menu_build)
+    // [] label text
+    size_t menu_size = Menu_requiredBytes(max_options);
+    TextMenu *menu = (TextMenu*)data;
+
+    menu->menu = Menu_build(
+        data + sizeof(TextMenu), menu_size, max_options, move_sound);
     menu->prev_inac_col = (SDL_Color){0, 0, 0, 0};
     menu->prev_active_col = (SDL_Color){0, 0, 0, 0};
 
@@ -92,19 +125,18 @@ TextMenu* TextMenu_init(
     menu->prev_active_font = NULL;
 
     menu->label_w = max_lbl_size;   
-    menu->label_text = (char*)malloc(
-        (1 + max_lbl_size)
-        * max_options
-        * sizeof(char)
-    );
+    menu->label_text = (char*)(data + sizeof(TextMenu) + menu_size);
     return menu;
 }
 
-void TextMenu_deconstruct(TextMenu *self) {
+size_t TextMenu_requiredBytes(size_t max_options, size_t max_lbl_size) {
 
-    Menu_deconstruct(self->menu);
-    free(self->label_text);
-    free(self);
+    size_t size = sizeof(TextMenu);
+
+    size += Menu_requiredBytes(max_options);
+    size += (1 + max_lbl_size) * max_options * sizeof(char);
+
+    return size;
 }
 
 
@@ -190,6 +222,13 @@ int Menu_clearLabel(Menu* self, int index) {
 }
 
 
+void Menu_clearLabels(Menu *self) {
+    for (int i = 0; i < self->num_options; i++) {
+        Menu_clearLabel(self, i);
+    }
+}
+
+
 int Menu_setLabel(Menu *self, int index, SDL_Texture *label) {
     if (index < 0 || index >= self->num_options) {
         return -1;
@@ -412,6 +451,7 @@ int TextMenu_draw(
         }
 
         SDL_Texture *lbl_texture = SDL_CreateTextureFromSurface(rend, lbl_surf);
+        SDL_FreeSurface(lbl_surf);
         if (lbl_texture == NULL) {
             char buff[64];
             snprintf(buff, 64, "Error creating label: %s\n", SDL_GetError());
@@ -77,6 +77,16 @@ TextMenu* TextMenu_init(
 // Free all memory associated with a TextMenu
 void TextMenu_deconstruct(TextMenu* self);
 
+// Set up a TextMenu struct (and its Menu) with a given block of memory
+TextMenu* TextMenu_build(
+    void *data, size_t data_size,
+    size_t max_options, size_t max_lbl_size,
+    SirtetAudio_sound move_sound
+);
+
+// Identify the number of bytes required for a TextMenu struct
+size_t TextMenu_requiredBytes(size_t max_options, size_t max_lbl_size);
+
 
 /******************************************************************************
  * Menu content operations
@@ -93,6 +103,9 @@ int Menu_addOption(Menu *self);
 // Destroy the Label at the given index, setting its pointer to NULL
 int Menu_clearLabel(Menu* self, int index);
 
+// Destroy every option's label
+void Menu_clearLabels(Menu *self);
+
 // Retrieve a pointer to the label texture for a given option
 SDL_Texture* Menu_getLabel(Menu *self, int index);
 
@@ -0,0 +1,197 @@
+#include <SDL2/SDL.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "cell_sprites.h"
+#include "component_drawing.h"
+#include "colorpalette.h"
+#include "coordinates.h"
+#include "sirtet.h"
+
+
+CellSprites* CellSprites_init(size_t max_colors) {
+
+    // memory structure:
+    // [] CellSprites struct
+    // [] colors (color values)
+    // ...
+    size_t nbytes = sizeof(CellSprites) + sizeof(SDL_Color) * max_colors;
+
+    void *mem = malloc(nbytes);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for CellSprites\n");
+        return NULL;
+    }
+    memset(mem, '\0', nbytes);
+
+    CellSprites *retval = (CellSprites*)mem;
+    *retval = (CellSprites){
+        .atlas=NULL,
+        .cell_width=0,
+        .cell_height=0,
+        .alpha_mod=255,
+        .max_colors=max_colors,
+        .n_colors=0,
+        .colors=(SDL_Color*)((char*)mem + sizeof(CellSprites))
+    };
+
+    return retval;
+}
+
+
+void CellSprites_deconstruct(CellSprites *self) {
+    if (self == NULL) {
+        return;
+    }
+    if (self->atlas != NULL) {
+        SDL_DestroyTexture(self->atlas);
+    }
+    free(self);
+}
+
+
+void CellSprites_invalidate(CellSprites *self) {
+    if (self->atlas != NULL) {
+        SDL_DestroyTexture(self->atlas);
+        self->atlas = NULL;
+    }
+    self->n_colors = 0;
+}
+
+
+// Whether the atlas already reflects the given palette & cell size
+static bool CellSprites_isCurrent(
+    CellSprites *self, ColorPalette *palette, int cell_width, int cell_height
+) {
+    return (
+        self->atlas != NULL
+        && self->cell_width == cell_width
+        && self->cell_height == cell_height
+        && self->n_colors == palette->size
+        && memcmp(
+            self->colors, palette->colors, sizeof(SDL_Color) * palette->size
+        ) == 0
+    );
+}
+
+
+int CellSprites_build(
+    CellSprites *self, SDL_Renderer *rend, ColorPalette *palette,
+    int cell_width, int cell_height
+) {
+
+    if (CellSprites_isCurrent(self, palette, cell_width, cell_height)) {
+        return 0;
+    }
+
+    if (palette->size > self->max_colors) {
+        char buff[128];
+        snprintf(
+            buff, 128,
+            "Palette size %lu exceeds CellSprites capacity of %lu\n",
+            (ulong)palette->size, (ulong)self->max_colors
+        );
+        Sirtet_setError(buff);
+        return -1;
+    }
+
+    // Whatever happens below, the old atlas no longer applies
+    if (self->atlas != NULL) {
+        SDL_DestroyTexture(self->atlas);
+        self->atlas = NULL;
+    }
+    self->n_colors = 0;
+
+    if (cell_width <= 0 || cell_height <= 0 || palette->size == 0) {
+        return 0;
+    }
+
+    // Not an error - cells are simply drawn uncached
+    if (!SDL_RenderTargetSupported(rend)) {
+        return 0;
+    }
+
+    SDL_Texture *atlas = SDL_CreateTexture(
+        rend, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+        cell_width * (int)palette->size, cell_height
+    );
+    if (atlas == NULL) {
+        char buff[128];
+        snprintf(
+            buff, 128, "Error creating cell sprite atlas: %s\n", SDL_GetError()
+        );
+        Sirtet_setError(buff);
+        return -1;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+
+    // Render each cell opaque; translucency is applied at copy time
+    SDL_Texture *prev_target = SDL_GetRenderTarget(rend);
+    SDL_BlendMode prev_blend;
+    SDL_GetRenderDrawBlendMode(rend, &prev_blend);
+
+    SDL_SetRenderTarget(rend, atlas);
+    SDL_SetRenderDrawBlendMode(rend, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(rend, 0, 0, 0, 0);
+    SDL_RenderClear(rend);
+
+    for (size_t i = 0; i < palette->size; i++) {
+        SDL_Color col = palette->colors[i];
+        col.a = 255;
+        drawBlockCell(
+            rend, (Point){.x=(int)i * cell_width, .y=0},
+            cell_width, cell_height, col
+        );
+    }
+
+    SDL_SetRenderDrawBlendMode(rend, prev_blend);
+    SDL_SetRenderTarget(rend, prev_target);
+
+    self->atlas = atlas;
+    self->alpha_mod = 255;
+    self->cell_width = cell_width;
+    self->cell_height = cell_height;
+    self->n_colors = palette->size;
+    memcpy(self->colors, palette->colors, sizeof(SDL_Color) * palette->size);
+
+    return 0;
+}
+
+
+int CellSprites_drawCell(
+    CellSprites *self, SDL_Renderer *rend,
+    Point location, int width, int height, SDL_Color color
+) {
+
+    if (
+        self == NULL || self->atlas == NULL
+        || width != self->cell_width || height != self->cell_height
+    ) {
+        return drawBlockCell(rend, location, width, height, color);
+    }
+
+    for (size_t i = 0; i < self->n_colors; i++) {
+        SDL_Color cached = self->colors[i];
+        if (
+            cached.r != color.r || cached.g != color.g || cached.b != color.b
+        ) {
+            continue;
+        }
+
+        if (self->alpha_mod != color.a) {
+            SDL_SetTextureAlphaMod(self->atlas, color.a);
+            self->alpha_mod = color.a;
+        }
+
+        SDL_Rect srcrect = {
+            .x=(int)i * width, .y=0, .w=width, .h=height
+        };
+        SDL_Rect dstrect = {
+            .x=location.x, .y=location.y, .w=width, .h=height
+        };
+        return SDL_RenderCopy(rend, self->atlas, &srcrect, &dstrect);
+    }
+
+    return drawBlockCell(rend, location, width, height, color);
+}
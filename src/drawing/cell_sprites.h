@@ -0,0 +1,68 @@
+/* cell_sprites.h
+*
+* Cache of pre-shaded block cells. Each (palette color, cell size) bevel is
+* rendered once into a texture atlas, so that drawing a cell becomes a single
+* SDL_RenderCopy instead of recomputing shades and filling three rects.
+*/
+
+#ifndef CELL_SPRITES_H
+#define CELL_SPRITES_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "colorpalette.h"
+#include "coordinates.h"
+
+
+typedef struct {
+    SDL_Texture *atlas;     // One pre-shaded cell per color, laid out in a row
+    int cell_width;         // Width, in pixels, of cells in atlas
+    int cell_height;        // Height, in pixels, of cells in atlas
+    Uint8 alpha_mod;        // Alpha modulation currently set on atlas
+
+    size_t max_colors;      // Capacity of colors array
+    size_t n_colors;        // Number of colors currently in atlas
+    SDL_Color *colors;      // Colors of atlas entries, in atlas order
+} CellSprites;
+
+
+// Initialize an empty cache able to hold up to max_colors colors
+CellSprites* CellSprites_init(size_t max_colors);
+
+// Free cache and its atlas texture
+void CellSprites_deconstruct(CellSprites *self);
+
+// Drop the atlas (e.g. after render targets are reset), so that the next
+// build re-renders it
+void CellSprites_invalidate(CellSprites *self);
+
+/**
+ * @brief Ensure the atlas holds every color of palette at the given cell
+ *        size, re-rendering it only if either has changed since last build.
+ *        Falls back to leaving the atlas empty (and drawing uncached) if the
+ *        renderer doesn't support render targets.
+ * @param self - CellSprites pointer to build
+ * @param rend - SDL_Renderer pointer to render atlas with
+ * @param palette - ColorPalette whose colors should be cached
+ * @param cell_width - Width, in pixels, of cells to cache
+ * @param cell_height - Height, in pixels, of cells to cache
+ * @return 0 on success, -1 on error
+ */
+int CellSprites_build(
+    CellSprites *self, SDL_Renderer *rend, ColorPalette *palette,
+    int cell_width, int cell_height
+);
+
+/**
+ * @brief Draw a single cell from the atlas. Alpha of color is applied as
+ *        an alpha modulation of the cached (opaque) cell. Cells not present
+ *        in the cache (different size/color, or NULL self) are drawn
+ *        directly with drawBlockCell.
+ */
+int CellSprites_drawCell(
+    CellSprites *self, SDL_Renderer *rend,
+    Point location, int width, int height, SDL_Color color
+);
+
+#endif
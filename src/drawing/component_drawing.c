@@ -7,6 +7,7 @@
 #include "coordinates.h"
 #include "block.h"
 #include "grid.h"
+#include "cell_sprites.h"
 #include "utilities.h"
 #include "sirtet.h"
 
@@ -76,14 +77,15 @@ int drawBlockCell(
  * @brief - Draw a grid from the given top left coordinate.
  * @param self - GameGrid pointer of grid to draw
  * @param rend - SDL_Renderer pointer used to draw
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
  * @param block_db - Pointer to BlockDb to reference for block cell draw info
  * @param topleft - Top left Point of grid to draw
  * @param cell_width - Width, in pixels, to draw block cells
  * @param cell_height - Height, in pixels, to draw block cells
  */
 int GameGrid_drawGrid(
-    GameGrid *self, SDL_Renderer *rend, BlockDb *block_db,
-    Point topleft, int cell_width, int cell_height
+    GameGrid *self, SDL_Renderer *rend, CellSprites *sprites,
+    BlockDb *block_db, Point topleft, int cell_width, int cell_height
 ) {
 
     for (int row = 0; row < self->height; row++) {
@@ -102,9 +104,8 @@ int GameGrid_drawGrid(
                 .y=topleft.y + row * cell_height
             };
 
-            // drawBlockCell(SDL_Renderer *rend, Point location, int width, int height, SDL_Color base_color)
-            drawBlockCell(
-                rend, cell_topleft, cell_width, cell_height, body_color
+            CellSprites_drawCell(
+                sprites, rend, cell_topleft, cell_width, cell_height, body_color
             );
         }
     }
@@ -115,7 +116,7 @@ int GameGrid_drawGrid(
 
 // Draw a block, passing each relevant metric directly & separately
 void drawBlockContents(
-    SDL_Renderer *rend, 
+    SDL_Renderer *rend, CellSprites *sprites,
     int block_size,
     long block_contents,
     SDL_Color *color, Point *topleft, int cell_width, int cell_height
@@ -134,7 +135,9 @@ void drawBlockContents(
                 .y=topleft->y + row * cell_height
             };
 
-            drawBlockCell(rend, cell_loc, cell_width, cell_height, *color);
+            CellSprites_drawCell(
+                sprites, rend, cell_loc, cell_width, cell_height, *color
+            );
 
         }
     }
@@ -147,6 +150,7 @@ void drawBlockContents(
  * @param self - BlockDb pointer containing block to be drawn
  * @param block_id - Integer block id of block to draw
  * @param rend  - SDL_Renderer pointer to renderer object
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
  * @param topleft - Top left location on window of invisble
  *                  "block grid" -- not necessarily where the 
  *                  block itself begins to be drawn.
@@ -155,7 +159,8 @@ void drawBlockContents(
  */
 int BlockDb_drawBlock(
     BlockDb *self, int block_id,
-    SDL_Renderer *rend, Point topleft, int cell_width, int cell_height
+    SDL_Renderer *rend, CellSprites *sprites,
+    Point topleft, int cell_width, int cell_height
 ) {
 
     SDL_Color base_color = BlockDb_getBlockColor(self, block_id);
@@ -163,7 +168,7 @@ int BlockDb_drawBlock(
     long contents = BlockDb_getBlockContents(self, block_id);
 
     drawBlockContents(
-        rend, block_size, contents, &base_color, &topleft, cell_width, cell_height
+        rend, sprites, block_size, contents, &base_color, &topleft, cell_width, cell_height
     );
     return 0;
 }
@@ -176,6 +181,7 @@ int BlockDb_drawBlock(
  * @param self - BlockDb pointer containing block to be drawn
  * @param block_id - Integer block id of block to draw
  * @param rend  - SDL_Renderer pointer to renderer object
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
  * @param topleft - Top left location of the block's containing
  *                  grid origin point.
  *                  "block grid" -- not necessarily where the 
@@ -185,7 +191,8 @@ int BlockDb_drawBlock(
  */
 int BlockDb_drawBlockOnGrid(
     BlockDb *self, int block_id,
-    SDL_Renderer *rend, Point grid_topleft, int cell_width, int cell_height
+    SDL_Renderer *rend, CellSprites *sprites,
+    Point grid_topleft, int cell_width, int cell_height
 ) {
 
     Point block_pos = BlockDb_getBlockPosition(self, block_id);
@@ -196,7 +203,9 @@ int BlockDb_drawBlockOnGrid(
         .y=grid_topleft.y + cell_height * (block_pos.y - block_size / 2)
     };
 
-    return BlockDb_drawBlock(self, block_id, rend, topleft, cell_width, cell_height);
+    return BlockDb_drawBlock(
+        self, block_id, rend, sprites, topleft, cell_width, cell_height
+    );
 }
 
 
@@ -12,6 +12,7 @@
 #include "grid.h"
 #include "block.h"
 #include "coordinates.h"
+#include "cell_sprites.h"
 
 
 // Draw block cell at indicated location
@@ -22,9 +23,10 @@ int drawBlockCell(
 );
 
 
-// Draw a blocks contents at indicated location
+// Draw a blocks contents at indicated location, copying cells from
+// sprites where cached (sprites may be NULL to draw every cell directly)
 void drawBlockContents(
-    SDL_Renderer *rend, 
+    SDL_Renderer *rend, CellSprites *sprites,
     int block_size,
     long block_contents,
     SDL_Color *color, Point *topleft, int cell_width, int cell_height
@@ -39,6 +41,7 @@ void drawBlockContents(
  * @param self - BlockDb pointer containing block to be drawn
  * @param block_id - Integer block id of block to draw
  * @param rend  - SDL_Renderer pointer to renderer object
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
  * @param topleft - Top left location on window of invisble
  *                  "block grid" -- not necessarily where the 
  *                  block itself begins to be drawn.
@@ -47,7 +50,8 @@ void drawBlockContents(
  */
 int BlockDb_drawBlock(
     BlockDb *self, int block_id,
-    SDL_Renderer *rend, Point topleft, int cell_width, int cell_height
+    SDL_Renderer *rend, CellSprites *sprites,
+    Point topleft, int cell_width, int cell_height
 );
 
 /**
@@ -58,6 +62,7 @@ int BlockDb_drawBlock(
  * @param self - BlockDb pointer containing block to be drawn
  * @param block_id - Integer block id of block to draw
  * @param rend  - SDL_Renderer pointer to renderer object
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
  * @param topleft - Top left location of the block's containing
  *                  grid origin point.
  *                  "block grid" -- not necessarily where the 
@@ -67,7 +72,8 @@ int BlockDb_drawBlock(
  */
 int BlockDb_drawBlockOnGrid(
     BlockDb *self, int block_id,
-    SDL_Renderer *rend, Point grid_topleft, int cell_width, int cell_height
+    SDL_Renderer *rend, CellSprites *sprites,
+    Point grid_topleft, int cell_width, int cell_height
 );
 
 
@@ -75,14 +81,15 @@ int BlockDb_drawBlockOnGrid(
  * @brief - Draw a grid from the given top left coordinate.
  * @param self - GameGrid pointer of grid to draw
  * @param rend - SDL_Renderer pointer used to draw
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
  * @param block_db - Pointer to BlockDb to reference for block cell draw info
  * @param topleft - Top left Point of grid to draw
  * @param cell_width - Width, in pixels, to draw block cells
  * @param cell_height - Height, in pixels, to draw block cells
  */
 int GameGrid_drawGrid(
-    GameGrid *self, SDL_Renderer *rend, BlockDb *block_db,
-    Point topleft, int cell_width, int cell_height
+    GameGrid *self, SDL_Renderer *rend, CellSprites *sprites,
+    BlockDb *block_db, Point topleft, int cell_width, int cell_height
 );
 
 #endif
@@ -0,0 +1,139 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "glyph_atlas.h"
+#include "sirtet.h"
+
+
+GlyphAtlas* GlyphAtlas_init(SDL_Renderer *rend, TTF_Font *font) {
+
+    GlyphAtlas *retval = (GlyphAtlas*)malloc(sizeof(GlyphAtlas));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for GlyphAtlas\n");
+        return NULL;
+    }
+
+    char glyphs[GLYPH_COUNT + 1];
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        glyphs[i] = (char)(GLYPH_FIRST + i);
+    }
+    glyphs[GLYPH_COUNT] = '\0';
+
+    SDL_Surface *surf = TTF_RenderText_Solid(
+        font, glyphs, (SDL_Color){255, 255, 255, 255}
+    );
+    if (surf == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ,
+            "Error rendering GlyphAtlas text: %s\n", TTF_GetError()
+        );
+        Sirtet_setError(buff);
+        free(retval);
+        return NULL;
+    }
+
+    // Each glyph starts where the text before it ends, so glyphs drawn
+    // side-by-side keep the font's own spacing
+    retval->offsets[0] = 0;
+    for (int i = 1; i <= GLYPH_COUNT; i++) {
+        char held = glyphs[i];
+        glyphs[i] = '\0';
+
+        int width = 0;
+        TTF_SizeText(font, glyphs, &width, NULL);
+        retval->offsets[i] = width < surf->w ? width : surf->w;
+
+        glyphs[i] = held;
+    }
+    retval->offsets[GLYPH_COUNT] = surf->w;
+    retval->height = surf->h;
+
+    retval->texture = SDL_CreateTextureFromSurface(rend, surf);
+    SDL_FreeSurface(surf);
+    if (retval->texture == NULL) {
+        char buff[ERRMSG_SZ];
+        snprintf(
+            buff, ERRMSG_SZ,
+            "Error creating GlyphAtlas texture: %s\n", SDL_GetError()
+        );
+        Sirtet_setError(buff);
+        free(retval);
+        return NULL;
+    }
+
+    return retval;
+}
+
+
+void GlyphAtlas_deconstruct(GlyphAtlas *self) {
+    if (self == NULL) {
+        return;
+    }
+    if (self->texture != NULL) {
+        SDL_DestroyTexture(self->texture);
+    }
+    free(self);
+}
+
+
+// Index into offsets of character c
+static int GlyphAtlas_index(char c) {
+    if (c < GLYPH_FIRST || c > GLYPH_LAST) {
+        c = '?';
+    }
+    return c - GLYPH_FIRST;
+}
+
+
+SDL_Point GlyphAtlas_measure(GlyphAtlas *self, const char *text) {
+
+    int width = 0;
+    for (const char *c = text; *c != '\0'; c++) {
+        int i = GlyphAtlas_index(*c);
+        width += self->offsets[i + 1] - self->offsets[i];
+    }
+    return (SDL_Point){width, self->height};
+}
+
+
+int GlyphAtlas_draw(
+    GlyphAtlas *self, SDL_Renderer *rend, const char *text,
+    SDL_Color color, const SDL_Rect *dest
+) {
+
+    SDL_Point size = GlyphAtlas_measure(self, text);
+    if (size.x == 0 || dest->w <= 0 || dest->h <= 0) {
+        return 0;
+    }
+
+    SDL_SetTextureColorMod(self->texture, color.r, color.g, color.b);
+
+    // Scale pen position rather than each glyph width, so rounding never
+    // opens gaps between glyphs
+    int pen = 0;
+    for (const char *c = text; *c != '\0'; c++) {
+        int i = GlyphAtlas_index(*c);
+        int glyph_w = self->offsets[i + 1] - self->offsets[i];
+
+        int left = dest->x + pen * dest->w / size.x;
+        int right = dest->x + (pen + glyph_w) * dest->w / size.x;
+        pen += glyph_w;
+
+        SDL_Rect src = {self->offsets[i], 0, glyph_w, self->height};
+        SDL_Rect dst = {left, dest->y, right - left, dest->h};
+        if (SDL_RenderCopy(rend, self->texture, &src, &dst) != 0) {
+            char buff[ERRMSG_SZ];
+            snprintf(
+                buff, ERRMSG_SZ,
+                "Error drawing from GlyphAtlas: %s\n", SDL_GetError()
+            );
+            Sirtet_setError(buff);
+            return -1;
+        }
+    }
+
+    return 0;
+}
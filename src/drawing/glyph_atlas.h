@@ -0,0 +1,55 @@
+/* glyph_atlas.h
+*
+* Pre-rendered printable ASCII for a single font. Every glyph is rendered
+* once into a texture, so text that changes from frame to frame (scores,
+* fps counters, ...) is drawn as one SDL_RenderCopy per character instead of
+* rendering a new surface & texture each time it changes.
+*/
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+
+
+typedef struct {
+    SDL_Texture *texture;           // Every glyph, in order, rendered white
+    int height;                     // Height, in pixels, of texture
+
+    // x position of each glyph in texture, followed by the texture's width
+    int offsets[GLYPH_COUNT + 1];
+} GlyphAtlas;
+
+
+// Render every printable glyph of font into a new atlas
+GlyphAtlas* GlyphAtlas_init(SDL_Renderer *rend, TTF_Font *font);
+
+// Free atlas and its texture
+void GlyphAtlas_deconstruct(GlyphAtlas *self);
+
+// Size, in pixels, text would be drawn at without scaling
+SDL_Point GlyphAtlas_measure(GlyphAtlas *self, const char *text);
+
+/**
+ * @brief Draw text, stretched to fill dest (as an SDL_RenderCopy of the
+ *        equivalent rendered label would be). Characters outside of the
+ *        atlas are drawn as '?'
+ * @param self - GlyphAtlas pointer to draw from
+ * @param rend - SDL_Renderer pointer to draw with
+ * @param text - Text to draw
+ * @param color - Color to draw text in
+ * @param dest - Area to draw text to
+ * @return 0 on success, -1 on error
+ */
+int GlyphAtlas_draw(
+    GlyphAtlas *self, SDL_Renderer *rend, const char *text,
+    SDL_Color color, const SDL_Rect *dest
+);
+
+#endif
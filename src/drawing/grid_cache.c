@@ -0,0 +1,183 @@
+#include <SDL2/SDL.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "grid_cache.h"
+#include "cell_sprites.h"
+#include "render_snapshot.h"
+#include "sirtet.h"
+
+
+GridCache* GridCache_init() {
+
+    GridCache *retval = (GridCache*)malloc(sizeof(GridCache));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for GridCache\n");
+        return NULL;
+    }
+
+    *retval = (GridCache){
+        .texture=NULL,
+        .cell_width=0,
+        .cell_height=0,
+        .cols=0,
+        .rows=0,
+        .drawn_tick=0
+    };
+    return retval;
+}
+
+
+void GridCache_deconstruct(GridCache *self) {
+    if (self == NULL) {
+        return;
+    }
+    if (self->texture != NULL) {
+        SDL_DestroyTexture(self->texture);
+    }
+    free(self);
+}
+
+
+void GridCache_invalidate(GridCache *self) {
+    if (self->texture != NULL) {
+        SDL_DestroyTexture(self->texture);
+        self->texture = NULL;
+    }
+    self->drawn_tick = 0;
+}
+
+
+// (Re)create texture for current grid & cell dimensions, if needed.
+// Returns 1 if a new texture was created, 0 if existing one is fine, -1 on error
+static int GridCache_fit(
+    GridCache *self, const RenderSnapshot *snapshot, SDL_Renderer *rend,
+    int cell_width, int cell_height
+) {
+    if (
+        self->texture != NULL
+        && self->cell_width == cell_width && self->cell_height == cell_height
+        && self->cols == snapshot->width && self->rows == snapshot->height
+    ) {
+        return 0;
+    }
+
+    GridCache_invalidate(self);
+
+    self->texture = SDL_CreateTexture(
+        rend, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+        cell_width * snapshot->width, cell_height * snapshot->height
+    );
+    if (self->texture == NULL) {
+        char buff[128];
+        snprintf(
+            buff, 128, "Error creating grid cache texture: %s\n", SDL_GetError()
+        );
+        Sirtet_setError(buff);
+        return -1;
+    }
+    SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+
+    self->cell_width = cell_width;
+    self->cell_height = cell_height;
+    self->cols = snapshot->width;
+    self->rows = snapshot->height;
+    return 1;
+}
+
+
+// Draw one row of a snapshot's cells, with the row's top left at topleft
+static void GridCache_drawRow(
+    const RenderSnapshot *snapshot, int row, SDL_Renderer *rend,
+    CellSprites *sprites, Point topleft, int cell_width, int cell_height
+) {
+    const SDL_Color *cells = snapshot->cells + row * snapshot->width;
+
+    for (int col = 0; col < snapshot->width; col++) {
+        if (cells[col].a == 0) {
+            continue;
+        }
+
+        Point cell_topleft = {
+            .x=topleft.x + col * cell_width,
+            .y=topleft.y
+        };
+        CellSprites_drawCell(
+            sprites, rend, cell_topleft, cell_width, cell_height, cells[col]
+        );
+    }
+}
+
+
+int GridCache_draw(
+    GridCache *self, const RenderSnapshot *snapshot, SDL_Renderer *rend,
+    CellSprites *sprites, Point topleft, int cell_width, int cell_height
+) {
+
+    if (cell_width <= 0 || cell_height <= 0) {
+        return 0;
+    }
+
+    if (!SDL_RenderTargetSupported(rend)) {
+        for (int row = 0; row < snapshot->height; row++) {
+            Point row_topleft = {
+                .x=topleft.x,
+                .y=topleft.y + row * cell_height
+            };
+            GridCache_drawRow(
+                snapshot, row, rend, sprites, row_topleft,
+                cell_width, cell_height
+            );
+        }
+        return 0;
+    }
+
+    int fit = GridCache_fit(self, snapshot, rend, cell_width, cell_height);
+    if (fit < 0) {
+        return -1;
+    }
+    if (fit == 1) {
+        self->drawn_tick = 0;
+    }
+
+    if (snapshot->tick != self->drawn_tick) {
+
+        SDL_Texture *prev_target = SDL_GetRenderTarget(rend);
+        SDL_BlendMode prev_blend;
+        SDL_GetRenderDrawBlendMode(rend, &prev_blend);
+        SDL_SetRenderTarget(rend, self->texture);
+
+        for (int row = 0; row < snapshot->height; row++) {
+
+            // Row unchanged since the snapshot already in the texture
+            if (self->drawn_tick != 0
+                && snapshot->row_ticks[row] <= self->drawn_tick) {
+                continue;
+            }
+
+            // Wipe row back to fully transparent
+            SDL_Rect row_rect = {
+                .x=0, .y=row * cell_height,
+                .w=snapshot->width * cell_width, .h=cell_height
+            };
+            SDL_SetRenderDrawBlendMode(rend, SDL_BLENDMODE_NONE);
+            SDL_SetRenderDrawColor(rend, 0, 0, 0, 0);
+            SDL_RenderFillRect(rend, &row_rect);
+            SDL_SetRenderDrawBlendMode(rend, prev_blend);
+
+            GridCache_drawRow(
+                snapshot, row, rend, sprites,
+                (Point){.x=0, .y=row * cell_height}, cell_width, cell_height
+            );
+        }
+
+        SDL_SetRenderTarget(rend, prev_target);
+        self->drawn_tick = snapshot->tick;
+    }
+
+    SDL_Rect dstrect = {
+        .x=topleft.x, .y=topleft.y,
+        .w=snapshot->width * cell_width, .h=snapshot->height * cell_height
+    };
+    return SDL_RenderCopy(rend, self->texture, NULL, &dstrect);
+}
@@ -0,0 +1,57 @@
+/* grid_cache.h
+*
+* Presentation cache for the committed cells of a grid, as captured in
+* RenderSnapshots. Cells are rendered into a render-target texture, and only
+* rows that changed after the last snapshot drawn are redrawn, so
+* steady-state frames composite a single texture.
+*/
+
+#ifndef GRID_CACHE_H
+#define GRID_CACHE_H
+
+#include <SDL2/SDL.h>
+
+#include "coordinates.h"
+#include "cell_sprites.h"
+#include "render_snapshot.h"
+
+
+typedef struct {
+    SDL_Texture *texture;   // Render target holding committed cells
+    int cell_width;         // Width, in pixels, of cells in texture
+    int cell_height;        // Height, in pixels, of cells in texture
+    int cols;               // Grid width the texture was sized for
+    int rows;               // Grid height the texture was sized for
+    Uint64 drawn_tick;      // Tick of snapshot texture is up to date with
+} GridCache;
+
+
+// Initialize an empty cache. Texture is created on first draw
+GridCache* GridCache_init();
+
+// Free cache and its texture
+void GridCache_deconstruct(GridCache *self);
+
+// Drop cached contents (e.g. after render targets are reset)
+void GridCache_invalidate(GridCache *self);
+
+/**
+ * @brief - Draw a snapshot's grid cells from the given top left coordinate,
+ *          first redrawing any rows changed since the last snapshot drawn.
+ *          Draws directly (uncached) if the renderer doesn't support render
+ *          targets.
+ * @param self - GridCache pointer to draw through
+ * @param snapshot - RenderSnapshot pointer of grid cells to draw
+ * @param rend - SDL_Renderer pointer used to draw
+ * @param sprites - CellSprites cache to draw cells from (may be NULL)
+ * @param topleft - Top left Point of grid to draw
+ * @param cell_width - Width, in pixels, to draw block cells
+ * @param cell_height - Height, in pixels, to draw block cells
+ * @return 0 on success, -1 on error
+ */
+int GridCache_draw(
+    GridCache *self, const RenderSnapshot *snapshot, SDL_Renderer *rend,
+    CellSprites *sprites, Point topleft, int cell_width, int cell_height
+);
+
+#endif
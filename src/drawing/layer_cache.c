@@ -0,0 +1,116 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "layer_cache.h"
+#include "sirtet.h"
+
+
+LayerCache* LayerCache_init() {
+
+    LayerCache *retval = (LayerCache*)malloc(sizeof(LayerCache));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for LayerCache\n");
+        return NULL;
+    }
+
+    *retval = (LayerCache){
+        .texture=NULL,
+        .width=0,
+        .height=0,
+        .capturing=false,
+        .direct=false
+    };
+    return retval;
+}
+
+
+void LayerCache_deconstruct(LayerCache *self) {
+    if (self == NULL) {
+        return;
+    }
+    if (self->texture != NULL) {
+        SDL_DestroyTexture(self->texture);
+    }
+    free(self);
+}
+
+
+void LayerCache_invalidate(LayerCache *self) {
+    if (self->texture != NULL) {
+        SDL_DestroyTexture(self->texture);
+        self->texture = NULL;
+    }
+    self->width = 0;
+    self->height = 0;
+}
+
+
+bool LayerCache_begin(LayerCache *self, SDL_Renderer *rend, bool stale) {
+
+    self->capturing = false;
+    self->direct = true;
+
+    if (!SDL_RenderTargetSupported(rend)) {
+        return true;
+    }
+
+    int width, height;
+    if (SDL_GetRendererOutputSize(rend, &width, &height) != 0) {
+        return true;
+    }
+
+    if (
+        self->texture == NULL
+        || self->width != width || self->height != height
+    ) {
+        if (self->texture != NULL) {
+            SDL_DestroyTexture(self->texture);
+        }
+        self->texture = SDL_CreateTexture(
+            rend, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+            width, height
+        );
+        if (self->texture == NULL) {
+            // Fall back to drawing directly
+            return true;
+        }
+        SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_NONE);
+        self->width = width;
+        self->height = height;
+        stale = true;
+    }
+
+    self->direct = false;
+    if (!stale) {
+        return false;
+    }
+
+    SDL_SetRenderTarget(rend, self->texture);
+    self->capturing = true;
+    return true;
+}
+
+
+int LayerCache_end(LayerCache *self, SDL_Renderer *rend) {
+
+    if (self->direct) {
+        return 0;
+    }
+
+    if (self->capturing) {
+        SDL_SetRenderTarget(rend, NULL);
+        self->capturing = false;
+    }
+
+    if (SDL_RenderCopy(rend, self->texture, NULL, NULL) != 0) {
+        char buff[128];
+        snprintf(
+            buff, 128, "Error drawing cached layer: %s\n", SDL_GetError()
+        );
+        Sirtet_setError(buff);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+/* layer_cache.h
+*
+* Cached rendering of the layer beneath an overlay state. While an overlay
+* is on top of the StateRunner, the state below it does not change, so it is
+* rendered once into a render-target texture and each overlay frame only
+* composites that texture before drawing itself.
+*/
+
+#ifndef LAYER_CACHE_H
+#define LAYER_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+
+typedef struct {
+    SDL_Texture *texture;   // Render target holding the cached layer
+    int width;              // Width, in pixels, of texture
+    int height;             // Height, in pixels, of texture
+    bool capturing;         // Whether draws are currently redirected
+    bool direct;            // Whether layer is being drawn without the cache
+} LayerCache;
+
+
+// Initialize an empty cache. Texture is created on first capture
+LayerCache* LayerCache_init();
+
+// Free cache and its texture
+void LayerCache_deconstruct(LayerCache *self);
+
+// Drop the cached layer (e.g. after render targets are reset), so that it is
+// recaptured on next begin
+void LayerCache_invalidate(LayerCache *self);
+
+/**
+ * @brief - Start drawing a layer. If the cached layer is stale (or doesn't
+ *          match the renderer's size) draws are redirected into the cache
+ *          until LayerCache_end(...), and the layer must be redrawn.
+ *          If the renderer doesn't support render targets, the layer must
+ *          always be redrawn, directly.
+ * @param self - LayerCache pointer to draw through
+ * @param rend - SDL_Renderer pointer used to draw
+ * @param stale - Whether the layer has changed since last captured
+ * @return true if the caller must draw the layer now, false if cached
+ */
+bool LayerCache_begin(LayerCache *self, SDL_Renderer *rend, bool stale);
+
+// Finish drawing a layer, restoring the render target and copying the
+// cached layer to it. Returns 0 on success, -1 on error
+int LayerCache_end(LayerCache *self, SDL_Renderer *rend);
+
+#endif
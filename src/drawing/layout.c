@@ -0,0 +1,59 @@
+#include <SDL2/SDL.h>
+
+#include "layout.h"
+#include "sirtet.h"
+
+
+void Layout_init(Layout *self) {
+    *self = (Layout){
+        .generation=0,
+        .dpi=-1,
+        .window={0, 0, -1, -1}
+    };
+}
+
+
+int Layout_update(Layout *self, SDL_Window *wind) {
+
+    int wind_w, wind_h;
+    SDL_GetWindowSize(wind, &wind_w, &wind_h);
+
+    float dpi = 0;
+    int display = SDL_GetWindowDisplayIndex(wind);
+    if (display < 0 || SDL_GetDisplayDPI(display, &dpi, NULL, NULL) != 0) {
+        dpi = 0;
+    }
+
+    if (
+        wind_w == self->window.w && wind_h == self->window.h
+        && dpi == self->dpi
+    ) {
+        return 0;
+    }
+
+    self->generation++;
+    self->dpi = dpi;
+    self->window = (SDL_Rect){.x=0, .y=0, .w=wind_w, .h=wind_h};
+
+
+    /*** Game state ***/
+
+    int area_w = (GAMEAREA_WEIGHT_W * wind_w) / TOTAL_WEIGHT_W;
+    int area_h = wind_h - (2 * BORDER_SIZE);
+
+    self->game_area = (SDL_Rect){
+        .x=(wind_w - area_w) / 2,
+        .y=(wind_h - area_h) / 2,
+        .w=area_w,
+        .h=area_h
+    };
+
+    self->sidebar_area = (SDL_Rect){
+        .x=(GAMEAREA_WEIGHT_W * wind_w) / TOTAL_WEIGHT_W,
+        .y=self->game_area.y,
+        .w=(SIDEBAR_WEIGHT_W * (wind_w - 2 * BORDER_SIZE)) / TOTAL_WEIGHT_W,
+        .h=self->game_area.h
+    };
+
+    return 1;
+}
@@ -0,0 +1,43 @@
+/* layout.h
+*
+* Window-dependent layout rectangles, computed once per window size/DPI
+* change rather than on every frame. Draw functions read from the cached
+* Layout, and may cache their own derived dimensions keyed on its
+* generation counter.
+*/
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+
+typedef struct {
+
+    unsigned int generation;    // Incremented each time layout is recomputed
+    float dpi;                  // Diagonal DPI of window's display, 0 if unknown
+
+    SDL_Rect window;            // Full window area
+
+    /* Game state */
+    SDL_Rect game_area;         // Area requested for the game grid
+    SDL_Rect sidebar_area;      // Area requested for game sidebar. Vertical
+                                // position & height follow the grid's fit
+
+} Layout;
+
+
+// Set a Layout to an empty state, that any window will update
+void Layout_init(Layout *self);
+
+/**
+ * @brief Recompute layout for a window, if its size or display DPI has
+ *        changed since last computed.
+ * @param self - Layout pointer to update
+ * @param wind - SDL_Window pointer to lay out
+ * @return 1 if layout was recomputed, 0 if unchanged
+ */
+int Layout_update(Layout *self, SDL_Window *wind);
+
+#endif
@@ -0,0 +1,154 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render_snapshot.h"
+#include "sirtet.h"
+
+
+// Slot indices fit in the low bits of latest; the next bit flags it as fresh
+#define SNAPSHOT_IDX_MASK 0x3
+#define SNAPSHOT_FRESH 0x4
+
+
+SnapshotBuffer* SnapshotBuffer_init(int width, int height) {
+
+    if (width <= 0 || height <= 0) {
+        Sirtet_setError("SnapshotBuffer dimensions must be positive\n");
+        return NULL;
+    }
+
+    size_t nbytes = SnapshotBuffer_requiredBytes(width, height);
+    void *mem = malloc(nbytes);
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for SnapshotBuffer\n");
+        return NULL;
+    }
+    return SnapshotBuffer_build(mem, nbytes, width, height);
+}
+
+
+size_t SnapshotBuffer_requiredBytes(int width, int height) {
+    // memory structure:
+    // [] SnapshotBuffer struct
+    // [] row ticks (producer's, then per slot)
+    // [] cells (per slot)
+    return (
+        sizeof(SnapshotBuffer)
+        + (SNAPSHOT_SLOTS + 1) * height * sizeof(Uint64)
+        + SNAPSHOT_SLOTS * (size_t)width * height * sizeof(SDL_Color)
+    );
+}
+
+
+SnapshotBuffer* SnapshotBuffer_build(
+    void *data, size_t data_size, int width, int height
+) {
+
+    if (width <= 0 || height <= 0) {
+        Sirtet_setError("SnapshotBuffer dimensions must be positive\n");
+        return NULL;
+    }
+
+    size_t nbytes = SnapshotBuffer_requiredBytes(width, height);
+    if (data == NULL || data_size < nbytes) {
+        Sirtet_setError("Insufficient memory to build SnapshotBuffer\n");
+        return NULL;
+    }
+
+    size_t n_cells = (size_t)width * height;
+    void *mem = data;
+    memset(mem, 0, nbytes);
+
+    SnapshotBuffer *retval = (SnapshotBuffer*)mem;
+    Uint64 *row_ticks = (Uint64*)((char*)mem + sizeof(SnapshotBuffer));
+    SDL_Color *cells = (SDL_Color*)(row_ticks + (SNAPSHOT_SLOTS + 1) * height);
+
+    retval->row_ticks = row_ticks;
+    for (int i = 0; i < SNAPSHOT_SLOTS; i++) {
+        retval->slots[i] = (RenderSnapshot){
+            .tick=0,
+            .width=width,
+            .height=height,
+            .cells=cells + i * n_cells,
+            .row_ticks=row_ticks + (i + 1) * height
+        };
+    }
+
+    // Every row starts out changed as of the first publish
+    for (int row = 0; row < height; row++) {
+        retval->row_ticks[row] = 1;
+    }
+
+    // Slot 2 starts as the (empty, already taken) latest
+    SDL_AtomicSet(&retval->latest, 2);
+    retval->write_idx = 0;
+    retval->read_idx = 1;
+    retval->n_published = 0;
+
+    return retval;
+}
+
+
+void SnapshotBuffer_deconstruct(SnapshotBuffer *self) {
+    free(self);
+}
+
+
+RenderSnapshot* SnapshotBuffer_writeSlot(SnapshotBuffer *self) {
+    return &self->slots[self->write_idx];
+}
+
+
+void SnapshotBuffer_markRowChanged(SnapshotBuffer *self, int row) {
+    if (row < 0 || row >= self->slots[0].height) {
+        return;
+    }
+    self->row_ticks[row] = self->n_published + 1;
+}
+
+
+// A slot is written at most every third publish, so rows that have not
+// changed since it was last written need not be copied again
+bool SnapshotBuffer_isRowStale(SnapshotBuffer *self, int row) {
+    if (row < 0 || row >= self->slots[0].height) {
+        return false;
+    }
+    return self->slots[self->write_idx].row_ticks[row] != self->row_ticks[row];
+}
+
+
+void SnapshotBuffer_publish(SnapshotBuffer *self) {
+
+    RenderSnapshot *slot = &self->slots[self->write_idx];
+
+    self->n_published++;
+    slot->tick = self->n_published;
+    memcpy(slot->row_ticks, self->row_ticks, slot->height * sizeof(Uint64));
+
+    // Slot contents must be visible before the slot is
+    SDL_MemoryBarrierRelease();
+
+    // Swap filled slot in as latest, taking back whichever slot it replaces
+    int prev = SDL_AtomicSet(
+        &self->latest, self->write_idx | SNAPSHOT_FRESH
+    );
+    self->write_idx = prev & SNAPSHOT_IDX_MASK;
+}
+
+
+const RenderSnapshot* SnapshotBuffer_acquire(SnapshotBuffer *self) {
+
+    if ((SDL_AtomicGet(&self->latest) & SNAPSHOT_FRESH) != 0) {
+        int prev = SDL_AtomicSet(&self->latest, self->read_idx);
+        self->read_idx = prev & SNAPSHOT_IDX_MASK;
+        SDL_MemoryBarrierAcquire();
+    }
+
+    const RenderSnapshot *snapshot = &self->slots[self->read_idx];
+    if (snapshot->tick == 0) {
+        return NULL;
+    }
+    return snapshot;
+}
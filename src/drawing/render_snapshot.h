@@ -0,0 +1,96 @@
+/* render_snapshot.h
+*
+* Immutable per-tick copies of everything the game screen draws, handed from
+* simulation to drawing through a lock-free triple buffer. The simulation
+* fills a free slot and publishes it at the end of each tick; drawing
+* acquires the newest published slot, never reading live game state.
+* Neither side waits on the other, whichever threads they run on.
+*/
+
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "coordinates.h"
+
+
+// A block, as drawn
+typedef struct {
+    bool valid;             // False if there's no block to draw
+    int size;               // Block size (width & height, in cells)
+    long contents;          // Block content mask
+    Point position;         // Grid position of block's center
+    SDL_Color color;
+    int drop_distance;      // Distance down to where block would land
+} SnapshotBlock;
+
+
+typedef struct {
+    Uint64 tick;            // Simulation tick snapshot was taken at
+
+    int width;              // Grid width, in cells
+    int height;             // Grid height, in cells
+    SDL_Color *cells;       // Visible committed cell colors, row-major.
+                            // Alpha of 0 marks an empty (or removed) cell
+    Uint64 *row_ticks;      // Per row, tick at which its cells last changed
+
+    SnapshotBlock active;   // Block in play (with its drop projection)
+    SnapshotBlock next;     // Queued block
+
+    int score;
+    int level;
+} RenderSnapshot;
+
+
+#define SNAPSHOT_SLOTS 3
+
+typedef struct {
+    RenderSnapshot slots[SNAPSHOT_SLOTS];
+
+    // Index of the most recently published slot, with SNAPSHOT_FRESH set if
+    // the consumer has not yet taken it
+    SDL_atomic_t latest;
+
+    int write_idx;          // Slot being filled. Owned by producer
+    int read_idx;           // Slot being drawn. Owned by consumer
+
+    /* Owned by producer */
+    Uint64 n_published;     // Total snapshots published
+    Uint64 *row_ticks;      // Per row, tick at which its cells last changed
+} SnapshotBuffer;
+
+
+// Initialize triple buffer of snapshots for a grid of width x height cells
+SnapshotBuffer* SnapshotBuffer_init(int width, int height);
+
+void SnapshotBuffer_deconstruct(SnapshotBuffer *self);
+
+// Number of bytes needed to build a SnapshotBuffer for a width x height grid
+size_t SnapshotBuffer_requiredBytes(int width, int height);
+
+// Build a SnapshotBuffer within a provided block of memory, of at least
+// SnapshotBuffer_requiredBytes(...) bytes. Returns NULL if it doesn't fit
+SnapshotBuffer* SnapshotBuffer_build(
+    void *data, size_t data_size, int width, int height
+);
+
+// Producer: slot to fill for next publish. Its previous contents are stale
+RenderSnapshot* SnapshotBuffer_writeSlot(SnapshotBuffer *self);
+
+// Producer: flag a grid row as changed as of the next publish
+void SnapshotBuffer_markRowChanged(SnapshotBuffer *self, int row);
+
+// Producer: identify if the write slot's copy of a row is out of date, and
+// must be re-copied before publishing
+bool SnapshotBuffer_isRowStale(SnapshotBuffer *self, int row);
+
+// Producer: publish the filled write slot as the newest snapshot
+void SnapshotBuffer_publish(SnapshotBuffer *self);
+
+// Consumer: newest published snapshot, or NULL if none has been published.
+// Remains valid (and unchanged) until the next acquire
+const RenderSnapshot* SnapshotBuffer_acquire(SnapshotBuffer *self);
+
+#endif
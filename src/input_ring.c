@@ -0,0 +1,110 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "input_ring.h"
+#include "sirtet.h"
+
+
+InputRing* InputRing_init(int capacity) {
+
+    if (capacity <= 0) {
+        Sirtet_setError("InputRing capacity must be positive\n");
+        return NULL;
+    }
+
+    Uint32 actual = 1;
+    while (actual < (Uint32)capacity) {
+        actual <<= 1;
+    }
+
+    // memory structure:
+    // [] InputRing struct
+    // [] events
+    void *mem = malloc(sizeof(InputRing) + actual * sizeof(InputRingEvent));
+    if (mem == NULL) {
+        Sirtet_setError("Error allocating memory for InputRing\n");
+        return NULL;
+    }
+
+    InputRing *retval = (InputRing*)mem;
+    SDL_AtomicSet(&retval->head, 0);
+    SDL_AtomicSet(&retval->tail, 0);
+    SDL_AtomicSet(&retval->dropped, 0);
+    retval->mask = actual - 1;
+    retval->events = (InputRingEvent*)((char*)mem + sizeof(InputRing));
+
+    return retval;
+}
+
+
+void InputRing_deconstruct(InputRing *self) {
+    free(self);
+}
+
+
+// Counters only ever increase, wrapping; their difference is the fill level
+bool InputRing_push(InputRing *self, const InputRingEvent *event) {
+
+    Uint32 head = (Uint32)SDL_AtomicGet(&self->head);
+    Uint32 tail = (Uint32)SDL_AtomicGet(&self->tail);
+
+    if (head - tail > self->mask) {
+        SDL_AtomicAdd(&self->dropped, 1);
+        return false;
+    }
+
+    self->events[head & self->mask] = *event;
+
+    // Event must be visible before the consumer can see it was published
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&self->head, (int)(head + 1));
+    return true;
+}
+
+
+bool InputRing_pop(InputRing *self, InputRingEvent *out) {
+
+    Uint32 tail = (Uint32)SDL_AtomicGet(&self->tail);
+    Uint32 head = (Uint32)SDL_AtomicGet(&self->head);
+
+    if (head == tail) {
+        return false;
+    }
+
+    SDL_MemoryBarrierAcquire();
+    *out = self->events[tail & self->mask];
+
+    // Slot must be read before the producer can see it was freed
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&self->tail, (int)(tail + 1));
+    return true;
+}
+
+
+// SDL event watch, called as each event is added to SDL's queue
+static int InputRing_watch(void *userdata, SDL_Event *event) {
+
+    if (event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) {
+        return 1;
+    }
+
+    InputRingEvent ring_event = {
+        .type=event->type,
+        .scancode=event->key.keysym.scancode,
+        .timestamp=event->key.timestamp,
+        .repeat=event->key.repeat
+    };
+    InputRing_push((InputRing*)userdata, &ring_event);
+    return 1;
+}
+
+
+void InputRing_attach(InputRing *self) {
+    SDL_AddEventWatch(InputRing_watch, (void*)self);
+}
+
+
+void InputRing_detach(InputRing *self) {
+    SDL_DelEventWatch(InputRing_watch, (void*)self);
+}
@@ -0,0 +1,58 @@
+/* input_ring.h
+*
+* Single-producer/single-consumer lock-free ring of timestamped key events.
+* When attached, an SDL event watch pushes every key event into the ring as
+* soon as SDL pumps it from the OS - including pumps made while the main loop
+* idles out the remainder of a frame - and InputTracker drains it when
+* processing hardware inputs.
+*
+* NOTE: SDL requires events to be pumped on the thread that created the
+* window, so the producer is whatever pumps events (the main loop's idle
+* time, rather than a separate polling thread). The ring itself only relies
+* on atomics, and is safe with its producer and consumer on separate threads.
+*/
+
+#ifndef INPUT_RING_H
+#define INPUT_RING_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+
+typedef struct {
+    Uint32 type;            // SDL_KEYDOWN or SDL_KEYUP
+    SDL_Scancode scancode;
+    Uint32 timestamp;       // SDL event timestamp, in ms
+    Uint8 repeat;           // Non-zero for OS key repeats
+} InputRingEvent;
+
+
+typedef struct {
+    SDL_atomic_t head;      // Total events pushed. Written only by producer
+    SDL_atomic_t tail;      // Total events popped. Written only by consumer
+    SDL_atomic_t dropped;   // Events dropped while ring was full
+
+    Uint32 mask;            // Capacity - 1 (capacity is a power of two)
+    InputRingEvent *events;
+} InputRing;
+
+
+// Initialize a ring holding at least capacity events
+InputRing* InputRing_init(int capacity);
+
+// Free ring. Must be detached first, if attached
+void InputRing_deconstruct(InputRing *self);
+
+// Push an event (producer side). Returns false, dropping it, if ring is full
+bool InputRing_push(InputRing *self, const InputRingEvent *event);
+
+// Pop oldest event into out (consumer side). Returns false if ring is empty
+bool InputRing_pop(InputRing *self, InputRingEvent *out);
+
+// Start feeding ring with key events as SDL receives them
+void InputRing_attach(InputRing *self);
+
+// Stop feeding ring
+void InputRing_detach(InputRing *self);
+
+#endif
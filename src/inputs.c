@@ -7,65 +7,400 @@
 #include <string.h>
 
 #include "inputs.h"
+#include "latency.h"
 #include "sirtet.h"
 
 /******************************************************************************
  * Hardware Inputs
 ******************************************************************************/
 
-// hardware_states should be an array of size
-// (int)SDL_Scancode.
-//
-// (int)SDL_Scancode is represented by the index
-// in the array
-//
-// Values of the array are as follows:
+InputTracker* InputTracker_init() {
+
+    InputTracker *retval = (InputTracker*)malloc(sizeof(InputTracker));
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for InputTracker\n");
+        return NULL;
+    }
+
+    retval->frame = 0;
+    retval->now_ms = 0;
+    retval->ring = NULL;
+    retval->n_held = 0;
+    retval->n_active = 0;
+    memset(retval->changed, 0, sizeof(retval->changed));
+    memset(retval->pressed, 0, sizeof(retval->pressed));
+    memset(retval->down_ms, 0, sizeof(retval->down_ms));
+    memset(retval->up_ms, 0, sizeof(retval->up_ms));
+    memset(retval->held, 0, sizeof(retval->held));
+    for (int i = 0; i < (int)SDL_NUM_SCANCODES; i++) {
+        retval->active_idx[i] = -1;
+    }
+
+    return retval;
+}
+
+
+void InputTracker_deconstruct(InputTracker *self) {
+    free(self);
+}
+
+
+// Remove a scancode from the active set by swapping in the last entry
+static void InputTracker_deactivate(InputTracker *self, SDL_Scancode scancode) {
+
+    int idx = self->active_idx[scancode];
+    if (idx < 0) {
+        return;
+    }
+
+    SDL_Scancode last = self->active[self->n_active - 1];
+    self->active[idx] = last;
+    self->active_idx[last] = idx;
+
+    self->active_idx[scancode] = -1;
+    self->n_active--;
+}
+
+
+static void InputTracker_activate(InputTracker *self, SDL_Scancode scancode) {
+
+    if (self->active_idx[scancode] >= 0) {
+        return;
+    }
+    self->active_idx[scancode] = self->n_active;
+    self->active[self->n_active] = scancode;
+    self->n_active++;
+}
+
+
+void InputTracker_beginFrame(InputTracker *self, Uint32 now_ms) {
+
+    self->frame++;
+    self->now_ms = now_ms;
+
+    // Iterate backwards, as deactivation swaps the last entry into place
+    for (int i = self->n_active - 1; i >= 0; i--) {
+        SDL_Scancode scancode = self->active[i];
+        if (!self->held[scancode]) {
+            InputTracker_deactivate(self, scancode);
+        }
+    }
+}
+
+
+void InputTracker_press(
+    InputTracker *self, SDL_Scancode scancode, Uint32 timestamp
+) {
+
+    if ((int)scancode < 0 || (int)scancode >= (int)SDL_NUM_SCANCODES) {
+        return;
+    }
+
+    // Only register keydowns that weren't already pressed to ignore auto-repeat
+    if (self->held[scancode]) {
+        return;
+    }
+
+    self->held[scancode] = true;
+    self->changed[scancode] = self->frame;
+    self->pressed[scancode] = self->frame;
+    self->down_ms[scancode] = timestamp;
+    self->n_held++;
+    InputTracker_activate(self, scancode);
+}
+
+
+void InputTracker_release(
+    InputTracker *self, SDL_Scancode scancode, Uint32 timestamp
+) {
+
+    if ((int)scancode < 0 || (int)scancode >= (int)SDL_NUM_SCANCODES) {
+        return;
+    }
+
+    if (self->held[scancode]) {
+        self->held[scancode] = false;
+        self->n_held--;
+    }
+
+    // Stays active for the remainder of this frame
+    self->changed[scancode] = self->frame;
+    self->up_ms[scancode] = timestamp;
+    InputTracker_activate(self, scancode);
+}
+
+
+// Values are as follows:
 // * Negative values represent the number of
 //   frames a key has been not pressed
 // * Positive values represent the number of
 //   frames a key has been pressed for
-// * 0 is used to represent an indeterminate state
-//
+// * INT_MIN represents a key never pressed
+int InputTracker_frameCount(InputTracker *self, SDL_Scancode scancode) {
+
+    Uint64 changed = self->changed[scancode];
+    if (changed == 0) {
+        return INT_MIN;
+    }
+
+    // Frame of change counts as the first frame pressed/released
+    Uint64 count = self->frame - changed + 1;
+
+    if (self->held[scancode]) {
+        return count >= (Uint64)INT_MAX ? INT_MAX : (int)count;
+    }
+    return count >= (Uint64)INT_MAX ? INT_MIN : -(int)count;
+}
+
+
+void InputTracker_useRing(InputTracker *self, InputRing *ring) {
+    self->ring = ring;
+}
+
+
+// Apply a single key event to tracker
+static void InputTracker_applyKey(
+    InputTracker *self, Uint32 type, SDL_Scancode scancode,
+    Uint32 timestamp, Uint8 repeat
+) {
+    if (type == SDL_KEYUP) {
+        InputTracker_release(self, scancode, timestamp);
+        return;
+    }
+
+    if (repeat == 0) {
+        Latency_keyEvent(scancode, timestamp);
+    }
+    InputTracker_press(self, scancode, timestamp);
+}
+
+
 // Assumes SDL has already undergone whatever
 // initialization is required for registering
 // inputs (SDL_Init, window created, etc.)
-int processHardwareInputs(int* hardware_states) {
+int processHardwareInputs(InputTracker *tracker) {
 
+    // Evaluate at a time no earlier than any event already queued
+    SDL_PumpEvents();
+    InputTracker_beginFrame(tracker, SDL_GetTicks());
 
-    // preprocess
-    for (int int_scancode = 0; int_scancode < (int)SDL_NUM_SCANCODES; int_scancode++) {
+    int events = 0;
+    SDL_Event event;
+    while ( SDL_PollEvent(&event) > 0) {
 
-        if ( hardware_states[int_scancode] < 0 && hardware_states[int_scancode] > INT_MIN ) {
-            hardware_states[int_scancode]--;
+        switch (event.type) {
+            case SDL_KEYUP:
+            case SDL_KEYDOWN:
+                events |= HWEVENT_KEYBOARD;
+
+                // Already delivered to ring as SDL received it
+                if (tracker->ring != NULL) {
+                    break;
+                }
+                InputTracker_applyKey(
+                    tracker, event.type, event.key.keysym.scancode,
+                    event.key.timestamp, event.key.repeat
+                );
+                break;
+            case SDL_WINDOWEVENT:
+                events |= HWEVENT_WINDOW;
+                if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                    events |= HWEVENT_RESIZE;
+                }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+                if (event.window.event == SDL_WINDOWEVENT_DISPLAY_CHANGED) {
+                    events |= HWEVENT_RESIZE;
+                }
+#endif
+                break;
+            // Render target contents (and, for a device reset, every
+            // texture) are gone & must be redrawn
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                events |= HWEVENT_WINDOW | HWEVENT_RENDER_RESET;
+                break;
+            default:
+                events |= HWEVENT_OTHER;
+                break;
         }
     }
 
-    // process
-    SDL_Event event;
-    int scancode;
-    while ( SDL_PollEvent(&event) > 0) {
+    // Drain everything pushed since last frame, including events pumped
+    // while the main loop was idle
+    InputRingEvent ring_event;
+    while (tracker->ring != NULL && InputRing_pop(tracker->ring, &ring_event)) {
+        events |= HWEVENT_KEYBOARD;
+        InputTracker_applyKey(
+            tracker, ring_event.type, ring_event.scancode,
+            ring_event.timestamp, ring_event.repeat
+        );
+    }
 
-        scancode = (int)event.key.keysym.scancode;
+    if (tracker->n_held > 0) {
+        events |= HWEVENT_KEYS_HELD;
+    }
 
-        if (event.type == SDL_KEYUP) {
-            hardware_states[scancode] = -1;
-        }
+    return events;
+}
 
-        if (event.type == SDL_KEYDOWN && hardware_states[scancode] < 0) {
-            hardware_states[scancode] = 0;
-        }
+
+/******************************************************************************
+ * Mapping evaluation (shared by game & menu codes)
+******************************************************************************/
+
+// Reset a reverse lookup table to have no chains
+static void clearLookup(int *scancode_heads, int *always_head) {
+    for (int i = 0; i < (int)SDL_NUM_SCANCODES; i++) {
+        scancode_heads[i] = -1;
     }
+    *always_head = -1;
+}
 
-    // postprocess
-    for (int int_scancode = 0; int_scancode < (int)SDL_NUM_SCANCODES; int_scancode++) {
 
-        // Only register keydowns that weren't already pressed to ignore auto-repeat
-        if ( hardware_states[int_scancode] >= 0 && hardware_states[int_scancode] < INT_MAX ) {
-            hardware_states[int_scancode]++;
-        }
+// Identify the chain a new mapping should be added to. Mappings whose range
+// includes non-positive frame counts can emit for released (and therefore
+// possibly inactive) keys, so must be evaluated every frame
+static int* lookupChain(
+    int *scancode_heads, int *always_head,
+    SDL_Scancode hardware_code, int frame_start
+) {
+    if (frame_start <= 0) {
+        return always_head;
     }
+    return &scancode_heads[hardware_code];
+}
 
-    return 0;
+
+/**
+ * @brief Identify if a mapping emits its signal this frame. Mappings over
+ *        positive frame ranges keep a precomputed schedule, reset on each new
+ *        press of their key, rather than testing the frame count modulo the
+ *        interval.
+ * @param frame_count - Key's current frame count, as per InputTracker
+ * @param stamp - Frame key's state last changed, identifying the press
+ * @param sched_next - Mapping's next frame count at which to emit
+ * @param sched_stamp - Press that mapping's schedule belongs to
+ */
+static bool mappingEmits(
+    int frame_start, int frame_end, int frame_interval,
+    int frame_count, Uint64 stamp, Sint64 *sched_next, Uint64 *sched_stamp
+) {
+
+    if (frame_count < frame_start || frame_count > frame_end) {
+        return false;
+    }
+
+    if (frame_start <= 0) {
+        return (
+            frame_interval == 0
+            || (frame_count - frame_start) % frame_interval == 0
+        );
+    }
+
+    Sint64 step = frame_interval < 0 ? -(Sint64)frame_interval : frame_interval;
+    if (step == 0) {
+        step = 1;
+    }
+
+    if (*sched_stamp != stamp) {
+        *sched_stamp = stamp;
+        *sched_next = frame_start;
+    }
+
+    // Re-evaluated within the same frame as last emission
+    if (*sched_next > frame_start && frame_count == *sched_next - step) {
+        return true;
+    }
+
+    // Evaluation skipped some frames (ie: state wasn't run); catch up
+    if (frame_count > *sched_next) {
+        Sint64 behind = frame_count - *sched_next;
+        *sched_next += ((behind + step - 1) / step) * step;
+    }
+
+    if (frame_count != *sched_next) {
+        return false;
+    }
+
+    *sched_next += step;
+    return true;
+}
+
+
+/**
+ * @brief Identify number of times a millisecond-timed mapping emits this
+ *        frame, counting every emit due between the key's press and either
+ *        its release (if released this frame) or the frame's time.
+ * @param mapping - Timed mapping to evaluate
+ * @param inputs - InputTracker holding key states & timestamps
+ * @param first_ms - Written out with time of first emit, if any
+ * @return Number of emits made this frame
+ */
+static int timedMappingEmits(
+    GamecodeMapItem *mapping, InputTracker *inputs, Uint32 *first_ms
+) {
+
+    SDL_Scancode scancode = mapping->hardware_code;
+
+    // Keys released before this frame have already had their emits counted
+    bool held = inputs->held[scancode];
+    if (
+        inputs->pressed[scancode] == 0
+        || (!held && inputs->changed[scancode] != inputs->frame)
+    ) {
+        return 0;
+    }
+
+    // Emits that came due while the mapping went unevaluated - the key was
+    // already held when it was first evaluated, or its state wasn't run -
+    // are skipped rather than all made at once
+    bool missed;
+    if (mapping->sched_stamp != inputs->pressed[scancode]) {
+        mapping->sched_stamp = inputs->pressed[scancode];
+        mapping->emitted = 0;
+        mapping->emitted_before = 0;
+        mapping->eval_frame = 0;
+        missed = inputs->pressed[scancode] != inputs->frame;
+    }
+    else {
+        missed = mapping->eval_frame + 1 < inputs->frame;
+    }
+
+    // Re-evaluating within a frame recounts from the same starting point
+    if (mapping->eval_frame != inputs->frame) {
+        mapping->emitted_before = mapping->emitted;
+        mapping->eval_frame = inputs->frame;
+    }
+
+    Uint32 down = inputs->down_ms[scancode];
+    Uint32 end = held ? inputs->now_ms : inputs->up_ms[scancode];
+    Sint32 elapsed = (Sint32)(end - down);
+
+    int due;
+    if (elapsed < 0 || (Uint32)elapsed < mapping->delay_ms) {
+        due = 0;
+    }
+    else if (mapping->interval_ms == 0) {
+        due = 1;
+    }
+    else {
+        due = 1 + ((Uint32)elapsed - mapping->delay_ms) / mapping->interval_ms;
+    }
+
+    if (missed) {
+        mapping->emitted_before = due;
+    }
+    mapping->emitted = due;
+    int count = due - mapping->emitted_before;
+    if (count <= 0) {
+        return 0;
+    }
+
+    *first_ms = (
+        down + mapping->delay_ms
+        + (Uint32)mapping->emitted_before * mapping->interval_ms
+    );
+    return count;
 }
 
 
@@ -79,67 +414,146 @@ GamecodeMap* GamecodeMap_init(int max_maps) {
         return NULL;
     }
 
-    GamecodeMap *retval = (GamecodeMap*)malloc(sizeof(GamecodeMap));
+    size_t nbytes = GamecodeMap_requiredBytes(max_maps);
+    return GamecodeMap_build(malloc(nbytes), nbytes, max_maps);
+
+}
+
+// Initialize a GamecodeMap as a direct copy of an existing one
+GamecodeMap* GamecodeMap_initCopy(GamecodeMap *blueprint) {
+
+    size_t nbytes = GamecodeMap_requiredBytes(blueprint->size);
+    return GamecodeMap_buildCopy(malloc(nbytes), nbytes, blueprint);
+}
+
+int GamecodeMap_deconstruct(GamecodeMap *self) {
+    free(self);
+    return 0;
+}
+
+size_t GamecodeMap_requiredBytes(int max_maps) {
+    return sizeof(GamecodeMap) + max_maps * sizeof(GamecodeMapItem);
+}
+
+GamecodeMap* GamecodeMap_build(void *data, size_t data_size, int max_maps) {
+
+    if (
+        data == NULL || max_maps < 0
+        || data_size < GamecodeMap_requiredBytes(max_maps)
+    ) {
+        return NULL;
+    }
+
+    GamecodeMap *retval = (GamecodeMap*)data;
 
     retval->head = 0;
     retval->size = max_maps;
-    retval->mappings = (GamecodeMapItem*)malloc(max_maps * sizeof(GamecodeMapItem));
+    retval->mappings = (GamecodeMapItem*)((char*)data + sizeof(GamecodeMap));
+    clearLookup(retval->scancode_heads, &retval->always_head);
 
     return retval;
-
 }
 
-// Initialize a GamecodeMap as a direct copy of an existing one
-GamecodeMap* GamecodeMap_initCopy(GamecodeMap *blueprint) {
+GamecodeMap* GamecodeMap_buildCopy(
+    void *data, size_t data_size, GamecodeMap *blueprint
+) {
 
-    GamecodeMap *retval = (GamecodeMap*)malloc(sizeof(GamecodeMap));
+    if (
+        data == NULL
+        || data_size < GamecodeMap_requiredBytes(blueprint->size)
+    ) {
+        return NULL;
+    }
 
-    size_t n = blueprint->size * sizeof(GamecodeMapItem);
+    GamecodeMap *retval = (GamecodeMap*)data;
 
-    retval->head = blueprint->head;
-    retval->size = blueprint->size;
-    retval->mappings = (GamecodeMapItem*)malloc(n);
-    memcpy(retval->mappings, blueprint->mappings, n);
+    // Copies lookup table along with it
+    *retval = *blueprint;
+    retval->mappings = (GamecodeMapItem*)((char*)data + sizeof(GamecodeMap));
+    memcpy(
+        retval->mappings, blueprint->mappings,
+        blueprint->size * sizeof(GamecodeMapItem)
+    );
 
     return retval;
 }
 
-int GamecodeMap_deconstruct(GamecodeMap *self) {
+// Record a gamecode's emit(s) made at a given time
+static void Gamecode_emit(
+    bool *gamecode_states, GamecodeEmission *emissions,
+    Gamecode gamecode, int count, Uint32 time_ms
+) {
+    gamecode_states[(int)gamecode] = true;
+    if (emissions == NULL) {
+        return;
+    }
 
-    free(self->mappings);
-    free(self);
-    return 0;
+    GamecodeEmission *emission = &emissions[(int)gamecode];
+    if (emission->count == 0 || (Sint32)(time_ms - emission->first_ms) < 0) {
+        emission->first_ms = time_ms;
+    }
+    emission->count += count;
 }
 
 /**
  * @brief Populate gamecode flag array based on key mappings and customized state of hardware
  * @param gamecode_states   Pointer to flag array for gamecode states. Should be of size (int)NUM_GAMECODE_STATES
- * @param hardware_states   Pointer to integer state array for hardware states. Should be of size (int)SDL_NUM_SCANCODES
+ * @param emissions         Pointer to array of per-gamecode emission counts &
+ *                          times, of size (int)NUM_GAMECODES. Ignored if NULL
+ * @param inputs            Pointer to InputTracker holding state of hardware
  * @param all_mappings      Pointer to struct of GamecodeMap type key mappings.
 */
-int processGamecodes(bool *gamecode_states, int *hardware_states, GamecodeMap *all_mappings) {
+int processGamecodes(
+    bool *gamecode_states, GamecodeEmission *emissions,
+    InputTracker *inputs, GamecodeMap *all_mappings
+) {
 
     // preprocess
     for (int int_gamecode = 0; int_gamecode < (int)NUM_GAMECODES; int_gamecode++) {
         gamecode_states[int_gamecode] = false;
     }
+    if (emissions != NULL) {
+        memset(emissions, 0, (int)NUM_GAMECODES * sizeof(GamecodeEmission));
+    }
 
-    GamecodeMapItem mapping;
-    for (int map_i = 0; map_i < all_mappings->head; map_i++) {
-
-        mapping = all_mappings->mappings[map_i];
-
-        int frame_count = hardware_states[(int)mapping.hardware_code];
-
-        if (
-            frame_count >= mapping.frame_start
-            && frame_count <= mapping.frame_end
-            && (
-                mapping.frame_interval == 0
-                || (frame_count - mapping.frame_start) % mapping.frame_interval == 0
-            )
-        ) {
-            gamecode_states[(int)mapping.virtual_code] = true;
+    // Only keys in the active set (plus the always-evaluated chain) can emit
+    GamecodeMapItem *mappings = all_mappings->mappings;
+    for (int act_i = -1; act_i < inputs->n_active; act_i++) {
+
+        int map_i = (
+            act_i < 0
+            ? all_mappings->always_head
+            : all_mappings->scancode_heads[inputs->active[act_i]]
+        );
+
+        for (; map_i >= 0; map_i = mappings[map_i].next) {
+
+            GamecodeMapItem *mapping = &mappings[map_i];
+
+            if (mapping->timed) {
+                Uint32 first_ms;
+                int count = timedMappingEmits(mapping, inputs, &first_ms);
+                if (count > 0) {
+                    Gamecode_emit(
+                        gamecode_states, emissions,
+                        mapping->virtual_code, count, first_ms
+                    );
+                    Latency_consumed(mapping->hardware_code);
+                }
+            }
+            else if (mappingEmits(
+                mapping->frame_start, mapping->frame_end,
+                mapping->frame_interval,
+                InputTracker_frameCount(inputs, mapping->hardware_code),
+                inputs->changed[mapping->hardware_code],
+                &mapping->sched_next, &mapping->sched_stamp
+            )) {
+                Gamecode_emit(
+                    gamecode_states, emissions,
+                    mapping->virtual_code, 1, inputs->now_ms
+                );
+                Latency_consumed(mapping->hardware_code);
+            }
         }
     }
 
@@ -155,13 +569,59 @@ int GamecodeMap_addMap(
         return -1;
     }
 
+    if ((int)hardware_code < 0 || (int)hardware_code >= (int)SDL_NUM_SCANCODES) {
+        return -1;
+    }
+
+    int *chain = lookupChain(
+        self->scancode_heads, &self->always_head, hardware_code, frame_start
+    );
+
     *(self->mappings + self->head) = (GamecodeMapItem){
         .virtual_code=virtual_code,
         .hardware_code=hardware_code,
         .frame_start=frame_start,
         .frame_end=frame_end,
-        .frame_interval=frame_interval
+        .frame_interval=frame_interval,
+        .timed=false,
+        .next=*chain,
+        .sched_next=frame_start,
+        .sched_stamp=0
+    };
+    *chain = self->head;
+    self->head += 1;
+    return 0;
+}
+
+int GamecodeMap_addTimedMap(
+    GamecodeMap *self, Gamecode virtual_code, SDL_Scancode hardware_code,
+    Uint32 delay_ms, Uint32 interval_ms
+) {
+
+    if (self->head >= self->size) {
+        return -1;
+    }
+
+    if ((int)hardware_code < 0 || (int)hardware_code >= (int)SDL_NUM_SCANCODES) {
+        return -1;
+    }
+
+    // Only emits for held (or just-released) keys, which are always active
+    int *chain = &self->scancode_heads[hardware_code];
+
+    *(self->mappings + self->head) = (GamecodeMapItem){
+        .virtual_code=virtual_code,
+        .hardware_code=hardware_code,
+        .timed=true,
+        .delay_ms=delay_ms,
+        .interval_ms=interval_ms,
+        .emitted=0,
+        .emitted_before=0,
+        .eval_frame=0,
+        .next=*chain,
+        .sched_stamp=0
     };
+    *chain = self->head;
     self->head += 1;
     return 0;
 }
@@ -169,6 +629,7 @@ int GamecodeMap_addMap(
 // Clear all mapped keys from a GamecodeMap
 void GamecodeMap_reset(GamecodeMap *self) {
     self->head = 0;
+    clearLookup(self->scancode_heads, &self->always_head);
 }
 
 
@@ -177,58 +638,87 @@ bool Gamecode_pressed(bool *gamecode_arr, Gamecode gamecode) {
     return gamecode_arr[(int)gamecode];
 }
 
+// Identify number of times (& earliest time at which) a gamecode emitted
+GamecodeEmission Gamecode_emission(
+    GamecodeEmission *emission_arr, Gamecode gamecode) {
+    return emission_arr[(int)gamecode];
+}
+
 
 /******************************************************************************
  * Menu inputs
 ******************************************************************************/
 
 MenucodeMap* MenucodeMap_init(int max_maps) {
-    MenucodeMap *retval = (MenucodeMap*)malloc(sizeof(MenucodeMap));
 
-    retval->head = 0;
-    retval->size=max_maps;
-    retval->mappings = (MenucodeMapItem*)malloc(max_maps * sizeof(MenucodeMapItem));
-    return retval;
+    size_t nbytes = MenucodeMap_requiredBytes(max_maps);
+    return MenucodeMap_build(malloc(nbytes), nbytes, max_maps);
 }
 
 int MenucodeMap_deconstruct(MenucodeMap *self) {
-    free(self->mappings);
     free(self);
     return 0;
 }
 
+size_t MenucodeMap_requiredBytes(int max_maps) {
+    return sizeof(MenucodeMap) + max_maps * sizeof(MenucodeMapItem);
+}
+
+MenucodeMap* MenucodeMap_build(void *data, size_t data_size, int max_maps) {
+
+    if (
+        data == NULL || max_maps < 0
+        || data_size < MenucodeMap_requiredBytes(max_maps)
+    ) {
+        return NULL;
+    }
+
+    MenucodeMap *retval = (MenucodeMap*)data;
+
+    retval->head = 0;
+    retval->size = max_maps;
+    retval->mappings = (MenucodeMapItem*)((char*)data + sizeof(MenucodeMap));
+    clearLookup(retval->scancode_heads, &retval->always_head);
+    return retval;
+}
+
 
 /**
  * @brief Populate menucode flag array based on key mappings and customized 
  *                          state of hardware
  * @param menucode_states   Pointer to flag array for gamecode states. Should
  *                          be of size (int)NUM_MENUCODE_STATES
- * @param hardware_states   Pointer to integer state array for hardware states.
- *                          Should be of size (int)SDL_NUM_SCANCODES
+ * @param inputs            Pointer to InputTracker holding state of hardware
  * @param all_mappings      Pointer to struct of menucodeMap type key mappings.
 */
 int processMenucodes(
-    bool *menucode_states, int *hardware_states, MenucodeMap *all_mappings
+    bool *menucode_states, InputTracker *inputs, MenucodeMap *all_mappings
 ) {
 
     memset(menucode_states, 0, (int)NUM_MENUCODES * sizeof(bool));
 
-    MenucodeMapItem map_itm;
-    for (int map_i = 0; map_i < all_mappings->head; map_i++) {
-
-        map_itm = all_mappings->mappings[map_i];
-
-        int frame_count = hardware_states[(int)map_itm.hardware_code];
-
-        if (
-            frame_count >= map_itm.frame_start
-            && frame_count <= map_itm.frame_end
-            && (
-                map_itm.frame_interval == 0
-                || (frame_count - map_itm.frame_start) % map_itm.frame_interval == 0
-            )
-        ) {
-            menucode_states[(int)map_itm.virtual_code] = true;
+    // Only keys in the active set (plus the always-evaluated chain) can emit
+    MenucodeMapItem *mappings = all_mappings->mappings;
+    for (int act_i = -1; act_i < inputs->n_active; act_i++) {
+
+        int map_i = (
+            act_i < 0
+            ? all_mappings->always_head
+            : all_mappings->scancode_heads[inputs->active[act_i]]
+        );
+
+        for (; map_i >= 0; map_i = mappings[map_i].next) {
+
+            MenucodeMapItem *map_itm = &mappings[map_i];
+            if (mappingEmits(
+                map_itm->frame_start, map_itm->frame_end,
+                map_itm->frame_interval,
+                InputTracker_frameCount(inputs, map_itm->hardware_code),
+                inputs->changed[map_itm->hardware_code],
+                &map_itm->sched_next, &map_itm->sched_stamp
+            )) {
+                menucode_states[(int)map_itm->virtual_code] = true;
+            }
         }
     }
 
@@ -245,13 +735,26 @@ int Menucode_addMap(
         return -1;
     }
 
+    if ((int)hardware_code < 0 || (int)hardware_code >= (int)SDL_NUM_SCANCODES) {
+        return -1;
+    }
+
+    int *chain = lookupChain(
+        map_itm->scancode_heads, &map_itm->always_head,
+        hardware_code, frame_start
+    );
+
     map_itm->mappings[map_itm->head] = (MenucodeMapItem){
         .virtual_code=virtual_code,
         .hardware_code=hardware_code,
         .frame_start=frame_start,
         .frame_end=frame_end,
-        .frame_interval=frame_interval
+        .frame_interval=frame_interval,
+        .next=*chain,
+        .sched_next=frame_start,
+        .sched_stamp=0
     };
+    *chain = map_itm->head;
 
     map_itm->head += 1;
 
@@ -5,6 +5,8 @@
 #include <SDL2/SDL_scancode.h>
 #include <stdbool.h>
 
+#include "input_ring.h"
+
 /******************************************************************************
  * Hardware Inputs
 ******************************************************************************/
@@ -12,14 +14,78 @@
 /* Note: use SDL_Scancode for a contiguous block of integers
 *  representing key codes */
 
+// Flags returned by processHardwareInputs, describing the frame's events
+#define HWEVENT_KEYBOARD    0x01    // A key was pressed or released
+#define HWEVENT_WINDOW      0x02    // Window was shown, exposed, resized, etc.
+#define HWEVENT_OTHER       0x04    // Any other event was received
+#define HWEVENT_KEYS_HELD   0x08    // At least one key is currently held
+#define HWEVENT_RESIZE      0x10    // Window size (or its display) changed
+#define HWEVENT_RENDER_RESET 0x20   // Render targets (or the renderer) were lost
+
+/* Tracks hardware key states, touching only keys that are active (held, or
+*  released this frame) each frame. A key's frame count is derived lazily from
+*  the frame its state last changed, so untouched keys cost nothing to age.
+*  Event timestamps are kept alongside, for millisecond-timed mappings. */
+typedef struct {
+
+    Uint64 frame;   // Current frame number, starting at 1
+    Uint32 now_ms;  // Time (SDL ticks) this frame's inputs are evaluated at
+
+    // Indexed by SDL_Scancode
+    Uint64 changed[SDL_NUM_SCANCODES];  // Frame state last changed, 0 if never
+    Uint64 pressed[SDL_NUM_SCANCODES];  // Frame of last registered press
+    Uint32 down_ms[SDL_NUM_SCANCODES];  // Timestamp of last registered press
+    Uint32 up_ms[SDL_NUM_SCANCODES];    // Timestamp of last release
+    bool held[SDL_NUM_SCANCODES];       // Whether key is currently held
+    int active_idx[SDL_NUM_SCANCODES];  // Position in active, -1 if absent
+
+    int n_held;                             // Number of keys currently held
+    int n_active;                           // Number of entries in active
+    SDL_Scancode active[SDL_NUM_SCANCODES]; // Held & just-released keys
+
+    InputRing *ring;    // If not NULL, source of key events (not owned)
+
+} InputTracker;
+
+
+// Initialize a tracker with no keys ever pressed
+InputTracker* InputTracker_init();
+
+void InputTracker_deconstruct(InputTracker *self);
+
+// Advance to next frame, evaluated at time now_ms, dropping keys released
+// last frame from active set
+void InputTracker_beginFrame(InputTracker *self, Uint32 now_ms);
+
+// Register a key press occurring at timestamp. Presses of already-held keys
+// (auto-repeat) are ignored
+void InputTracker_press(
+    InputTracker *self, SDL_Scancode scancode, Uint32 timestamp);
+
+// Register a key release occurring at timestamp
+void InputTracker_release(
+    InputTracker *self, SDL_Scancode scancode, Uint32 timestamp);
+
 /**
- * @brief - Reset and flag array representing current hardware states
- * @param hardware_states - Integer array whose indices represent SDL_Scancode
- *                          values and whose values represent the number of 
- *                          consective frames the key has been pressed or
- *                          released, based on its sign
+ * @brief - Identify number of consecutive frames a key has been pressed or
+ *          released for in current frame
+ * @param self - InputTracker to query
+ * @param scancode - Key to query
+ * @return - Positive number of frames pressed for, negative number of frames
+ *           released for, or INT_MIN if never pressed (or released long
+ *           enough ago to saturate)
  */
-int processHardwareInputs(int* hardware_states);
+int InputTracker_frameCount(InputTracker *self, SDL_Scancode scancode);
+
+// Take key events from an (attached) InputRing rather than SDL's event queue
+void InputTracker_useRing(InputTracker *self, InputRing *ring);
+
+/**
+ * @brief - Poll SDL events, updating tracked key states for a new frame
+ * @param tracker - InputTracker to update
+ * @return - Bitwise OR of HWEVENT_* flags describing this frame's events
+ */
+int processHardwareInputs(InputTracker *tracker);
 
 /******************************************************************************
  * Game Inputs
@@ -49,13 +115,39 @@ typedef struct {
     int frame_start;
     int frame_end;
     int frame_interval;
+
+    // Millisecond timing, used in place of frames if timed
+    bool timed;
+    Uint32 delay_ms;        // Time from press until first emit
+    Uint32 interval_ms;     // Time between repeated emits, 0 for no repeat
+    int emitted;            // Emits made so far for press in sched_stamp
+    int emitted_before;     // Emits made prior to frame eval_frame
+    Uint64 eval_frame;      // Frame last evaluated
+
+    int next;               // Index of next mapping in same lookup chain, or -1
+    Sint64 sched_next;      // Next frame count at which mapping emits
+    Uint64 sched_stamp;     // Key press (InputTracker change frame) schedule
+                            // was computed for
 } GamecodeMapItem;
 
+// Emits of a single gamecode within a frame
+typedef struct {
+    int count;              // Number of times gamecode emitted
+    Uint32 first_ms;        // Time of earliest emit, for sub-frame ordering
+} GamecodeEmission;
+
 // Struct wrapping a list of gamecode mappings
 typedef struct {
     int head;
     int size;
     GamecodeMapItem *mappings;
+
+    // Reverse lookup, built as mappings are added. Chains of mapping indices
+    // (linked through GamecodeMapItem.next) by hardware code, plus a chain of
+    // mappings with non-positive frame ranges, which may emit for keys
+    // outside InputTracker's active set and are evaluated every frame
+    int scancode_heads[SDL_NUM_SCANCODES];
+    int always_head;
 } GamecodeMap;
 
 
@@ -64,6 +156,19 @@ GamecodeMap* GamecodeMap_init(int max_maps);
 // Initialize a GamecodeMap as a direct copy of an existing one
 GamecodeMap* GamecodeMap_initCopy(GamecodeMap *blueprint);
 
+// Number of bytes needed to build a GamecodeMap holding max_maps mappings
+size_t GamecodeMap_requiredBytes(int max_maps);
+
+// Build a GamecodeMap within a provided block of memory, of at least
+// GamecodeMap_requiredBytes(max_maps) bytes. NULL if it doesn't fit
+GamecodeMap* GamecodeMap_build(void *data, size_t data_size, int max_maps);
+
+// Build a copy of an existing GamecodeMap within a provided block of memory,
+// of at least GamecodeMap_requiredBytes(blueprint->size) bytes
+GamecodeMap* GamecodeMap_buildCopy(
+    void *data, size_t data_size, GamecodeMap *blueprint
+);
+
 void GamecodeMap_reset(GamecodeMap *self);
 
 int GamecodeMap_addMap(
@@ -71,13 +176,37 @@ int GamecodeMap_addMap(
     int frame_start, int frame_end, int frame_interval
 );
 
+/**
+ * @brief Add a mapping timed in milliseconds from key press, independent of
+ *        frame rate. Emits once delay_ms after press, then every interval_ms
+ *        for as long as the key is held. Presses released within a single
+ *        frame still emit any signals due before their release. Signals
+ *        due while the mapping isn't evaluated (including before its first
+ *        evaluation, for keys already held) are skipped.
+ * @param delay_ms - Time from press until first emit (ie: delayed auto-shift)
+ * @param interval_ms - Time between repeated emits (ie: auto-repeat rate), or
+ *                      0 to emit only once per press
+ * @return 0 on success, -1 on failure
+ */
+int GamecodeMap_addTimedMap(
+    GamecodeMap *self, Gamecode virtual_code, SDL_Scancode hardware_code,
+    Uint32 delay_ms, Uint32 interval_ms
+);
+
 int GamecodeMap_deconstruct(GamecodeMap *self);
 
 
 // Identify if a given gamecode is active by parsing an boolean array indexed by gamecodes
 bool Gamecode_pressed(bool *gamecode_arr, Gamecode gamecode);
 
-int processGamecodes(bool *gamecode_states, int *hardware_states, GamecodeMap *all_mappings);
+// Identify number of times (& earliest time at which) a gamecode emitted
+GamecodeEmission Gamecode_emission(
+    GamecodeEmission *emission_arr, Gamecode gamecode);
+
+int processGamecodes(
+    bool *gamecode_states, GamecodeEmission *emissions,
+    InputTracker *inputs, GamecodeMap *all_mappings
+);
 
 /******************************************************************************
  * Menu Inputs
@@ -136,6 +265,10 @@ typedef struct {
     int frame_start;
     int frame_end;
     int frame_interval;
+
+    int next;               // Index of next mapping in same lookup chain, or -1
+    Sint64 sched_next;      // Next frame count at which mapping emits
+    Uint64 sched_stamp;     // Key press schedule was computed for
 } MenucodeMapItem;
 
 
@@ -144,11 +277,22 @@ typedef struct {
     int head;
     int size;
     MenucodeMapItem *mappings;
+
+    // Reverse lookup of mapping chains, as in GamecodeMap
+    int scancode_heads[SDL_NUM_SCANCODES];
+    int always_head;
 } MenucodeMap;
 
 MenucodeMap* MenucodeMap_init(int max_maps);
 int MenucodeMap_deconstruct(MenucodeMap *self);
 
+// Number of bytes needed to build a MenucodeMap holding max_maps mappings
+size_t MenucodeMap_requiredBytes(int max_maps);
+
+// Build a MenucodeMap within a provided block of memory, of at least
+// MenucodeMap_requiredBytes(max_maps) bytes. NULL if it doesn't fit
+MenucodeMap* MenucodeMap_build(void *data, size_t data_size, int max_maps);
+
 
 
 // Add a mapping for a hardware input to menu input
@@ -161,7 +305,7 @@ int Menucode_addMap(
 bool Menucode_pressed(bool *menucode_arr, Menucode menucode);
 
 
-int processMenucodes(bool *menucode_states, int *hardware_states, MenucodeMap *all_mappings);
+int processMenucodes(bool *menucode_states, InputTracker *inputs, MenucodeMap *all_mappings);
 
 
 /******************************************************************************
@@ -0,0 +1,195 @@
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "latency.h"
+#include "sirtet.h"
+
+
+// Histogram buckets are 1ms wide; the final bucket collects everything over
+#define LATENCY_BUCKETS 256
+
+// Inputs never shown (ie: keys with no mapping) are abandoned after this long
+#define LATENCY_TIMEOUT_MS 1000
+
+#define MARKER_SIZE 32
+
+
+typedef enum {
+    SAMPLE_NONE = 0,    // No sample in flight
+    SAMPLE_POLLED,      // Key event polled, awaiting gamecode processing
+    SAMPLE_CONSUMED,    // Emitted a gamecode, awaiting game update
+    SAMPLE_EFFECTED     // Acted on by game update, awaiting present
+} SampleStage;
+
+
+typedef struct {
+    unsigned long counts[LATENCY_BUCKETS];
+    unsigned long n;
+    unsigned long long total_ms;
+    Uint32 max_ms;
+} LatencyHistogram;
+
+
+static struct {
+    bool enabled;
+    bool flash;
+
+    // Sample in flight
+    SampleStage stage;
+    SDL_Scancode scancode;
+    Uint32 event_ms;
+    Uint32 consumed_ms;
+
+    LatencyHistogram total;     // Event to present
+    LatencyHistogram wait;      // Event to gamecode processing (queued time)
+    unsigned long abandoned;
+} glob_latency = {0};
+
+
+static void LatencyHistogram_add(LatencyHistogram *self, Uint32 ms) {
+    int bucket = ms >= LATENCY_BUCKETS ? LATENCY_BUCKETS - 1 : (int)ms;
+    self->counts[bucket]++;
+    self->n++;
+    self->total_ms += ms;
+    if (ms > self->max_ms) {
+        self->max_ms = ms;
+    }
+}
+
+
+// Smallest bucket value at or below which fraction p of samples fall
+static int LatencyHistogram_percentile(LatencyHistogram *self, double p) {
+    unsigned long target = (unsigned long)(p * self->n);
+    if (target < 1) {
+        target = 1;
+    }
+
+    unsigned long cumulative = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        cumulative += self->counts[i];
+        if (cumulative >= target) {
+            return i;
+        }
+    }
+    return LATENCY_BUCKETS - 1;
+}
+
+
+static void LatencyHistogram_print(
+    LatencyHistogram *self, const char *label, FILE *out
+) {
+    if (self->n == 0) {
+        fprintf(out, "  %-8s no samples\n", label);
+        return;
+    }
+    fprintf(
+        out,
+        "  %-8s mean %6.2fms  p50 %3dms  p90 %3dms  p99 %3dms  max %4lums\n",
+        label,
+        (double)self->total_ms / self->n,
+        LatencyHistogram_percentile(self, 0.50),
+        LatencyHistogram_percentile(self, 0.90),
+        LatencyHistogram_percentile(self, 0.99),
+        (ulong)self->max_ms
+    );
+}
+
+
+void Latency_init() {
+    const char *mode = getenv("SIRTET_LATENCY");
+    memset(&glob_latency, 0, sizeof(glob_latency));
+
+    if (mode == NULL || mode[0] == '\0' || strcmp(mode, "0") == 0) {
+        return;
+    }
+    glob_latency.enabled = true;
+    glob_latency.flash = strcmp(mode, "flash") == 0;
+    printf("Latency measurement enabled%s\n",
+           glob_latency.flash ? " (with flash marker)" : "");
+}
+
+
+bool Latency_enabled() {
+    return glob_latency.enabled;
+}
+
+
+void Latency_keyEvent(SDL_Scancode scancode, Uint32 timestamp) {
+    if (!glob_latency.enabled || glob_latency.stage != SAMPLE_NONE) {
+        return;
+    }
+    glob_latency.stage = SAMPLE_POLLED;
+    glob_latency.scancode = scancode;
+    glob_latency.event_ms = timestamp;
+}
+
+
+void Latency_consumed(SDL_Scancode scancode) {
+    if (
+        !glob_latency.enabled
+        || glob_latency.stage != SAMPLE_POLLED
+        || glob_latency.scancode != scancode
+    ) {
+        return;
+    }
+    glob_latency.stage = SAMPLE_CONSUMED;
+    glob_latency.consumed_ms = SDL_GetTicks();
+}
+
+
+void Latency_effect() {
+    if (!glob_latency.enabled || glob_latency.stage != SAMPLE_CONSUMED) {
+        return;
+    }
+    glob_latency.stage = SAMPLE_EFFECTED;
+}
+
+
+void Latency_drawMarker(SDL_Renderer *rend) {
+    if (!glob_latency.flash || glob_latency.stage != SAMPLE_EFFECTED) {
+        return;
+    }
+    SDL_Rect marker = {.x=0, .y=0, .w=MARKER_SIZE, .h=MARKER_SIZE};
+    SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
+    SDL_RenderFillRect(rend, &marker);
+}
+
+
+void Latency_presented() {
+    if (!glob_latency.enabled || glob_latency.stage == SAMPLE_NONE) {
+        return;
+    }
+
+    Uint32 now = SDL_GetTicks();
+
+    if (glob_latency.stage == SAMPLE_EFFECTED) {
+        LatencyHistogram_add(&glob_latency.total, now - glob_latency.event_ms);
+        LatencyHistogram_add(
+            &glob_latency.wait,
+            glob_latency.consumed_ms - glob_latency.event_ms
+        );
+        glob_latency.stage = SAMPLE_NONE;
+        return;
+    }
+
+    if (now - glob_latency.event_ms > LATENCY_TIMEOUT_MS) {
+        glob_latency.abandoned++;
+        glob_latency.stage = SAMPLE_NONE;
+    }
+}
+
+
+void Latency_report(FILE *out) {
+    if (!glob_latency.enabled) {
+        return;
+    }
+    fprintf(
+        out, "Input latency over %lu samples (%lu abandoned):\n",
+        glob_latency.total.n, glob_latency.abandoned
+    );
+    LatencyHistogram_print(&glob_latency.wait, "queued", out);
+    LatencyHistogram_print(&glob_latency.total, "photon", out);
+}
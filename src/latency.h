@@ -0,0 +1,48 @@
+/* latency.h
+*
+* Diagnostic input-to-photon latency probe. When enabled (via the
+* SIRTET_LATENCY environment variable), key presses are timestamped as they
+* are polled, followed through gamecode processing and the game update that
+* acts on them, and sampled at the SDL_RenderPresent that first shows their
+* effect. A latency distribution is reported on exit.
+*
+* SIRTET_LATENCY=1      Measure and report
+* SIRTET_LATENCY=flash  Also draw a marker on each sampled frame, for checking
+*                       measurements against a high-speed camera
+*
+* When disabled, every hook is a single flag check, so frame pacing is
+* unaffected.
+*/
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+
+// Read SIRTET_LATENCY from environment, enabling probe if set
+void Latency_init();
+
+bool Latency_enabled();
+
+// A key press event was polled. Starts a sample if none is in flight
+void Latency_keyEvent(SDL_Scancode scancode, Uint32 timestamp);
+
+// A mapping for scancode emitted a gamecode this frame
+void Latency_consumed(SDL_Scancode scancode);
+
+// Game update acted on this frame's consumed input
+void Latency_effect();
+
+// Draw flash marker if this frame completes a sample (and flash is enabled)
+void Latency_drawMarker(SDL_Renderer *rend);
+
+// A frame was presented. Completes any sample whose effect it shows
+void Latency_presented();
+
+// Print latency distribution of collected samples
+void Latency_report(FILE *out);
+
+#endif
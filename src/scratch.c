@@ -0,0 +1,48 @@
+#include <stdlib.h>
+
+#include "arena.h"
+#include "scratch.h"
+
+
+static Arena *scratch = NULL;
+
+
+int Scratch_init(size_t capacity) {
+
+    if (scratch != NULL) {
+        return 0;
+    }
+
+    scratch = Arena_init(capacity);
+    return scratch == NULL ? -1 : 0;
+}
+
+
+void Scratch_deconstruct() {
+    Arena_deconstruct(scratch);
+    scratch = NULL;
+}
+
+
+void* Scratch_alloc(size_t size) {
+    if (scratch == NULL) {
+        return NULL;
+    }
+    return Arena_alloc(scratch, size);
+}
+
+
+// Arena grows to fit the busiest frame seen, so later frames never overflow
+void Scratch_reset() {
+    if (scratch != NULL) {
+        Arena_reset(scratch);
+    }
+}
+
+
+size_t Scratch_used() {
+    if (scratch == NULL) {
+        return 0;
+    }
+    return Arena_used(scratch);
+}
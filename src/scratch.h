@@ -0,0 +1,33 @@
+/* scratch.h
+*
+* Per-frame scratch memory, for transient allocations that would otherwise
+* be malloc'd & freed within a single frame. Backed by an Arena that the
+* main loop resets once per iteration, so anything allocated here is only
+* valid until the end of the current frame, and is never freed on its own.
+*
+* Until Scratch_init(...) is called (e.g. in unit tests), Scratch_alloc(...)
+* returns NULL, and callers should fall back to the heap.
+*/
+
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <stdlib.h>
+
+
+// Set up scratch memory with (at least) capacity bytes. Returns 0 on success
+int Scratch_init(size_t capacity);
+
+// Release scratch memory
+void Scratch_deconstruct();
+
+// Allocate size bytes for the rest of this frame, or NULL if unavailable
+void* Scratch_alloc(size_t size);
+
+// Release all of this frame's scratch allocations. Called once per frame
+void Scratch_reset();
+
+// Bytes of scratch memory allocated since the last reset
+size_t Scratch_used();
+
+#endif
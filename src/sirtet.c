@@ -4,11 +4,16 @@
  *
  * This file defines the main application runner in function run()
 ******************************************************************************/
+#include "asset_manager.h"
+#include "glyph_atlas.h"
 #include "inputs.h"
+#include "latency.h"
+#include "scratch.h"
 #include "sirtet.h"
 #include "mainmenu_state.h"
 #include "application_state.h"
 #include "state_runner.h"
+#include "layout.h"
 #include "states/application_state.h"
 
 #include <SDL2/SDL_render.h>
@@ -39,7 +44,8 @@
 #endif
 
 
-static char glob_errmsg[ERRMSG_SZ] = {0};
+// Per thread, so errors raised on worker threads don't clobber the main one
+static __thread char glob_errmsg[ERRMSG_SZ] = {0};
 static char glob_appdatapath[FILEPATH_SZ] = {0};
 
 
@@ -55,7 +61,7 @@ void Sirtet_setError(const char *errmsg) {
 
     // memcpy instead of strcpy for custom truncation logic
     memcpy(glob_errmsg, errmsg, copylen);
-    glob_errmsg[copylen + 1] = '\0';
+    glob_errmsg[copylen] = '\0';
 }
 
 char* Sirtet_getError() {
@@ -158,19 +164,13 @@ int run() {
 
     printf("Initializing main menu...\n");
     MainMenuState *mainmenu_state = MainMenuState_init(
-        global_state->rend, global_state->fonts.vt323_24,
-        global_state->images.logo,
-        global_state->images.bg_topleft,
-        global_state->images.bg_topright,
-        global_state->images.bg_bottomleft,
-        global_state->images.bg_bottomright,
-
-        global_state->sounds.short_click
+        global_state->rend, global_state->asset_manager
     );
     if (mainmenu_state == NULL) {
         printf("%s\n", Sirtet_getError());
         return -1;
     }
+    AssetManager_report(global_state->asset_manager, stdout);
 
     printf("Initializing state runner...\n");
     StateRunner *state_runner = StateRunner_init(32, 16);
@@ -179,6 +179,16 @@ int run() {
         return -1;
     }
 
+    // States pushed from here on are allocated from pooled arenas
+    if (
+        StateRunner_reserveArenas(
+            state_runner, STATE_ARENA_COUNT, STATE_ARENA_SIZE) != 0
+    ) {
+        printf("%s\n", Sirtet_getError());
+        StateRunner_deconstruct(state_runner);
+        return -1;
+    }
+
     printf("Pushing main menu state...\n");
     StateRunner_addState(
         state_runner, (void*)mainmenu_state, MainMenuState_run,
@@ -190,7 +200,38 @@ int run() {
         return -1;
     }
 
-    clock_t frame_start;
+    // Memory for allocations that only last the frame they're made in
+    if (Scratch_init(SCRATCH_SIZE) != 0) {
+        printf("%s\n", Sirtet_getError());
+        return -1;
+    }
+
+    // Diagnostic latency probe, if requested via environment
+    Latency_init();
+
+    // FPS overlay text changes every frame, so is drawn glyph-by-glyph
+    const AssetDesc fps_font = {ASSET_FONT, "fonts/VT323.ttf", 12};
+    AssetSet debug_assets = {0};
+    GlyphAtlas *fps_glyphs = NULL;
+    if (DEBUG_ENABLED) {
+        TTF_Font *font = NULL;
+        if (AssetSet_acquire(
+            &debug_assets, global_state->asset_manager, &fps_font, 1) == 0
+        ) {
+            font = AssetSet_font(&debug_assets, 0);
+        }
+        if (font != NULL) {
+            fps_glyphs = GlyphAtlas_init(global_state->rend, font);
+        }
+        if (fps_glyphs == NULL) {
+            printf("%s\n", Sirtet_getError());
+            return -1;
+        }
+    }
+
+    // Wall-clock frame timing - frames may sleep rather than spin
+    const double ticks_per_sec = (double)SDL_GetPerformanceFrequency();
+    Uint64 frame_start;
     double elapsed;
     double raw_fps = 0.0;
     double actual_fps = 0.0;
@@ -204,110 +245,144 @@ int run() {
     while (state_runner->head >= 0) {
 
         frame_counter++;
-        frame_start = clock();
+        frame_start = SDL_GetPerformanceCounter();
 
-        /* Non-game related stuff */
-        processHardwareInputs(global_state->hardware_states);
+        // Last frame's scratch allocations are done with
+        Scratch_reset();
 
-        SDL_SetRenderDrawColor(global_state->rend, 10, 20, 30, 255);
-        SDL_RenderClear(global_state->rend);
+        /* Non-game related stuff */
+        int hw_events = processHardwareInputs(global_state->inputs);
+        if ((hw_events & HWEVENT_RESIZE) != 0) {
+            Layout_update(&global_state->layout, global_state->wind);
+        }
+        if ((hw_events & HWEVENT_RENDER_RESET) != 0) {
+            // States drop their own caches when they see the new generation
+            global_state->render_gen++;
+            LayerCache_invalidate(global_state->underlay);
+
+            if (fps_glyphs != NULL) {
+                GlyphAtlas_deconstruct(fps_glyphs);
+                fps_glyphs = GlyphAtlas_init(
+                    global_state->rend, AssetSet_font(&debug_assets, 0)
+                );
+                if (fps_glyphs == NULL) {
+                    printf("%s\n", Sirtet_getError());
+                    return -1;
+                }
+            }
+        }
+        if ((hw_events & HWEVENT_WINDOW) != 0) {
+            StateRunner_requestRedraw(state_runner);
+        }
 
         /* Run game-state specific code */
+        // NOTE: States clear the screen themselves, so that frames with no
+        // visual change can skip clearing & presenting altogether
         StateRunner_runState(state_runner, (void*)global_state);
+        bool draw_skipped = StateRunner_drawSkipped(state_runner);
+        bool idle = StateRunner_idle(state_runner);
 
         if (StateRunner_commitBuffer(state_runner) != 0) {
             printf("%s\n", Sirtet_getError());
             return -1;
         }
 
+        // Saves happen in the background; failures surface a frame later
+        if (HiscoresSaver_poll(global_state->hiscores_saver) != 0) {
+            printf("%s\n", Sirtet_getError());
+        }
 
-        /* Draw FPS overlay */
-
-        if (DEBUG_ENABLED) {
+        // As do prefetched assets, which are otherwise loaded on first use
+        if (AssetManager_poll(global_state->asset_manager) != 0) {
+            printf("%s\n", Sirtet_getError());
+        }
 
-            TTF_Font *fps_font = global_state->fonts.vt323_12;
 
-            snprintf(buffer, 128, "%.2f ACTUAL FPS", actual_fps);
-            SDL_Surface *fps_surf = TTF_RenderText_Solid(fps_font, buffer, (SDL_Color){.r=255});
-            if (fps_surf == NULL) {
-                printf("%s\n", TTF_GetError());
-                return -1;
-            }
+        /* Nothing to present. If a state was popped, the one below it draws
+         * straight away. Otherwise nothing changed - sleep until next event
+         * (or frame, if held keys need their frame counts advanced) */
 
-            SDL_Texture *fps_texture = SDL_CreateTextureFromSurface(global_state->rend, fps_surf);
-            if (fps_texture == NULL) {
-                printf("%s\n", SDL_GetError());
-                return -1;
+        if (draw_skipped) {
+            if (idle) {
+                int wait_ms = IDLE_WAIT_MS;
+                if ((hw_events & HWEVENT_KEYS_HELD) != 0) {
+                    wait_ms = (int)(1000 * TARGET_SPF);
+                }
+                SDL_WaitEventTimeout(NULL, wait_ms);
             }
+            continue;
+        }
 
-            // NOTE: We want to optimize this later to not free every frame
-            SDL_FreeSurface(fps_surf);
-
-            snprintf(buffer, 128, "%.2f UNBOUNDED FPS", raw_fps);
 
-            SDL_Surface *rawfps_surf = TTF_RenderText_Solid(fps_font, buffer, (SDL_Color){.r=255});
-            if (rawfps_surf == NULL) {
-                printf("%s\n", TTF_GetError());
-                return -1;
-            }
+        /* Draw FPS overlay */
 
-            SDL_Texture *rawfps_texture = SDL_CreateTextureFromSurface(global_state->rend, rawfps_surf);
-            if (rawfps_texture == NULL) {
-                printf("%s\n", SDL_GetError());
-                return -1;
-            }
+        if (DEBUG_ENABLED) {
 
-            // NOTE: We want to optimize this later to not free every frame
-            SDL_FreeSurface(rawfps_surf);
+            SDL_Color fps_col = {.r=255, .a=255};
 
-            int txt_h, txt_w;
-            SDL_QueryTexture(fps_texture, NULL, NULL, &txt_w, &txt_h);
+            snprintf(buffer, 128, "%.2f ACTUAL FPS", actual_fps);
+            SDL_Point txt_size = GlyphAtlas_measure(fps_glyphs, buffer);
             SDL_Rect fps_dest = (SDL_Rect){
-                    .x=WINDOW_WIDTH - txt_w,
-                    .y=WINDOW_HEIGHT - txt_h,
-                    .w=txt_w,
-                    .h=txt_h
+                    .x=WINDOW_WIDTH - txt_size.x,
+                    .y=WINDOW_HEIGHT - txt_size.y,
+                    .w=txt_size.x,
+                    .h=txt_size.y
             };
-            SDL_RenderCopy(global_state->rend, fps_texture, NULL, &fps_dest);
+            if (GlyphAtlas_draw(
+                fps_glyphs, global_state->rend, buffer, fps_col, &fps_dest
+            ) != 0) {
+                printf("%s\n", Sirtet_getError());
+                return -1;
+            }
             int yoffset = fps_dest.h;
 
-            SDL_QueryTexture(rawfps_texture, NULL, NULL, &txt_w, &txt_h);
+            snprintf(buffer, 128, "%.2f UNBOUNDED FPS", raw_fps);
+            txt_size = GlyphAtlas_measure(fps_glyphs, buffer);
             SDL_Rect rawfps_dest = {
-                .x=WINDOW_WIDTH - txt_w,
-                .y=WINDOW_HEIGHT - yoffset - txt_h,
-                .w=txt_w,
-                .h=txt_h
+                .x=WINDOW_WIDTH - txt_size.x,
+                .y=WINDOW_HEIGHT - yoffset - txt_size.y,
+                .w=txt_size.x,
+                .h=txt_size.y
             };
-            SDL_RenderCopy(global_state->rend, rawfps_texture, NULL, &rawfps_dest);
-
-
-            SDL_DestroyTexture(fps_texture);
-            SDL_DestroyTexture(rawfps_texture);
-
-            fps_texture = NULL;
-            rawfps_texture = NULL;
+            if (GlyphAtlas_draw(
+                fps_glyphs, global_state->rend, buffer, fps_col, &rawfps_dest
+            ) != 0) {
+                printf("%s\n", Sirtet_getError());
+                return -1;
+            }
         }
 
 
         /*** Draw ***/
 
+        Latency_drawMarker(global_state->rend);
         SDL_RenderPresent(global_state->rend);
+        Latency_presented();
 
         /*********************************************************************
          * Maintenance calculations
          ********************************************************************/
 
-        elapsed = (double)(clock() - frame_start) / CLOCKS_PER_SEC;
+        elapsed = (SDL_GetPerformanceCounter() - frame_start) / ticks_per_sec;
         raw_fps = (1.0 / elapsed);
 
 
         while (elapsed < TARGET_SPF) {
             // Perform maintenance sorts of tasks here...
-            elapsed = (double)(clock() - frame_start) / CLOCKS_PER_SEC;
+
+            // Pump input as it arrives, so it's timestamped (and queued in
+            // the ring) when received rather than at the next frame's poll
+            if (global_state->input_ring != NULL) {
+                SDL_PumpEvents();
+                if (TARGET_SPF - elapsed > 0.002) {
+                    SDL_Delay(1);
+                }
+            }
+            elapsed = (SDL_GetPerformanceCounter() - frame_start) / ticks_per_sec;
         }
 
         // calculate actual fps
-        elapsed = (double)(clock() - frame_start) / CLOCKS_PER_SEC;
+        elapsed = (SDL_GetPerformanceCounter() - frame_start) / ticks_per_sec;
         actual_fps = (1.0 / elapsed);
 
         if (frame_counter >= TARGET_FPS) {
@@ -321,7 +396,12 @@ int run() {
     // is the best way to do it, but it's how I'm doing it
     // for now.
     
+    Latency_report(stdout);
+
     StateRunner_deconstruct(state_runner);
+    GlyphAtlas_deconstruct(fps_glyphs);
+    AssetSet_release(&debug_assets);
+    Scratch_deconstruct();
     if (ApplicationState_deconstruct(global_state) != 0) {
         printf("%s\n", Sirtet_getError());
         return -1;
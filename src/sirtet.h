@@ -74,6 +74,21 @@ typedef unsigned long ulong;
 #define TARGET_FPS 60
 #define TARGET_SPF (1.0 / TARGET_FPS)
 
+// Longest wait (ms) for input on frames where nothing needed redrawn
+#define IDLE_WAIT_MS 250
+
+// Capacity of key event ring, if SIRTET_INPUT_RING is set
+#define INPUT_RING_SIZE 256
+
+// Arenas pooled for state data (one per state stacked over the main menu),
+// and each one's starting size in bytes. Arenas grow to fit as needed
+#define STATE_ARENA_COUNT 4
+#define STATE_ARENA_SIZE (64 * 1024)
+
+// Starting size, in bytes, of per-frame scratch memory. Grows to fit the
+// busiest frame as needed
+#define SCRATCH_SIZE (64 * 1024)
+
 
 /******************************************************************************
  * High-level prototypes
@@ -85,10 +100,10 @@ int run();
 // Ensure all environment & whatnot is set up
 int Sirtet_setup();
 
-// Set current error code
+// Set current error code (of the calling thread)
 void Sirtet_setError(const char *errmsg);
 
-// Retrieve pointer to current error code
+// Retrieve pointer to current error code (of the calling thread)
 char* Sirtet_getError();
 
 // Retrieve a path to the folder where application data for this game
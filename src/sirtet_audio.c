@@ -74,6 +74,29 @@ SirtetAudio_sound SirtetAudio_loadSound(const char* path) {
             "Error loading sound: %s\n",
             Mix_GetError()
         );
+        Sirtet_setError(errmsg);
+    }
+    return sound;
+}
+
+
+SirtetAudio_sound SirtetAudio_loadSoundRW(SDL_RWops *src) {
+
+    if (src == NULL) {
+        // Error already set by whatever failed to open src
+        return NULLSOUND;
+    }
+
+    Mix_Chunk *sound = Mix_LoadWAV_RW(src, 1);
+
+    if (sound == NULL) {
+        char errmsg[ERRMSG_SZ];
+        snprintf(
+            errmsg, ERRMSG_SZ,
+            "Error loading sound: %s\n",
+            Mix_GetError()
+        );
+        Sirtet_setError(errmsg);
     }
     return sound;
 }
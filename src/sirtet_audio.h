@@ -37,6 +37,10 @@ int SirtetAudio_end();
 // Load and return the sound effect resource at provided file path
 SirtetAudio_sound SirtetAudio_loadSound(const char* path);
 
+// Load and return the sound effect resource read from src, which is closed
+// once read
+SirtetAudio_sound SirtetAudio_loadSoundRW(SDL_RWops *src);
+
 // Load and return the music resource at provided file path
 SirtetAudio_music SirtetAudio_loadMusic(const char* path);
 
@@ -14,6 +14,63 @@
 #include "sirtet.h"
 #include "sirtet_audio.h"
 #include "application_state.h"
+#include "asset_manager.h"
+#include "asset_pack.h"
+#include "hiscores_saver.h"
+#include "mainmenu_state.h"
+#include "inputs.h"
+#include "layout.h"
+#include "layer_cache.h"
+
+
+/*=============================================================================
+ Startup timing
+=============================================================================*/
+
+#define STARTUP_PHASES_MAX 16
+
+// Time spent in each phase of startup, reported once started
+typedef struct {
+    const char *labels[STARTUP_PHASES_MAX];
+    double ms[STARTUP_PHASES_MAX];
+    int n_phases;
+    Uint64 start;
+    Uint64 mark;                // Performance counter at end of last phase
+} StartupTimes;
+
+
+static void StartupTimes_begin(StartupTimes *self) {
+    self->n_phases = 0;
+    self->start = SDL_GetPerformanceCounter();
+    self->mark = self->start;
+}
+
+
+// End the current phase, naming it label
+static void StartupTimes_lap(StartupTimes *self, const char *label) {
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (self->n_phases < STARTUP_PHASES_MAX) {
+        self->labels[self->n_phases] = label;
+        self->ms[self->n_phases] = (
+            (double)(now - self->mark) * 1000 / SDL_GetPerformanceFrequency());
+        self->n_phases++;
+    }
+    self->mark = now;
+}
+
+
+static void StartupTimes_report(StartupTimes *self, FILE *out) {
+
+    fprintf(out, "Startup timing:\n");
+    for (int i = 0; i < self->n_phases; i++) {
+        fprintf(out, "    %-32s %8.2f ms\n", self->labels[i], self->ms[i]);
+    }
+    fprintf(
+        out, "    %-32s %8.2f ms\n", "total",
+        (double)(self->mark - self->start) * 1000 / SDL_GetPerformanceFrequency()
+    );
+}
 
 
 /*=============================================================================
@@ -23,6 +80,10 @@
 ApplicationState* ApplicationState_init(char *asset_folder) {
 
     /***** Initialization *****/
+
+    StartupTimes times;
+    StartupTimes_begin(&times);
+
     ApplicationState *retval = (ApplicationState*)malloc(sizeof(ApplicationState));
     if (retval == NULL) {
         Sirtet_setError("Error allocating memory for ApplicationState\n");
@@ -50,6 +111,38 @@ ApplicationState* ApplicationState_init(char *asset_folder) {
         // NOTE: Intent is to have audio api handle any error messaging
         return NULL;
     }
+    StartupTimes_lap(&times, "SDL, TTF & audio init");
+
+
+    /***** Start loading assets *****/
+
+#ifdef SIRTET_EMBED_ASSETS
+    // Assets are linked into the executable (see `make build_embedded`), so
+    // are read without any filesystem access
+    AssetPack *assets = AssetPack_initEmbedded();
+    if (assets == NULL) {
+        free(retval);
+        return NULL;
+    }
+#else
+    // Assets come from a single packed file where one was built (see
+    // `make build_pack`), and from the asset folder otherwise
+    char buffer[FILEPATH_SZ];
+    snprintf(buffer, FILEPATH_SZ, "%s%s", asset_folder, ASSET_PACK_EXT);
+    AssetPack *assets = AssetPack_initFromFile(buffer);
+#endif
+
+    // Assets are loaded as states need them. Only the main menu's are needed
+    // for the first frame - its images & sounds are decoded on worker
+    // threads while the main thread sets up the window & renderer
+    AssetManager *asset_manager = AssetManager_init(assets, asset_folder);
+    if (asset_manager == NULL) {
+        AssetPack_deconstruct(assets);
+        free(retval);
+        return NULL;
+    }
+    MainMenuState_prefetch(asset_manager);
+    StartupTimes_lap(&times, "asset pack & prefetch start");
 
 
     /***** Window and Renderer *****/
@@ -67,6 +160,8 @@ ApplicationState* ApplicationState_init(char *asset_folder) {
     if (wind == NULL) {
         const char *errmsg = SDL_GetError();
         printf("Error creating window: %s\n", errmsg);
+        AssetManager_deconstruct(asset_manager);
+        AssetPack_deconstruct(assets);
         TTF_Quit();
         SDL_Quit();
         free(retval);
@@ -76,201 +171,100 @@ ApplicationState* ApplicationState_init(char *asset_folder) {
     if (!wind || !rend) {
         const char *errmsg = SDL_GetError();
         printf("Error creating renderer: %s\n", errmsg);
+        AssetManager_deconstruct(asset_manager);
+        AssetPack_deconstruct(assets);
         SDL_DestroyWindow(wind);
         SDL_Quit();
         TTF_Quit();
         free(retval);
         return NULL;
     }
+    AssetManager_setRenderer(asset_manager, rend);
+    StartupTimes_lap(&times, "window & renderer");
 
 
     /***** Build*****/
 
-    int *hardware_states = (int*)malloc((int)SDL_NUM_SCANCODES * sizeof(int));
-    for (int i = 0; i < (int)SDL_NUM_SCANCODES; i++) { hardware_states[i] = INT_MIN; }
-
-
     *(retval) = (ApplicationState){
         .rend=rend,
         .wind=wind,
-        .hardware_states=hardware_states
+        .inputs=InputTracker_init(),
+        .assets=assets,
+        .asset_manager=asset_manager
     };
 
-    if (retval->hardware_states == NULL) {
+    if (retval->inputs == NULL) {
         printf("Error initializing hardware states.\n");
         ApplicationState_deconstruct(retval);
         return NULL;
     }
 
-
-    /***** Load fonts *****/
-
-    char buffer[FILEPATH_SZ];
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/fonts/Lekton-Bold.ttf");
-    retval->fonts.lekton_12 = TTF_OpenFont(buffer, 12);
-    retval->fonts.lekton_24 = TTF_OpenFont(buffer, 24);
-
-    if (
-        retval->fonts.lekton_12 == NULL
-        || retval->fonts.lekton_24 == NULL
-    ) {
-        char buff[ERRMSG_SZ];
-        snprintf(
-            buff, ERRMSG_SZ,
-            "Error loading Lekton font in ApplicationState: %s\n",
-            TTF_GetError()
-        );
-        Sirtet_setError(buff);
-        free(retval);
-        return NULL;
+    // Optionally collect key events as SDL receives them, rather than only
+    // once per frame
+    char *ring_mode = getenv("SIRTET_INPUT_RING");
+    if (ring_mode != NULL && ring_mode[0] != '\0' && strcmp(ring_mode, "0") != 0) {
+        retval->input_ring = InputRing_init(INPUT_RING_SIZE);
+        if (retval->input_ring == NULL) {
+            printf("%s", Sirtet_getError());
+            ApplicationState_deconstruct(retval);
+            return NULL;
+        }
+        InputRing_attach(retval->input_ring);
+        InputTracker_useRing(retval->inputs, retval->input_ring);
     }
 
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/fonts/VT323.ttf");
-    retval->fonts.vt323_12 = TTF_OpenFont(buffer, 12);
-    retval->fonts.vt323_24 = TTF_OpenFont(buffer, 24);
+    Layout_init(&retval->layout);
+    Layout_update(&retval->layout, wind);
 
-    if (
-        retval->fonts.vt323_12 == NULL
-        || retval->fonts.vt323_24 == NULL
-    ) {
-        char buff[ERRMSG_SZ];
-        snprintf(
-            buff, 64,
-            "Error loading VT323 font in ApplicationState: %s\n",
-            TTF_GetError()
-        );
-        Sirtet_setError(buff);
-        free(retval);
-        return NULL;
-    }
-
-    /***** Load images *****/
-
-    // logo
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/img/Logo.bmp");
-    SDL_Surface *logo_surf = SDL_LoadBMP(buffer);
-    if (logo_surf == NULL) {
-        char errbuff[STATIC_ARRMAX];
-        snprintf(
-            errbuff, STATIC_ARRMAX,
-            "Error loading logo:\n    %s\n", 
-            SDL_GetError()
-        );
-        Sirtet_setError(errbuff);
+    retval->underlay = LayerCache_init();
+    if (retval->underlay == NULL) {
+        printf("%s", Sirtet_getError());
+        ApplicationState_deconstruct(retval);
         return NULL;
     }
+    StartupTimes_lap(&times, "inputs & layout");
 
-    // bg images
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/img/BG_TopRight.bmp");
-    SDL_Surface *bg_tr_surf = SDL_LoadBMP(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/img/BG_TopLeft.bmp");
-    SDL_Surface *bg_tl_surf = SDL_LoadBMP(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/img/BG_BottomLeft.bmp");
-    SDL_Surface *bg_bl_surf = SDL_LoadBMP(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/img/BG_BottomRight.bmp");
-    SDL_Surface *bg_br_surf = SDL_LoadBMP(buffer);
-
-
-    if (bg_tr_surf == NULL ||
-        bg_tl_surf == NULL ||
-        bg_bl_surf == NULL ||
-        bg_br_surf == NULL
-    ) {
-        char errbuff[ERRMSG_SZ];
-        snprintf(
-            errbuff, STATIC_ARRMAX,
-            "Error loading menu background:\n    %s\n", 
-            SDL_GetError()
-        );
-        Sirtet_setError(errbuff);
-        return NULL;
-    }
 
+    /***** Load saved data *****/
 
-    retval->images.logo = SDL_CreateTextureFromSurface(rend, logo_surf);
-
-    retval->images.bg_topright = SDL_CreateTextureFromSurface(rend, bg_tr_surf);
-    retval->images.bg_topleft = SDL_CreateTextureFromSurface(rend, bg_tl_surf);
-    retval->images.bg_bottomright = SDL_CreateTextureFromSurface(rend, bg_br_surf);
-    retval->images.bg_bottomleft = SDL_CreateTextureFromSurface(rend, bg_bl_surf);
-    if (
-        retval->images.logo == NULL ||
-        retval->images.bg_topright == NULL ||
-        retval->images.bg_topleft == NULL ||
-        retval->images.bg_bottomright == NULL ||
-        retval->images.bg_bottomleft == NULL
-    ) {
-        char errbuff[ERRMSG_SZ];
-        snprintf(
-            errbuff, STATIC_ARRMAX,
-            "Error loading image assets:\n    %s\n", 
-            SDL_GetError()
-        );
-        Sirtet_setError(errbuff);
+    retval->hiscores = ScoreList_init(HISCORES_MAX_SIZE, HISCORES_NAME_LEN);
+    if (retval->hiscores == NULL) {
+        printf("%s", Sirtet_getError());
+        ApplicationState_deconstruct(retval);
         return NULL;
     }
 
-    SDL_FreeSurface(logo_surf);
-    SDL_FreeSurface(bg_tr_surf);
-
-
-    /***** Load sounds *****/
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/sounds/mech_kb_click4.wav");
-    retval->sounds.short_click = SirtetAudio_loadSound(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/sounds/deep_bump.wav");
-    retval->sounds.bump = SirtetAudio_loadSound(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/sounds/short_boop.wav");
-    retval->sounds.boop = SirtetAudio_loadSound(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/sounds/beep_scale_success.wav");
-    retval->sounds.boop_scale = SirtetAudio_loadSound(buffer);
-
-    strcpy(buffer, asset_folder);
-    strcat(buffer, "/sounds/beep_scale_reverse.wav");
-    retval->sounds.boop_scale_reverse = SirtetAudio_loadSound(buffer);
-
-    if (
-        SirtetAudio_soundInvalid(retval->sounds.short_click) ||
-        SirtetAudio_soundInvalid(retval->sounds.bump) ||
-        SirtetAudio_soundInvalid(retval->sounds.boop) ||
-        SirtetAudio_soundInvalid(retval->sounds.boop_scale) ||
-        SirtetAudio_soundInvalid(retval->sounds.boop_scale_reverse)
-    ) {
-        return NULL;
+    char hs_path[FILEPATH_SZ];
+    strcpy(hs_path, Sirtet_getAppdataPath());
+    strcat(hs_path, "/hiscores.bin");
+
+    // Scores saved before the binary format are read from the text file
+    // they used to be kept in, and move to the binary file on exit
+    if (ScoreList_readBinary(retval->hiscores, hs_path) != 0) {
+        strcpy(hs_path, Sirtet_getAppdataPath());
+        strcat(hs_path, "/hiscores.txt");
+        FILE *hiscore_file = fopen(hs_path, "r");
+        if (hiscore_file != NULL) {
+            ScoreList_readFile(retval->hiscores, hiscore_file);
+            fclose(hiscore_file);
+        }
     }
 
+    // Kept sorted from here on, as scores are inserted in place
+    ScoreList_sort(retval->hiscores);
 
-    /***** Load saved data *****/
-
-    retval->hiscores = ScoreList_init(HISCORES_MAX_SIZE, HISCORES_NAME_LEN);
-
-
-    char hs_path[FILEPATH_SZ];
     strcpy(hs_path, Sirtet_getAppdataPath());
-    strcat(hs_path, "/hiscores.txt");
-    FILE *hiscore_file = fopen(hs_path, "r");
-    if (hiscore_file != NULL) {
-        ScoreList_readFile(retval->hiscores, hiscore_file);
-        fclose(hiscore_file);
+    strcat(hs_path, "/hiscores.bin");
+    retval->hiscores_saver = HiscoresSaver_init(
+        hs_path, HISCORES_MAX_SIZE, HISCORES_NAME_LEN);
+    if (retval->hiscores_saver == NULL) {
+        printf("%s", Sirtet_getError());
+        ApplicationState_deconstruct(retval);
+        return NULL;
     }
+    StartupTimes_lap(&times, "hiscores");
+
+    StartupTimes_report(&times, stdout);
 
 
     return retval;
@@ -282,42 +276,39 @@ int ApplicationState_deconstruct(ApplicationState* self) {
 
     /*** Clean up & export any saved data ***/
 
-    char hs_path[FILEPATH_SZ];
-    strcpy(hs_path, Sirtet_getAppdataPath());
-    strcat(hs_path, "/hiscores.txt");
-
-    FILE* hiscore_file = fopen(hs_path, "w");
-    if (hiscore_file == NULL) {
-        Sirtet_setError("Error writing highscores to file\n");
-        return -1;
+    // Saver writes anything still pending before it stops. A failed write
+    // is reported only once everything else is cleaned up. Either may be
+    // missing if initialization failed part way
+    int status = 0;
+    if (self->hiscores_saver != NULL && self->hiscores != NULL) {
+        status = HiscoresSaver_submit(self->hiscores_saver, self->hiscores);
+    }
+    if (HiscoresSaver_deconstruct(self->hiscores_saver) != 0) {
+        status = -1;
     }
-
-    ScoreList_sort(self->hiscores);
-    ScoreList_toFile(self->hiscores, hiscore_file);
-    fclose(hiscore_file);
 
 
     /*** Free memory ***/
 
     ScoreList_deconstruct(self->hiscores);
-    SDL_DestroyWindow(self->wind);
+    // Textures belong to the renderer, so must go first. Fonts may read from
+    // the pack, so it goes after them
+    AssetManager_deconstruct(self->asset_manager);
+    AssetPack_deconstruct(self->assets);
+    LayerCache_deconstruct(self->underlay);
     SDL_DestroyRenderer(self->rend);
-    SDL_DestroyTexture(self->images.logo);
-
-    TTF_CloseFont(self->fonts.lekton_24);
-    TTF_CloseFont(self->fonts.lekton_12);
-    TTF_CloseFont(self->fonts.vt323_24);
-    TTF_CloseFont(self->fonts.vt323_12);
-
-    SirtetAudio_unloadSound(self->sounds.short_click);
-    SirtetAudio_unloadSound(self->sounds.bump);
+    SDL_DestroyWindow(self->wind);
 
-    free(self->hardware_states);
+    if (self->input_ring != NULL) {
+        InputRing_detach(self->input_ring);
+        InputRing_deconstruct(self->input_ring);
+    }
+    InputTracker_deconstruct(self->inputs);
     free(self);
 
 
     TTF_Quit();
     SDL_Quit();
     SirtetAudio_end();
-    return 0;
+    return status;
 }
@@ -11,50 +11,31 @@
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_surface.h>
 
-#include "sirtet_audio.h"
+#include "asset_manager.h"
+#include "asset_pack.h"
 #include "hiscores.h"
-
-struct fontlib {
-    TTF_Font *lekton_12;
-    TTF_Font *lekton_24;
-    TTF_Font *vt323_12;
-    TTF_Font *vt323_24;
-};
-
-struct imglib {
-    SDL_Texture *logo;
-
-    SDL_Texture *bg_topright;
-    SDL_Texture *bg_topleft;
-    SDL_Texture *bg_bottomleft;
-    SDL_Texture *bg_bottomright;
-};
-
-
-// sounds & music
-struct soundlib {
-    SirtetAudio_sound short_click;
-    SirtetAudio_sound bump;
-    SirtetAudio_sound boop;
-    SirtetAudio_sound boop_scale;
-    SirtetAudio_sound boop_scale_reverse;
-};
-
-    
+#include "hiscores_saver.h"
+#include "inputs.h"
+#include "layout.h"
+#include "layer_cache.h"
 
 // Higher-level status/state of hardware and such
 // to pass to lower-level virtual states
 typedef struct {
 
-    int *hardware_states;  // Array, indexed by SDL_Scancode, indicating # of frames a hardware input has been pressed (or released)
+    InputTracker *inputs;   // Tracks # of frames hardware inputs have been pressed (or released)
+    InputRing *input_ring;  // Key events collected as received, or NULL if unused
     SDL_Renderer *rend;     // Pointer to renderer struct in use by the application
     SDL_Window *wind;       // Pointer to SDL_Window struct
+    Layout layout;          // Cached window layout, updated on resize
+    LayerCache *underlay;   // Cached layer beneath the running overlay state
+    unsigned int render_gen;    // Incremented each time render targets are lost
 
-    ScoreList *hiscores;
+    AssetPack *assets;      // Pack assets are loaded from, or NULL if loaded from files
+    AssetManager *asset_manager;    // Fonts, images & sounds, held by the states using them
 
-    struct fontlib fonts;
-    struct imglib images;
-    struct soundlib sounds;
+    ScoreList *hiscores;
+    HiscoresSaver *hiscores_saver;  // Writes hiscores in the background
 
 } ApplicationState;
 
@@ -27,21 +27,28 @@
 #include "application_state.h"
 #include "gameover_state.h"
 #include "component_drawing.h"
+#include "cell_sprites.h"
+#include "glyph_atlas.h"
+#include "grid_cache.h"
+#include "layout.h"
+#include "layer_cache.h"
+#include "render_snapshot.h"
 #include "inputs.h"
+#include "latency.h"
 #include "state_runner.h"
 
 
-// For dimension calculations
-#define GAMEAREA_WEIGHT_W 3
-#define SIDEBAR_WEIGHT_W 1
-
-#define TOTAL_WEIGHT_W (GAMEAREA_WEIGHT_W + SIDEBAR_WEIGHT_W)
-
-
 #define OUTSET_COL (SDL_Color){0, 0, 0, 255}
 #define INSET_COL (SDL_Color){50, 50, 50, 255}
 
-#define BORDER_SIZE 24
+
+const AssetDesc GAME_ASSETS[NUM_GAME_ASSETS] = {
+    [GAME_ASSET_FONT] = {ASSET_FONT, "fonts/VT323.ttf", 24},
+    [GAME_ASSET_PLACE_SOUND] = {ASSET_SOUND, "sounds/short_boop.wav"},
+    [GAME_ASSET_SUCCESS_SOUND] = {ASSET_SOUND, "sounds/beep_scale_success.wav"},
+    [GAME_ASSET_GAMEOVER_SOUND] = {ASSET_SOUND, "sounds/beep_scale_reverse.wav"},
+    [GAME_ASSET_BUMP_SOUND] = {ASSET_SOUND, "sounds/deep_bump.wav"}
+};
 
 
 /******************************************************************************
@@ -131,17 +138,17 @@ void GameSettings_deconstruct(GameSettings *self) {
 
 /**
  * @brief Initialize the GameState, returning a pointer to it
+ * @param arena - Arena to allocate GameState (and its components) from
  * @param rend - SDL_Renderer pointer used for label creation
- * @param menu_font - TTF_Font pointer to use for creating labels
+ * @param assets - AssetManager to acquire GAME_ASSETS (the label font &
+ *                 sounds) from
  * @param settings - Pointer to a GameSettings struct describing various
  *                   details on how game should function
  */
 GameState* GameState_init(
-    SDL_Renderer *rend, TTF_Font *menu_font,
-    GameSettings *settings,
-    SirtetAudio_sound place_sound,
-    SirtetAudio_sound success_sound,
-    SirtetAudio_sound gameover_sound
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets,
+    GameSettings *settings
 ) {
 
     // settings extraction
@@ -150,10 +157,16 @@ GameState* GameState_init(
 
     GamecodeMap *keymaps = settings->keymaps;
 
+    int grid_w = 2 * block_size + block_size / 2;
+    int grid_h = 6 * block_size;
+
 
     /*** Initialize struct ***/
 
-    GameState *retval = (GameState*)malloc(sizeof(GameState));
+    GameState *retval = (GameState*)Arena_alloc(arena, sizeof(GameState));
+    if (retval == NULL) {
+        return NULL;
+    }
 
 
     /*** Tracking ***/
@@ -166,10 +179,11 @@ GameState* GameState_init(
 
     /*** Block config ***/ 
 
-    retval->block_db = BlockDb_init(256);
-    retval->game_grid = GameGrid_init(
-        2 * block_size + block_size / 2,
-        6 * block_size
+    size_t db_sz = BlockDb_requiredBytes(256);
+    size_t grid_sz = GameGrid_requiredBytes(grid_w, grid_h);
+    retval->block_db = BlockDb_build(Arena_alloc(arena, db_sz), db_sz, 256);
+    retval->game_grid = GameGrid_build(
+        Arena_alloc(arena, grid_sz), grid_sz, grid_w, grid_h
     );
 
     retval->block_size = block_size;
@@ -177,29 +191,78 @@ GameState* GameState_init(
     retval->queued_block = INVALID_BLOCK_ID;
 
     // Palette
-    retval->palette = ColorPalette_initCopy(settings->palette);
+    ColorPalette *palette = settings->palette;
+    size_t pal_sz = ColorPalette_requiredBytes(palette->name, palette->size);
+    retval->palette = ColorPalette_build(
+        Arena_alloc(arena, pal_sz), pal_sz,
+        palette->name, palette->size, palette->colors
+    );
 
     // Presets
     size_t preset_n = sizeof(long) * settings->preset_size;
     retval->num_presets = settings->preset_size;
-    retval->block_presets = (long*)malloc(preset_n);
+    retval->block_presets = (long*)Arena_alloc(arena, preset_n);
+
+
+    /*** Controls ***/
+
+    size_t map_sz = GamecodeMap_requiredBytes(keymaps->size);
+    retval->keymaps = GamecodeMap_buildCopy(
+        Arena_alloc(arena, map_sz), map_sz, keymaps
+    );
+    retval->gamecode_states = (bool*)Arena_calloc(
+        arena, (int)NUM_GAMECODES, sizeof(bool)
+    );
+    retval->gamecode_emissions = (GamecodeEmission*)Arena_calloc(
+        arena, (int)NUM_GAMECODES, sizeof(GamecodeEmission)
+    );
+
+    size_t snap_sz = SnapshotBuffer_requiredBytes(grid_w, grid_h);
+    retval->snapshots = SnapshotBuffer_build(
+        Arena_alloc(arena, snap_sz), snap_sz, grid_w, grid_h
+    );
+
+    if (
+        retval->block_db == NULL || retval->game_grid == NULL
+        || retval->palette == NULL || retval->block_presets == NULL
+        || retval->keymaps == NULL || retval->gamecode_states == NULL
+        || retval->gamecode_emissions == NULL || retval->snapshots == NULL
+    ) {
+        Sirtet_setError("Error allocating memory for GameState\n");
+        return NULL;
+    }
     memcpy(retval->block_presets, settings->block_presets, preset_n);
 
     // Initialize grid cells
     GameGrid_clear(retval->game_grid);
 
 
-    /*** Controls ***/
-
-    retval->keymaps = GamecodeMap_initCopy(keymaps);
-    retval->gamecode_states = (bool*)calloc((int)NUM_GAMECODES, sizeof(bool));
+    /*** Assets ***/
 
+    // Likely prefetched while the main menu ran, so only loaded here if not
+    if (AssetSet_acquire(
+        &retval->assets, assets, GAME_ASSETS, NUM_GAME_ASSETS) != 0
+    ) {
+        return NULL;
+    }
 
-    /*** Sounds ***/
+    AssetSet *held = &retval->assets;
+    TTF_Font *menu_font = AssetSet_font(held, GAME_ASSET_FONT);
+    retval->place_sound = AssetSet_sound(held, GAME_ASSET_PLACE_SOUND);
+    retval->success_sound = AssetSet_sound(held, GAME_ASSET_SUCCESS_SOUND);
+    retval->gameover_sound = AssetSet_sound(held, GAME_ASSET_GAMEOVER_SOUND);
+    retval->bump_sound = AssetSet_sound(held, GAME_ASSET_BUMP_SOUND);
 
-    retval->success_sound = success_sound;
-    retval->place_sound = place_sound;
-    retval->gameover_sound = gameover_sound;
+    if (
+        menu_font == NULL
+        || SirtetAudio_soundInvalid(retval->place_sound)
+        || SirtetAudio_soundInvalid(retval->success_sound)
+        || SirtetAudio_soundInvalid(retval->gameover_sound)
+        || SirtetAudio_soundInvalid(retval->bump_sound)
+    ) {
+        AssetSet_release(held);
+        return NULL;
+    }
 
 
     /*** Labels and such ***/
@@ -214,46 +277,66 @@ GameState* GameState_init(
     );
     retval->pause_texture = SDL_CreateTextureFromSurface(rend, p_surf);
     retval->next_label = SDL_CreateTextureFromSurface(rend, n_surf);
+    retval->pause_size = (SDL_Point){p_surf->w, p_surf->h};
+    retval->next_size = (SDL_Point){n_surf->w, n_surf->h};
     SDL_FreeSurface(p_surf);
     SDL_FreeSurface(n_surf);
 
-    // Re-renderable lables, that render at display time
-    retval->score_label = NULL;
-    retval->level_label = NULL;
+    // Score & level change as the game goes, so are drawn glyph-by-glyph
+    // rather than re-rendered whenever they change
+    retval->glyphs = GlyphAtlas_init(rend, menu_font);
+    if (retval->glyphs == NULL) {
+        SDL_DestroyTexture(retval->pause_texture);
+        SDL_DestroyTexture(retval->next_label);
+        AssetSet_release(held);
+        return NULL;
+    }
+
+    // Computed at first draw
+    retval->layout_gen = 0;
+
+    // Cell sprites are rendered at draw time, once cell sizes are known
+    retval->render_gen = 0;
+    retval->grid_sprites = CellSprites_init(retval->palette->size);
+    retval->next_sprites = CellSprites_init(retval->palette->size);
+    retval->grid_cache = GridCache_init();
+    if (
+        retval->grid_sprites == NULL
+        || retval->next_sprites == NULL
+        || retval->grid_cache == NULL
+    ) {
+        CellSprites_deconstruct(retval->grid_sprites);
+        CellSprites_deconstruct(retval->next_sprites);
+        GridCache_deconstruct(retval->grid_cache);
+        SDL_DestroyTexture(retval->pause_texture);
+        SDL_DestroyTexture(retval->next_label);
+        GlyphAtlas_deconstruct(retval->glyphs);
+        AssetSet_release(held);
+        return NULL;
+    }
 
     printf("Returning game state...\n");
     return retval;
 
 }
 
-// Go through process of deconstructing a GameState struct,
-// freeing any memory allocated in _init() call
+// Go through process of deconstructing a GameState struct, releasing
+// the textures created for it & the assets it held. Everything else was allocated from the
+// GameState's arena, which the StateRunner reclaims afterwards
 //
 // Takes a void* pointer that is recast to GameState* for compatability
 // with state runner
 int GameState_deconstruct(void* self) {
     GameState *game_state = (GameState*)self;
 
-
-    BlockDb_deconstruct(game_state->block_db);
-    GameGrid_deconstruct(game_state->game_grid);
-
-    // NOTE: Freed here, as they are alloc'd and copied from GameSettings
-    // If this ever changes to refer to a GameSettings pointer, this will
-    // need undone
-    free(game_state->block_presets);
-    free(game_state->palette);
-    GamecodeMap_deconstruct(game_state->keymaps);
-
-
-    free(game_state->gamecode_states);
-
-    SDL_DestroyTexture(game_state->pause_texture);
-    SDL_DestroyTexture(game_state->score_label);
     SDL_DestroyTexture(game_state->pause_texture);
     SDL_DestroyTexture(game_state->next_label);
+    GlyphAtlas_deconstruct(game_state->glyphs);
 
-    free(self);
+    CellSprites_deconstruct(game_state->grid_sprites);
+    CellSprites_deconstruct(game_state->next_sprites);
+    GridCache_deconstruct(game_state->grid_cache);
+    AssetSet_release(&game_state->assets);
 
     return 0;
 }
@@ -287,8 +370,6 @@ int updateGame(
     int level_ups = game_state->lines_this_level / LINES_PER_LEVEL;
     if (level_ups > 0) {
         game_state->level += level_ups;
-        SDL_DestroyTexture(game_state->level_label);
-        game_state->level_label = NULL;
         game_state->lines_this_level -= (level_ups * LINES_PER_LEVEL);
     }
 
@@ -342,24 +423,29 @@ int updateGame(
 
             *out_sound = game_state->gameover_sound;
 
-            SirtetAudio_playSound(app_state->sounds.boop_scale_reverse);
+            SirtetAudio_playSound(game_state->gameover_sound);
 
 
             SDL_Color act_col = {200, 50, 50, 255};
             SDL_Color dyn_col = {50, 50, 200, 255};
-            GameoverState *go_state = GameoverState_init(
-                app_state->rend, app_state->fonts.vt323_24,
-                game_state->score, app_state->hiscores,
-                &dyn_col, &act_col
-            );
+            Arena *go_arena = StateRunner_claimArena(state_runner);
+            GameoverState *go_state = NULL;
+            if (go_arena != NULL) {
+                go_state = GameoverState_init(
+                    go_arena,
+                    app_state->rend, app_state->asset_manager,
+                    game_state->score, app_state->hiscores,
+                    &dyn_col, &act_col
+                );
+            }
 
             if (go_state == NULL) {
                 printf("Error: %s", Sirtet_getError());
                 exit(1);
             }
 
-            StateRunner_addState(
-                state_runner, go_state,
+            StateRunner_addArenaState(
+                state_runner, go_arena, go_state,
                 GameoverState_run, GameoverState_deconstruct
             );
 
@@ -367,9 +453,9 @@ int updateGame(
             GameGrid_prepareAnimationAllRows(grid, 5);
 
             *primary_block = INVALID_BLOCK_ID;  // to avoid drawing
-            StateRunner_addState(
-                state_runner, (void*)game_state,
-                GameState_runGridAnimation, GameState_deconstruct
+            StateRunner_addAlias(
+                state_runner, StateRunner_currentHandle(state_runner),
+                GameState_runGridAnimation
             );
 
 
@@ -413,48 +499,62 @@ int updateGame(
         }
     }
 
-    if (Gamecode_pressed(game_state->gamecode_states, GAMECODE_MOVE_LEFT)) {
+    // Horizontal moves may repeat several times within a frame; apply
+    // left & right in the order they were input
+    GamecodeEmission *emissions = game_state->gamecode_emissions;
+    Gamecode move_order[2] = {GAMECODE_MOVE_LEFT, GAMECODE_MOVE_RIGHT};
 
-        Point new_pos = Point_translate(
-            BlockDb_getBlockPosition(db, *primary_block), (Point){-1, 0}
-        );
-
-        if (
-            GameGrid_canBlockInfoExist(
-                grid,
-                BlockDb_getBlockSize(db, *primary_block),
-                BlockDb_getBlockContents(db, *primary_block),
-                new_pos
-            )
-        ) {
-            BlockDb_setBlockPosition(db, *primary_block, new_pos);
-        }
+    GamecodeEmission left = Gamecode_emission(emissions, GAMECODE_MOVE_LEFT);
+    GamecodeEmission right = Gamecode_emission(emissions, GAMECODE_MOVE_RIGHT);
+    if (
+        left.count > 0 && right.count > 0
+        && (Sint32)(right.first_ms - left.first_ms) < 0
+    ) {
+        move_order[0] = GAMECODE_MOVE_RIGHT;
+        move_order[1] = GAMECODE_MOVE_LEFT;
     }
 
-    if (Gamecode_pressed(game_state->gamecode_states, GAMECODE_MOVE_RIGHT)) {
-        Point new_pos = Point_translate(
-            BlockDb_getBlockPosition(db, *primary_block), (Point){1, 0}
-        );
-        if (
-            GameGrid_canBlockInfoExist(
-                grid,
-                BlockDb_getBlockSize(db, *primary_block),
-                BlockDb_getBlockContents(db, *primary_block),
-                new_pos
-            )
-        ) {
+    for (int i = 0; i < 2; i++) {
+
+        int x_delta = move_order[i] == GAMECODE_MOVE_LEFT ? -1 : 1;
+        int n_moves = Gamecode_emission(emissions, move_order[i]).count;
+
+        for (int move = 0; move < n_moves; move++) {
+
+            Point new_pos = Point_translate(
+                BlockDb_getBlockPosition(db, *primary_block),
+                (Point){x_delta, 0}
+            );
+
+            if (
+                !GameGrid_canBlockInfoExist(
+                    grid,
+                    BlockDb_getBlockSize(db, *primary_block),
+                    BlockDb_getBlockContents(db, *primary_block),
+                    new_pos
+                )
+            ) {
+                break;
+            }
             BlockDb_setBlockPosition(db, *primary_block, new_pos);
         }
     }
 
     game_state->move_counter++;
+    int n_drops = Gamecode_emission(emissions, GAMECODE_MOVE_UP).count;
     if (
-        Gamecode_pressed(game_state->gamecode_states, GAMECODE_MOVE_UP)
-        ||
+        n_drops == 0
         // TODO: Include some kind of scaling function for difficulty
-        game_state->move_counter > (TARGET_FPS / (1 + game_state->level))
+        && game_state->move_counter > (TARGET_FPS / (1 + game_state->level))
     ) {
+        n_drops = 1;
+    }
+
+    if (n_drops > 0) {
         game_state->move_counter = 0;
+    }
+
+    for (int drop = 0; drop < n_drops; drop++) {
 
         Point new_pos = Point_translate(
             BlockDb_getBlockPosition(db, *primary_block),
@@ -472,6 +572,7 @@ int updateGame(
             *out_sound = game_state->place_sound;
             GameGrid_commitBlock(grid, db, *primary_block);
             *primary_block = INVALID_BLOCK_ID;
+            break;
         }
     }
 
@@ -506,10 +607,6 @@ int updateGame(
 
     score_to_inc += GameGrid_assessScore(grid, game_state->level);
 
-    if (score_to_inc > 0) {
-        SDL_DestroyTexture(game_state->score_label);
-        game_state->score_label = NULL;
-    }
     game_state->score += score_to_inc;
 
     GameGrid_prepareAnimation(grid, 3);
@@ -518,9 +615,10 @@ int updateGame(
         // NOTE: Overrides place sound, so no double playing
         *out_sound = game_state->success_sound;
 
-        SirtetAudio_playSound(app_state->sounds.boop_scale);
-        StateRunner_addState(
-            state_runner, game_state, GameState_runGridAnimation, NULL
+        SirtetAudio_playSound(game_state->success_sound);
+        StateRunner_addAlias(
+            state_runner, StateRunner_currentHandle(state_runner),
+            GameState_runGridAnimation
         );
     }
 
@@ -528,6 +626,87 @@ int updateGame(
 }
 
 
+/*=============================================================================
+ * Snapshots
+=============================================================================*/
+
+// Capture a block's draw info into a snapshot block
+static void GameState_captureBlock(
+    GameState *game_state, int block_id, SnapshotBlock *out
+) {
+    BlockDb *db = game_state->block_db;
+
+    if (block_id == INVALID_BLOCK_ID) {
+        out->valid = false;
+        return;
+    }
+
+    out->valid = true;
+    out->size = BlockDb_getBlockSize(db, block_id);
+    out->contents = BlockDb_getBlockContents(db, block_id);
+    out->position = BlockDb_getBlockPosition(db, block_id);
+    out->color = BlockDb_getBlockColor(db, block_id);
+    out->drop_distance = 0;
+}
+
+/**
+ * @brief - Publish the current state of the game for drawing. Only grid
+ *          rows changed since the snapshot slot being filled was last
+ *          written are copied.
+ * @param game_state - Pointer to struct representing game-related state data
+ */
+static void GameState_publishSnapshot(GameState *game_state) {
+
+    SnapshotBuffer *snapshots = game_state->snapshots;
+    GameGrid *grid = game_state->game_grid;
+    BlockDb *db = game_state->block_db;
+
+    for (int row = 0; row < grid->height; row++) {
+        if (GameGrid_isRowDirty(grid, row)) {
+            SnapshotBuffer_markRowChanged(snapshots, row);
+        }
+    }
+    GameGrid_clearDirty(grid);
+
+    RenderSnapshot *snapshot = SnapshotBuffer_writeSlot(snapshots);
+
+    for (int row = 0; row < grid->height; row++) {
+        if (!SnapshotBuffer_isRowStale(snapshots, row)) {
+            continue;
+        }
+
+        SDL_Color *cells = snapshot->cells + row * grid->width;
+        int visible = grid->width - grid->removed[row];
+        for (int col = 0; col < grid->width; col++) {
+            int cell_id = grid->contents[col + (row * grid->width)];
+            if (col >= visible || cell_id == INVALID_BLOCK_ID) {
+                cells[col] = (SDL_Color){0, 0, 0, 0};
+                continue;
+            }
+            cells[col] = BlockDb_getBlockColor(db, cell_id);
+        }
+    }
+
+    GameState_captureBlock(
+        game_state, game_state->primary_block, &snapshot->active
+    );
+    if (snapshot->active.valid) {
+        snapshot->active.drop_distance = GameGrid_getDropDistance(
+            grid, snapshot->active.size, snapshot->active.contents,
+            snapshot->active.position
+        );
+    }
+    GameState_captureBlock(
+        game_state, game_state->queued_block, &snapshot->next
+    );
+
+    snapshot->score = game_state->score;
+    snapshot->level = game_state->level;
+
+    SnapshotBuffer_publish(snapshots);
+}
+
+
 /*=============================================================================
  * Draw Components
 =============================================================================*/
@@ -536,24 +715,35 @@ int updateGame(
 // Draw the interface for queued block, returning the total height taken up
 int drawNextBlock(
     ApplicationState *app_state, GameState *game_state,
-    SDL_Rect *dest
+    const SnapshotBlock *next, SDL_Rect *dest
 ) {
 
-    const int block_size = BlockDb_getBlockSize(
-        game_state->block_db, game_state->queued_block
-    );
-    const int cell_size = dest->w / block_size;
-
     SDL_Rect bgrect = {dest->x, dest->y, dest->w, dest->w};
 
     SDL_Color bgcol = INSET_COL;
     SDL_SetRenderDrawColor(app_state->rend, bgcol.r, bgcol.g, bgcol.b, bgcol.a);
     SDL_RenderFillRect(app_state->rend, &bgrect);
-    
-    BlockDb_drawBlock(
-        game_state->block_db, game_state->queued_block,
-        app_state->rend, (Point){dest->x, dest->y},
+
+    if (!next->valid) {
+        return dest->w;
+    }
+
+    const int block_size = next->size;
+    const int cell_size = dest->w / block_size;
+
+    if (CellSprites_build(
+        game_state->next_sprites, app_state->rend, game_state->palette,
         cell_size, cell_size
+    ) < 0) {
+        return -1;
+    }
+
+    SDL_Color color = next->color;
+    Point topleft = {dest->x, dest->y};
+    drawBlockContents(
+        app_state->rend, game_state->next_sprites,
+        block_size, next->contents,
+        &color, &topleft, cell_size, cell_size
     );
 
     return block_size * cell_size;
@@ -562,19 +752,22 @@ int drawNextBlock(
 // Draw the interface area displaying level & score, returning height taken
 int drawScoreArea(
     ApplicationState *app_state, GameState *game_state,
+    const char *score_text, const char *level_text,
     SDL_Rect *dest
 ) {
 
     int total_h = 0;
     int max_w = 0;
 
-    int score_h, score_w;
-    SDL_QueryTexture(game_state->score_label, NULL, NULL, &score_w, &score_h);
+    SDL_Point score_size = GlyphAtlas_measure(game_state->glyphs, score_text);
+    int score_w = score_size.x;
+    int score_h = score_size.y;
     max_w = score_w > max_w ? score_w : max_w;
     total_h += score_h;
 
-    int lvl_h, lvl_w;
-    SDL_QueryTexture(game_state->level_label, NULL, NULL, &lvl_w, &lvl_h);
+    SDL_Point level_size = GlyphAtlas_measure(game_state->glyphs, level_text);
+    int lvl_w = level_size.x;
+    int lvl_h = level_size.y;
     max_w = lvl_w > max_w ? lvl_w : max_w;
     total_h += lvl_h;
 
@@ -586,18 +779,27 @@ int drawScoreArea(
 
     // now actually draw the labels
 
+    SDL_Color txtcol = {255, 255, 255, 255};
 
     SDL_Rect dstrect = {dest->x, dest->y};
 
     dstrect.w = max_w;
     dstrect.h = score_h;
-    SDL_RenderCopy(app_state->rend, game_state->score_label, NULL, &dstrect);
+    if (GlyphAtlas_draw(
+        game_state->glyphs, app_state->rend, score_text, txtcol, &dstrect
+    ) != 0) {
+        return -1;
+    }
     dstrect.y += dstrect.h;
 
     // dstrect.w = lvl_w;
     dstrect.w = max_w;
     dstrect.h = lvl_h;
-    SDL_RenderCopy(app_state->rend, game_state->level_label, NULL, &dstrect);
+    if (GlyphAtlas_draw(
+        game_state->glyphs, app_state->rend, level_text, txtcol, &dstrect
+    ) != 0) {
+        return -1;
+    }
 
     return total_h;
 }
@@ -605,15 +807,15 @@ int drawScoreArea(
 // Draw supplmental game info (Score, on deck, flair, etc.)
 int drawInterface(
     ApplicationState *app_state, GameState *game_state,
+    const RenderSnapshot *snapshot,
     SDL_Rect *draw_window, SDL_Rect *actual_draw
 ) {
 
     // Convenience unpacking
     SDL_Renderer *rend = app_state->rend;
-    TTF_Font *menu_font = game_state->menu_font;
 
-    int score = game_state->score;
-    int level = game_state->level;
+    int score = snapshot->score;
+    int level = snapshot->level;
 
     // helper vars
     char score_buffer[32];  // 32 is overkill but just in case...
@@ -622,54 +824,11 @@ int drawInterface(
     SDL_Color bgcol = INSET_COL;
     SDL_SetRenderDrawColor(rend, bgcol.r, bgcol.g, bgcol.b, bgcol.a);
 
-    int wind_w, wind_h;
-    SDL_GetWindowSize(app_state->wind, &wind_w, &wind_h);
-
 
     /***** Score + Level *****/
 
-    // NOTE: Relies on updateGame(...) invalidating score texture on score change
-    if (game_state->score_label == NULL) {
-        snprintf(score_buffer, 32, "Score: %d", score);
-        SDL_Surface *surf = TTF_RenderText_Solid(
-            menu_font, score_buffer, (SDL_Color){255, 255, 255}
-        );
-        game_state->score_label = SDL_CreateTextureFromSurface(rend, surf);
-        SDL_FreeSurface(surf);
-
-    }
-
-    // NOTE: Relies on updateGame(...) invalidating level texture on level change
-    if (game_state->level_label == NULL) {
-        snprintf(level_buffer, 16, "Level: %d", level);
-
-        SDL_Surface *lvl_surf = TTF_RenderText_Solid(
-            menu_font, level_buffer, (SDL_Color){255, 255, 255}
-        );
-        if (lvl_surf == NULL) {
-            char buff[128];
-            snprintf(
-                buff, 128,
-                "Error rendering text for level label: %s\n",
-                TTF_GetError()
-            );
-            Sirtet_setError(buff);
-            return -1;
-        }
-
-        game_state->level_label = SDL_CreateTextureFromSurface(rend, lvl_surf);
-        if (game_state->level_label == NULL) {
-            char buff[128];
-            snprintf(
-                buff, 128,
-                "Error rendering text for level label: %s\n",
-                SDL_GetError()
-            );
-            Sirtet_setError(buff);
-            return -1;
-        }
-        SDL_FreeSurface(lvl_surf);
-    }
+    snprintf(score_buffer, 32, "Score: %d", score);
+    snprintf(level_buffer, 16, "Level: %d", level);
 
     int yoffset = draw_window->y;
     SDL_Rect dstrect = {
@@ -679,14 +838,20 @@ int drawInterface(
         .h=draw_window->h
     };
 
-    yoffset += drawScoreArea(app_state, game_state, &dstrect) + 24;
+    int score_h = drawScoreArea(
+        app_state, game_state, score_buffer, level_buffer, &dstrect
+    );
+    if (score_h < 0) {
+        return -1;
+    }
+    yoffset += score_h + 24;
 
     /***** Next Up *****/
 
-    dstrect = (SDL_Rect){.x=draw_window->x, .y=yoffset};
-    SDL_QueryTexture(
-        game_state->next_label, NULL, NULL, &dstrect.w, &dstrect.h
-    );
+    dstrect = (SDL_Rect){
+        .x=draw_window->x, .y=yoffset,
+        .w=game_state->next_size.x, .h=game_state->next_size.y
+    };
     SDL_RenderCopy(rend, game_state->next_label, NULL, &dstrect);
 
     yoffset += dstrect.h;
@@ -697,7 +862,13 @@ int drawInterface(
         .w=draw_window->w,
         .h=draw_window->h
     };
-    yoffset += drawNextBlock(app_state, game_state, &dstrect);
+    int next_h = drawNextBlock(
+        app_state, game_state, &snapshot->next, &dstrect
+    );
+    if (next_h < 0) {
+        return -1;
+    }
+    yoffset += next_h;
 
 
     if (actual_draw != NULL) {
@@ -711,31 +882,42 @@ int drawInterface(
     return 0;
 }
 
-// Draw game area, including primary block and grid
+/**
+ * @brief - Drop every cached rendering after render targets (or the renderer
+ *          itself) were lost, re-rendering the glyph atlas right away. The
+ *          rest are rebuilt as they're drawn
+ * @return 0 on success, -1 on error
+ */
+static int GameState_resetRenderCaches(
+    GameState *game_state, ApplicationState *app_state
+) {
+    CellSprites_invalidate(game_state->grid_sprites);
+    CellSprites_invalidate(game_state->next_sprites);
+    GridCache_invalidate(game_state->grid_cache);
+
+    GlyphAtlas *glyphs = GlyphAtlas_init(app_state->rend, game_state->menu_font);
+    if (glyphs == NULL) {
+        return -1;
+    }
+    GlyphAtlas_deconstruct(game_state->glyphs);
+    game_state->glyphs = glyphs;
+
+    game_state->render_gen = app_state->render_gen;
+    return 0;
+}
 
 /**
- * @brief - Draw the game area, including the grid, primary block, and any
- *          supplementary visual elements.
- * @param app_state - Pointer to struct representing application-wide data
+ * @brief - Recompute the GameState's draw dimensions from the application's
+ *          layout. The grid attempts to fill the entire requested game area,
+ *          but maintains its aspect ratio and keeps to square cells, possibly
+ *          drawing into a smaller space than requested.
  * @param game_state - Pointer to struct representing game-related state data
- * @param draw_window - SDL_Rect describing the area in which to draw the grid
- *                      Note that this method will attempt to fill the entire
- *                      rectangle if possible, but will maintain the grid's
- *                      aspect ratio and keep to square cells, possibly
- *                      drawing into a smaller space than described.
- * @param actual_draw - Pointer to SDL_Rect to write out final write dimensions
- *                      Ignored if NULL
+ * @param layout - Pointer to application Layout to fit to
  */
-int drawGameArea(
-    ApplicationState *app_state, GameState *game_state, SDL_Rect *draw_window,
-    SDL_Rect *actual_draw
-) {
+static void GameState_fitLayout(GameState *game_state, Layout *layout) {
 
-    /* Unpacking */
-    SDL_Renderer *rend = app_state->rend;
-    int primary_block = game_state->primary_block;
-    BlockDb *db = game_state->block_db;
     GameGrid *grid = game_state->game_grid;
+    SDL_Rect *draw_window = &layout->game_area;
 
     int cellsize_w = draw_window->w / grid->width;
     int cellsize_h = draw_window->h / grid->height;
@@ -751,9 +933,35 @@ int drawGameArea(
     final_dims.x = draw_window->x + (w_pad / 2);
     final_dims.y = draw_window->y + (h_pad / 2);
 
-    if (actual_draw != NULL) {
-        *actual_draw = final_dims;
-    }
+    game_state->cell_size = cellsize;
+    game_state->game_area = final_dims;
+    game_state->sidebar_area = (SDL_Rect){
+        .x=layout->sidebar_area.x,
+        .y=final_dims.y,
+        .w=layout->sidebar_area.w,
+        .h=final_dims.h
+    };
+    game_state->layout_gen = layout->generation;
+}
+
+/**
+ * @brief - Draw the game area, including the grid, primary block, and any
+ *          supplementary visual elements, into the GameState's fitted area
+ * @param app_state - Pointer to struct representing application-wide data
+ * @param game_state - Pointer to struct representing game-related state data
+ * @param snapshot - Pointer to snapshot of game to draw
+ */
+int drawGameArea(
+    ApplicationState *app_state, GameState *game_state,
+    const RenderSnapshot *snapshot
+) {
+
+    /* Unpacking */
+    SDL_Renderer *rend = app_state->rend;
+    const SnapshotBlock *active = &snapshot->active;
+
+    int cellsize = game_state->cell_size;
+    SDL_Rect final_dims = game_state->game_area;
 
     Point origin = {.x=final_dims.x, .y=final_dims.y};
 
@@ -761,21 +969,33 @@ int drawGameArea(
     SDL_SetRenderDrawColor(rend, col.r, col.g, col.b, col.a);
     SDL_RenderFillRect(rend, &final_dims);
 
+    // No-op unless cell size or palette has changed
+    CellSprites *sprites = game_state->grid_sprites;
     int retval;
-    retval = GameGrid_drawGrid(grid, rend, db, origin, cellsize, cellsize);
+    retval = CellSprites_build(
+        sprites, rend, game_state->palette, cellsize, cellsize
+    );
     if (retval < 0) {
         return retval;
     }
 
-    /*** Block drawing ***/
+    // Only rows changed since last drawn snapshot are re-rendered
+    retval = GridCache_draw(
+        game_state->grid_cache, snapshot, rend, sprites,
+        origin, cellsize, cellsize
+    );
+    if (retval < 0) {
+        return retval;
+    }
 
-    if (primary_block != INVALID_BLOCK_ID) {
+    /*** Block drawing ***/
 
+    if (active->valid) {
 
-        int block_size = BlockDb_getBlockSize(db, primary_block);
-        long block_contents = BlockDb_getBlockContents(db, primary_block);
-        Point block_pos = BlockDb_getBlockPosition(db, primary_block);
-        SDL_Color block_col = BlockDb_getBlockColor(db, primary_block);
+        int block_size = active->size;
+        long block_contents = active->contents;
+        Point block_pos = active->position;
+        SDL_Color block_col = active->color;
 
         Point topleft = {
             .x=origin.x + cellsize * (block_pos.x - block_size / 2),
@@ -783,19 +1003,19 @@ int drawGameArea(
         };
 
         // projected block
-        int dist = GameGrid_getDropDistance(grid, block_size, block_contents, block_pos);
+        int dist = active->drop_distance;
         SDL_Color drawcol = {block_col.r, block_col.g, block_col.b, 64};
         Point drawpos = {topleft.x, topleft.y - (dist * cellsize)};
 
         drawBlockContents(
-            rend, block_size, block_contents,
+            rend, sprites, block_size, block_contents,
             &drawcol, &drawpos,
             cellsize, cellsize
         );
 
         // current block
         drawBlockContents(
-            rend, block_size, block_contents,
+            rend, sprites, block_size, block_contents,
             &block_col, &topleft,
             cellsize, cellsize
         );
@@ -804,7 +1024,8 @@ int drawGameArea(
     return 0;
 }
 
-// Base draw method for GameState - draws game area and sidebar information
+// Base draw method for GameState - draws game area and sidebar information,
+// as of the most recently published snapshot
 int drawGame(ApplicationState *app_state, GameState *game_state) {
 
     SDL_Renderer *rend = app_state->rend;
@@ -812,39 +1033,33 @@ int drawGame(ApplicationState *app_state, GameState *game_state) {
     SDL_SetRenderDrawColor(rend, 10, 20, 30, 255);
     SDL_RenderClear(rend);
 
-    int wind_w, wind_h;
-    SDL_GetWindowSize(app_state->wind, &wind_w, &wind_h);
+    const RenderSnapshot *snapshot = SnapshotBuffer_acquire(
+        game_state->snapshots
+    );
+    if (snapshot == NULL) {
+        return 0;
+    }
 
+    if (game_state->layout_gen != app_state->layout.generation) {
+        GameState_fitLayout(game_state, &app_state->layout);
+    }
+    if (game_state->render_gen != app_state->render_gen) {
+        if (GameState_resetRenderCaches(game_state, app_state) < 0) {
+            return -1;
+        }
+    }
 
     int retval = 0;
 
-    int area_w = (GAMEAREA_WEIGHT_W * wind_w) / TOTAL_WEIGHT_W;
-    int area_h = wind_h - (2 * BORDER_SIZE);
-
     /***** Game Area *****/
-    SDL_Rect game_area_request = {
-        .x=(wind_w - area_w) / 2,
-        .y=(wind_h - area_h) / 2,
-        .w=area_w,
-        .h=area_h
-    };
-
-
-    SDL_Rect game_area;
-    retval = drawGameArea(app_state, game_state, &game_area_request, &game_area);
+    retval = drawGameArea(app_state, game_state, snapshot);
     if (retval < 0) { return retval; }
 
 
     /***** Sidebar/Interface *****/
-    SDL_Rect sidebar_area_request = {
-        .x=(GAMEAREA_WEIGHT_W * wind_w) / TOTAL_WEIGHT_W,
-        .y=game_area.y,
-        .w=(SIDEBAR_WEIGHT_W * (wind_w - 2 * BORDER_SIZE)) / TOTAL_WEIGHT_W,
-        .h=game_area.h
-    };
-    SDL_Rect sidebar_area;
-
-    retval = drawInterface(app_state, game_state, &sidebar_area_request, &sidebar_area);
+    retval = drawInterface(
+        app_state, game_state, snapshot, &game_state->sidebar_area, NULL
+    );
     if (retval < 0) { return retval; }
 
     return 0;
@@ -868,14 +1083,17 @@ int GameState_run(
 
     /* Relevant variable extraction */
 
-    int *hardware_states = application_state->hardware_states;
+    InputTracker *inputs = application_state->inputs;
     GamecodeMap *keymaps = game_state->keymaps;
 
 
 
     /*** PROCESS INPUTS ***/
 
-    processGamecodes(game_state->gamecode_states, hardware_states, keymaps);
+    processGamecodes(
+        game_state->gamecode_states, game_state->gamecode_emissions,
+        inputs, keymaps
+    );
 
     /*** UPDATE ***/
 
@@ -894,10 +1112,15 @@ int GameState_run(
     if (update_status == -1) {
         return -1;
     }
+    GameState_publishSnapshot(game_state);
+    Latency_effect();
 
     if (Gamecode_pressed(game_state->gamecode_states, GAMECODE_PAUSE)) {
-        toplay = application_state->sounds.bump;
-        StateRunner_addState(state_runner, game_state, GameState_runPaused, NULL);
+        toplay = game_state->bump_sound;
+        StateRunner_addOverlay(
+            state_runner, StateRunner_currentHandle(state_runner),
+            GameState_runPaused
+        );
     }
 
 
@@ -925,14 +1148,14 @@ int GameState_runPaused(StateRunner *state_runner, void *application_data, void
 
     /* Relevant variable extraction */
     SDL_Renderer *rend = application_state->rend;
-    int *hardware_states = application_state->hardware_states;
+    InputTracker *inputs = application_state->inputs;
     GamecodeMap *keymaps = game_state->keymaps;
 
 
 
 
     /***** PROCESS INPUTS *****/
-    processGamecodes(game_state->gamecode_states, hardware_states, keymaps);
+    processGamecodes(game_state->gamecode_states, NULL, inputs, keymaps);
 
     if (Gamecode_pressed(game_state->gamecode_states, GAMECODE_PAUSE)) {
         StateRunner_setPopCount(state_runner, 1);
@@ -940,11 +1163,27 @@ int GameState_runPaused(StateRunner *state_runner, void *application_data, void
     }
 
     /***** DRAWING *****/
-    drawGame(application_state, game_state);
+
+    // The game beneath doesn't change while paused, so is only rendered
+    // (into the underlay cache) when uncovered, and the frame is only
+    // presented when something is redrawn
+    bool underlay_stale = StateRunner_underlayStale(state_runner);
+    if (StateRunner_skipDraw(state_runner, underlay_stale)) {
+        return 0;
+    }
+
+    if (LayerCache_begin(application_state->underlay, rend, underlay_stale)) {
+        drawGame(application_state, game_state);
+    }
+    if (LayerCache_end(application_state->underlay, rend) < 0) {
+        return -1;
+    }
 
     // Pause overlay
-    SDL_Rect dstrect = {.x=10, .y=10};
-    SDL_QueryTexture(game_state->pause_texture, NULL, NULL, &dstrect.w, &dstrect.h);
+    SDL_Rect dstrect = {
+        .x=10, .y=10,
+        .w=game_state->pause_size.x, .h=game_state->pause_size.y
+    };
     SDL_RenderCopy(rend, game_state->pause_texture, NULL, &dstrect);
 
 
@@ -963,15 +1202,18 @@ int GameState_runGridAnimation(
 
     // extraction
     GameGrid *grid = game_state->game_grid;
-    int *hardware_states = app_state->hardware_states;
+    InputTracker *inputs = app_state->inputs;
     GamecodeMap *keymaps = game_state->keymaps;
 
 
     /***** PROCESS INPUTS *****/
-    processGamecodes(game_state->gamecode_states, hardware_states, keymaps);
+    processGamecodes(game_state->gamecode_states, NULL, inputs, keymaps);
 
     if (Gamecode_pressed(game_state->gamecode_states, GAMECODE_PAUSE)) {
-        StateRunner_addState(state_runner, game_state, GameState_runPaused, NULL);
+        StateRunner_addOverlay(
+            state_runner, StateRunner_currentHandle(state_runner),
+            GameState_runPaused
+        );
     }
 
     /***** UPDATE *****/
@@ -981,6 +1223,7 @@ int GameState_runGridAnimation(
         StateRunner_setPopCount(state_runner, 1);
         return 0;
     }
+    GameState_publishSnapshot(game_state);
 
     /***** DRAW *****/
     drawGame(app_state, game_state);
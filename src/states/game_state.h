@@ -17,13 +17,36 @@
 #include "grid.h"
 #include "inputs.h"
 #include "colorpalette.h"
+#include "cell_sprites.h"
+#include "glyph_atlas.h"
+#include "grid_cache.h"
+#include "layout.h"
+#include "render_snapshot.h"
 
+#include "arena.h"
+
+#include "asset_manager.h"
 #include "sirtet_audio.h"
 #include "state_runner.h"
 
 #define LINES_PER_LEVEL 10
 
 
+// Assets a GameState holds for as long as it lives, as indices into
+// GAME_ASSETS (and its AssetSet)
+typedef enum {
+    GAME_ASSET_FONT,
+    GAME_ASSET_PLACE_SOUND,     // block placed on grid
+    GAME_ASSET_SUCCESS_SOUND,   // line complete
+    GAME_ASSET_GAMEOVER_SOUND,  // game over
+    GAME_ASSET_BUMP_SOUND,      // block blocked by the grid's edge
+    NUM_GAME_ASSETS
+} GameAsset;
+
+// Declared for states ahead of a GameState to prefetch
+extern const AssetDesc GAME_ASSETS[NUM_GAME_ASSETS];
+
+
 // A struct meant to segregate game initialization settings
 typedef struct {
 
@@ -47,6 +70,7 @@ typedef struct {
 
     GamecodeMap *keymaps;       // collection of hardware -> gamecode key mappings
     bool *gamecode_states;      // boolean flag array for gamecodes (indexed by Gamecode)
+    GamecodeEmission *gamecode_emissions;   // Emit counts & times (indexed by Gamecode)
 
     int move_counter;           // number of frames since last movement
     int score;                  // Number of points accumulated
@@ -67,19 +91,38 @@ typedef struct {
     ColorPalette *palette;
 
     /* Sounds */
+    AssetSet assets;            // References on GAME_ASSETS
     SirtetAudio_sound place_sound;
     SirtetAudio_sound success_sound;
     SirtetAudio_sound gameover_sound;
-
+    SirtetAudio_sound bump_sound;
 
 
     /* State/structs for display */
     TTF_Font *menu_font;
     SDL_Texture *pause_texture; // Texture with "pause" text
 
-    SDL_Texture *score_label;
-    SDL_Texture *level_label;
     SDL_Texture *next_label;
+    GlyphAtlas *glyphs;         // menu_font glyphs, for score & level labels
+
+    // Label dimensions, recorded when each label is rendered
+    SDL_Point pause_size;
+    SDL_Point next_size;
+
+    /* Draw dimensions, recomputed only when application Layout changes */
+    unsigned int layout_gen;    // Layout generation below were computed for
+    int cell_size;              // Size, in pixels, of each grid cell
+    SDL_Rect game_area;         // Grid area, fit to square cells
+    SDL_Rect sidebar_area;      // Sidebar area, aligned with grid
+
+    /* Cached renderings, dropped whenever render targets are lost */
+    unsigned int render_gen;    // Render generation caches below are valid for
+    CellSprites *grid_sprites;  // Cached cells at game area cell size
+    CellSprites *next_sprites;  // Cached cells at "next block" cell size
+    GridCache *grid_cache;      // Cached rendering of committed grid cells
+
+    // Game as of each update, for drawing. Drawing reads only from these
+    SnapshotBuffer *snapshots;
 
 } GameState;
 
@@ -101,15 +144,15 @@ int GameSettings_setPalette(GameSettings *self, ColorPalette *palette);
  * GameState
 ******************************************************************************/
 
-// Initialize and return a pointer for GameState
+// Initialize and return a pointer for GameState, allocated from arena.
+// Holds GAME_ASSETS from assets until deconstructed
 GameState* GameState_init(
-    SDL_Renderer *rend, TTF_Font *menu_font,
-    GameSettings *settings,
-    SirtetAudio_sound place_sound,    // block placed on grid
-    SirtetAudio_sound success_sound,  // line complete
-    SirtetAudio_sound gameover_sound  // game over
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets,
+    GameSettings *settings
 );
-// Deconstruct a GameState by pointer reference
+// Deconstruct a GameState by pointer reference, releasing its textures & assets.
+// Its memory is released along with its arena
 int GameState_deconstruct(void* self);
 
 
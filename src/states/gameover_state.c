@@ -3,12 +3,15 @@
 #include <SDL2/SDL_ttf.h>
 #include <stdio.h>
 
+#include "asset_manager.h"
 #include "hiscores.h"
+#include "hiscores_saver.h"
 #include "inputs.h"
 #include "sirtet.h"
 #include "utilities.h"
 #include "gameover_state.h"
 #include "application_state.h"
+#include "mainmenu_state.h"
 #include "state_runner.h"
 
 
@@ -18,45 +21,66 @@
 ******************************************************************************/
 
 
+// Assets a GameoverState holds for as long as it lives
+static const AssetDesc gameover_assets[1] = {
+    {ASSET_FONT, "fonts/VT323.ttf", 24}
+};
+
+
 GameoverState* GameoverState_init(
-    SDL_Renderer *rend, TTF_Font *lbl_font,
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets,
     int player_score, ScoreList *hiscores,
     const SDL_Color *static_col, const SDL_Color *dynamic_col
 ) {
 
-    GameoverState *retval = calloc(1, sizeof(GameoverState));
+    GameoverState *retval = Arena_calloc(arena, 1, sizeof(GameoverState));
     if (retval == NULL) {
         Sirtet_setError("Error allocating memory for GameoverState\n");
         return NULL;
     }
 
+    if (AssetSet_acquire(&retval->assets, assets, gameover_assets, 1) != 0) {
+        return NULL;
+    }
+    TTF_Font *lbl_font = AssetSet_font(&retval->assets, 0);
+    if (lbl_font == NULL) {
+        goto fail;
+    }
 
-    // For good measure - likely already sorted but just in case
+    // The main menu is back on top once a name is entered, so have its art
+    // decoded meanwhile rather than on its first frame
+    if (MainMenuState_prefetchArt(assets) != 0) {
+        printf("%s", Sirtet_getError());
+    }
+
+
+    // Hiscores are kept sorted, so player's rank is a search away
     retval->hiscores = hiscores;
-    ScoreList_sort(hiscores);
 
-    retval->player_name = calloc(hiscores->namelen + 1, sizeof(char));
+    retval->player_name = Arena_calloc(
+        arena, hiscores->namelen + 1, sizeof(char));
+    if (retval->player_name == NULL) {
+        Sirtet_setError("Error allocating memory for GameoverState\n");
+        goto fail;
+    }
     memset(retval->player_name, '_', 3 * sizeof(char));
     retval->name_idx = 0;
     retval->player_score = player_score;
 
-    // NOTE: Could binary search, but likely not needed
-    retval->player_rank = hiscores->len;
-    for (int i = 0; i < hiscores->len; i++) {
-        int loopscore;
-        ScoreList_get(hiscores, i, NULL, &loopscore);
-
-        if (player_score > loopscore) {
-            retval->player_rank = i;
-            break;
-        }
-    }
+    retval->player_rank = ScoreList_rankOf(hiscores, player_score);
 
 
     /*** General config ***/
 
-    retval->menucode_states = calloc(NUM_MENUCODES, sizeof(bool));
-    retval->mcodes = MenucodeMap_init(MAX_MENUCODE_MAPS);
+    size_t map_sz = MenucodeMap_requiredBytes(MAX_MENUCODE_MAPS);
+    retval->menucode_states = Arena_calloc(arena, NUM_MENUCODES, sizeof(bool));
+    retval->mcodes = MenucodeMap_build(
+        Arena_alloc(arena, map_sz), map_sz, MAX_MENUCODE_MAPS);
+    if (retval->menucode_states == NULL || retval->mcodes == NULL) {
+        Sirtet_setError("Error allocating memory for GameoverState\n");
+        goto fail;
+    }
     MenucodePreset_standard(retval->mcodes, 1, 1, 1);
     MenucodePreset_upperAlpha(retval->mcodes, 1, 1, 1);
 
@@ -72,7 +96,11 @@ GameoverState* GameoverState_init(
 
     char scorebuff[12];
     char rankbuff[12];
-    char *namebuff = malloc((hiscores->namelen + 1) * sizeof(char));
+    char *namebuff = Arena_alloc(arena, (hiscores->namelen + 1) * sizeof(char));
+    if (namebuff == NULL) {
+        Sirtet_setError("Error allocating memory for GameoverState\n");
+        goto fail;
+    }
     memset(namebuff, '_', hiscores->namelen * sizeof(char));
     namebuff[hiscores->namelen] = '\0';
 
@@ -95,13 +123,22 @@ GameoverState* GameoverState_init(
             TTF_GetError()
         );
         Sirtet_setError(buff);
-        return NULL;
+        SDL_FreeSurface(pscoresurf);
+        SDL_FreeSurface(pnamesurf);
+        SDL_FreeSurface(pranksurf);
+        goto fail;
     }
 
     retval->pname_lbl = SDL_CreateTextureFromSurface(rend, pnamesurf);
     retval->pscore_lbl = SDL_CreateTextureFromSurface(rend, pscoresurf);
     retval->prank_lbl = SDL_CreateTextureFromSurface(rend, pranksurf);
+    retval->pname_size = (SDL_Point){pnamesurf->w, pnamesurf->h};
+    retval->pscore_size = (SDL_Point){pscoresurf->w, pscoresurf->h};
+    retval->prank_size = (SDL_Point){pranksurf->w, pranksurf->h};
 
+    SDL_FreeSurface(pscoresurf);
+    SDL_FreeSurface(pnamesurf);
+    SDL_FreeSurface(pranksurf);
 
     if (
         retval->pname_lbl == NULL ||
@@ -114,13 +151,10 @@ GameoverState* GameoverState_init(
             "Error creating player labels in GameoverState:\n%s\n",
             SDL_GetError()
         );
-        return NULL;
+        Sirtet_setError(buff);
+        goto fail;
     }
 
-    SDL_FreeSurface(pscoresurf);
-    SDL_FreeSurface(pnamesurf);
-    SDL_FreeSurface(pranksurf);
-
 
     /** General Scores **/
 
@@ -134,23 +168,29 @@ GameoverState* GameoverState_init(
 
     retval->top_labels = NULL;
     if (top_n > 0) {
-        retval->top_labels = ScoreDisplay_init(
+        size_t lbl_sz = ScoreDisplay_requiredBytes(hiscores, top_n);
+        retval->top_labels = ScoreDisplay_build(
+            Arena_alloc(arena, lbl_sz), lbl_sz,
             hiscores,
             0,
             top_n - 1,
             1,
-            rend, lbl_font, static_col
+            top_n,
+            lbl_font, static_col
         );
     }
 
     retval->bottom_labels = NULL;
     if (bot_n > 0) {
-        retval->bottom_labels = ScoreDisplay_init(
+        size_t lbl_sz = ScoreDisplay_requiredBytes(hiscores, bot_n);
+        retval->bottom_labels = ScoreDisplay_build(
+            Arena_alloc(arena, lbl_sz), lbl_sz,
             hiscores,
             top_n,
             top_n + bot_n - 1,
             retval->player_rank + 2,
-            rend, lbl_font, static_col
+            bot_n,
+            lbl_font, static_col
         );
 
         if (retval->bottom_labels == NULL) {
@@ -162,6 +202,21 @@ GameoverState* GameoverState_init(
     /***/
 
     return retval;
+
+// Anything failing once assets are held. Memory belongs to the arena, but
+// any labels made so far don't
+fail:
+    if (retval->prank_lbl != NULL) {
+        SDL_DestroyTexture(retval->prank_lbl);
+    }
+    if (retval->pscore_lbl != NULL) {
+        SDL_DestroyTexture(retval->pscore_lbl);
+    }
+    if (retval->pname_lbl != NULL) {
+        SDL_DestroyTexture(retval->pname_lbl);
+    }
+    AssetSet_release(&retval->assets);
+    return NULL;
 }
 
 
@@ -169,26 +224,20 @@ int GameoverState_deconstruct(void *self) {
 
     GameoverState *hs = (GameoverState*)self;
 
-
-    free(hs->player_name);
-
+    // Memory belongs to the state's arena - only textures need released
     SDL_DestroyTexture(hs->prank_lbl);
     SDL_DestroyTexture(hs->pscore_lbl);
     SDL_DestroyTexture(hs->pname_lbl);
 
     if (hs->top_labels != NULL) {
-        ScoreDisplay_deconstruct(hs->top_labels);
+        ScoreDisplay_destroyLabels(hs->top_labels);
     }
 
     if (hs->bottom_labels != NULL) {
-        ScoreDisplay_deconstruct(hs->bottom_labels);
+        ScoreDisplay_destroyLabels(hs->bottom_labels);
     }
 
-
-    MenucodeMap_deconstruct(hs->mcodes);
-    free(hs->menucode_states);
-
-    free(self);
+    AssetSet_release(&hs->assets);
     return 0;
 
 }
@@ -221,7 +270,7 @@ int GameoverState_run(StateRunner *runner, void *app_data, void *state_data) {
 
     processMenucodes(
         go_state->menucode_states,
-        app_state->hardware_states,
+        app_state->inputs,
         go_state->mcodes
     );
 
@@ -272,6 +321,7 @@ int GameoverState_run(StateRunner *runner, void *app_data, void *state_data) {
             }
 
             go_state->pname_lbl = SDL_CreateTextureFromSurface(rend, namesurf);
+            go_state->pname_size = (SDL_Point){namesurf->w, namesurf->h};
             SDL_FreeSurface(namesurf);
             if (go_state->pname_lbl == NULL) {
                 char buff[128];
@@ -295,10 +345,11 @@ int GameoverState_run(StateRunner *runner, void *app_data, void *state_data) {
         Menucode_pressed(go_state->menucode_states, MENUCODE_SELECT)
     ) {
         // submit score
-        ScoreList_add(
+        ScoreList_insert(
             go_state->hiscores, go_state->player_name, go_state->player_score);
-
-        ScoreList_sort(go_state->hiscores);
+        if (HiscoresSaver_submit(app_state->hiscores_saver, go_state->hiscores) != 0) {
+            return -1;
+        }
         StateRunner_setPopCount(runner, 1);
     }
 
@@ -306,9 +357,20 @@ int GameoverState_run(StateRunner *runner, void *app_data, void *state_data) {
 
     /*** DRAW ***/
 
+    // Display only changes in response to menu input (name entry)
+    bool changed = false;
+    for (int mc = 0; mc < NUM_MENUCODES; mc++) {
+        changed = changed || Menucode_pressed(go_state->menucode_states, mc);
+    }
+    if (StateRunner_skipDraw(runner, changed)) {
+        return 0;
+    }
+
+    SDL_SetRenderDrawColor(rend, 10, 20, 30, 255);
+    SDL_RenderClear(rend);
+
     // top
-    SDL_Rect drawdst = {.x=0, .y=0, .w=0, .h=0};
-    SDL_GetWindowSize(app_state->wind, &drawdst.w, &drawdst.h);
+    SDL_Rect drawdst = app_state->layout.window;
     SDL_Rect outrect = {0, 0, drawdst.w, 0};
 
     if (go_state->top_labels != NULL) {
@@ -323,12 +385,12 @@ int GameoverState_run(StateRunner *runner, void *app_data, void *state_data) {
     SDL_Rect prank_dst, pname_dst, pscore_dst;
     prank_dst.y = pname_dst.y = pscore_dst.y = drawdst.y;
 
-    SDL_QueryTexture(
-        go_state->pname_lbl, NULL, NULL, &pname_dst.w, &pname_dst.h);
-    SDL_QueryTexture(
-        go_state->prank_lbl, NULL, NULL, &prank_dst.w, &prank_dst.h);
-    SDL_QueryTexture(
-        go_state->pscore_lbl, NULL, NULL, &pscore_dst.w, &pscore_dst.h);
+    pname_dst.w = go_state->pname_size.x;
+    pname_dst.h = go_state->pname_size.y;
+    prank_dst.w = go_state->prank_size.x;
+    prank_dst.h = go_state->prank_size.y;
+    pscore_dst.w = go_state->pscore_size.x;
+    pscore_dst.h = go_state->pscore_size.y;
 
     int plab_h = MAX3(pname_dst.h, prank_dst.h, pscore_dst.h);
     pname_dst.h = prank_dst.h = pscore_dst.h = plab_h;
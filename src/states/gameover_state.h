@@ -13,6 +13,8 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "arena.h"
+#include "asset_manager.h"
 #include "hiscores.h"
 #include "state_runner.h"
 #include "inputs.h"
@@ -35,6 +37,10 @@ typedef struct {
     SDL_Texture *pname_lbl;  // Player's name
     SDL_Texture *pscore_lbl;  // Player's score
 
+    SDL_Point prank_size;  // Dimensions of above labels, recorded at render
+    SDL_Point pname_size;
+    SDL_Point pscore_size;
+
     size_t name_idx;  // for name entry
     char *player_name;
 
@@ -44,6 +50,7 @@ typedef struct {
     // menu config
     bool *menucode_states;
     MenucodeMap *mcodes;
+    AssetSet assets;        // Holds lbl_font
     TTF_Font *lbl_font;
     SDL_Color static_col;   // for static labels
     SDL_Color dynamic_col;  // for labels being edited
@@ -52,12 +59,16 @@ typedef struct {
 } GameoverState;
 
 
+// Initialize a GameoverState, allocated from arena, holding its font from
+// assets until deconstructed
 GameoverState* GameoverState_init(
-    SDL_Renderer *rend, TTF_Font *lbl_font,
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets,
     int player_score, ScoreList *hiscores,
     const SDL_Color *static_col, const SDL_Color *dynamic_col
 );
 
+// Release a GameoverState's textures & font. Its memory is released with its arena
 int GameoverState_deconstruct(void *self);
 
 
@@ -7,10 +7,24 @@
 
 #include "hiscores_state.h"
 #include "application_state.h"
+#include "asset_manager.h"
 #include "hiscores.h"
 #include "inputs.h"
 #include "state_runner.h"
 #include "sirtet.h"
+#include "utilities.h"
+
+
+// Rows of scores shown at once. Labels are kept for the page shown, the page
+// prefetched after it, and the page before it (for scrolling back)
+#define HISCORES_PAGE_ROWS 10
+#define HISCORES_POOL_ROWS (3 * HISCORES_PAGE_ROWS)
+
+
+// Assets a HiscoresState holds for as long as it lives
+static const AssetDesc hiscores_assets[1] = {
+    {ASSET_FONT, "fonts/VT323.ttf", 24}
+};
 
 
 
@@ -20,14 +34,23 @@
 ******************************************************************************/
 
 HiscoresState* HiscoresState_init(
-    SDL_Renderer *rend, TTF_Font *lbl_font, ScoreList *hiscores) {
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets, ScoreList *hiscores) {
 
-    HiscoresState *retval = calloc(1, sizeof(HiscoresState));
+    HiscoresState *retval = Arena_calloc(arena, 1, sizeof(HiscoresState));
     if (retval == NULL) {
         Sirtet_setError("Error allocating memory for HiscoresState\n");
         return NULL;
     }
 
+    if (AssetSet_acquire(&retval->assets, assets, hiscores_assets, 1) != 0) {
+        return NULL;
+    }
+    TTF_Font *lbl_font = AssetSet_font(&retval->assets, 0);
+    if (lbl_font == NULL) {
+        goto fail;
+    }
+
 
 
     /*** Labels ***/
@@ -35,9 +58,15 @@ HiscoresState* HiscoresState_init(
     retval->labels = NULL;
     if (hiscores->len > 0) {
 
+        // Nothing is rasterized until shown, so this costs the same
+        // however many scores there are
         SDL_Color lblcol = {50, 50, 200, 255};
-        retval->labels = ScoreDisplay_init(
-            hiscores, 0, hiscores->len - 1, 1, rend, lbl_font, &lblcol);
+        size_t lbl_sz = ScoreDisplay_requiredBytes(
+            hiscores, HISCORES_POOL_ROWS);
+        retval->labels = ScoreDisplay_build(
+            Arena_alloc(arena, lbl_sz), lbl_sz,
+            hiscores, 0, hiscores->len - 1, 1, HISCORES_POOL_ROWS,
+            lbl_font, &lblcol);
 
         if (retval->labels == NULL) {
             char buff[128];
@@ -47,19 +76,33 @@ HiscoresState* HiscoresState_init(
                 Sirtet_getError()
             );
             Sirtet_setError(buff);
-            return NULL;
+            goto fail;
         }
     }
 
 
     /*** Inputs ***/
 
-    retval->menucode_states = calloc(NUM_MENUCODES, sizeof(bool));
-    retval->mcodes = MenucodeMap_init(MAX_MENUCODE_MAPS);
+    size_t map_sz = MenucodeMap_requiredBytes(MAX_MENUCODE_MAPS);
+    retval->menucode_states = Arena_calloc(arena, NUM_MENUCODES, sizeof(bool));
+    retval->mcodes = MenucodeMap_build(
+        Arena_alloc(arena, map_sz), map_sz, MAX_MENUCODE_MAPS);
+    if (retval->menucode_states == NULL || retval->mcodes == NULL) {
+        Sirtet_setError("Error allocating memory for HiscoresState\n");
+        goto fail;
+    }
     MenucodePreset_standard(retval->mcodes, 1, 1, 1);
 
 
     return retval;
+
+// Anything failing once assets are held. Memory belongs to the arena
+fail:
+    if (retval->labels != NULL) {
+        ScoreDisplay_destroyLabels(retval->labels);
+    }
+    AssetSet_release(&retval->assets);
+    return NULL;
 }
 
 
@@ -67,12 +110,11 @@ int HiscoresState_deconstruct(void *self) {
 
     HiscoresState *hs = (HiscoresState*)self;
 
-    ScoreDisplay_deconstruct(hs->labels);
-
-    MenucodeMap_deconstruct(hs->mcodes);
-    free(hs->menucode_states);
-
-    free(self);
+    // Memory belongs to the state's arena - only textures need released
+    if (hs->labels != NULL) {
+        ScoreDisplay_destroyLabels(hs->labels);
+    }
+    AssetSet_release(&hs->assets);
     return 0;
 
 }
@@ -99,7 +141,7 @@ int HiscoresState_run(StateRunner *runner, void *app_data, void *state_data) {
     /*** Process Inputs ***/
 
     processMenucodes(
-        hs_state->menucode_states, app_state->hardware_states,
+        hs_state->menucode_states, app_state->inputs,
         hs_state->mcodes
     );
 
@@ -108,13 +150,43 @@ int HiscoresState_run(StateRunner *runner, void *app_data, void *state_data) {
         StateRunner_setPopCount(runner, 1);
     }
 
+    ScoreDisplay *labels = hs_state->labels;
+    bool scrolled = false;
+    if (labels != NULL) {
+        int prev_top = labels->top;
+        int top = prev_top;
+        if (Menucode_pressed(hs_state->menucode_states, MENUCODE_MOVE_DOWN)) {
+            top = MIN2(top + 1, (int)labels->n_lbls - HISCORES_PAGE_ROWS);
+        }
+        if (Menucode_pressed(hs_state->menucode_states, MENUCODE_MOVE_UP)) {
+            top--;
+        }
+        scrolled = ScoreDisplay_scrollTo(labels, top) != prev_top;
+    }
+
 
     /*** DRAW ***/
 
-    if (hs_state->labels != NULL && hs_state->labels->n_lbls > 0) {
-        SDL_Rect dstwind = {.x=0, .y=0};
-        SDL_GetWindowSize(app_state->wind, &dstwind.w, &dstwind.h);
-        ScoreDisplay_draw(hs_state->labels, 10, rend, &dstwind, NULL);
+    // Only needs drawn when first shown, exposed or scrolled. Frames that
+    // aren't drawn get the next page ready instead
+    if (StateRunner_skipDraw(runner, scrolled)) {
+        if (labels != NULL) {
+            ScoreDisplay_prefetch(labels, HISCORES_PAGE_ROWS, rend);
+        }
+        return 0;
+    }
+
+    SDL_SetRenderDrawColor(rend, 10, 20, 30, 255);
+    SDL_RenderClear(rend);
+
+    if (labels != NULL && labels->n_lbls > 0) {
+        SDL_Rect dstwind = app_state->layout.window;
+        if (
+            ScoreDisplay_draw(
+                labels, HISCORES_PAGE_ROWS, rend, &dstwind, NULL) != 0
+        ) {
+            return -1;
+        }
     }
 
     return 0;
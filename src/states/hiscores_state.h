@@ -12,6 +12,8 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "arena.h"
+#include "asset_manager.h"
 #include "hiscores.h"
 #include "state_runner.h"
 #include "inputs.h"
@@ -29,13 +31,19 @@ typedef struct {
     bool *menucode_states;
     MenucodeMap *mcodes;
 
+    AssetSet assets;    // Holds the label font
+
 
 } HiscoresState;
 
 
+// Initialize a HiscoresState, allocated from arena, holding its font from
+// assets until deconstructed
 HiscoresState* HiscoresState_init(
-    SDL_Renderer *rend, TTF_Font *lbl_font, ScoreList *hiscores);
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets, ScoreList *hiscores);
 
+// Release a HiscoresState's textures & font. Its memory is released with its arena
 int HiscoresState_deconstruct(void *self);
 
 
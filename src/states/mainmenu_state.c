@@ -11,6 +11,7 @@
 
 #include "sirtet.h"
 #include "sirtet_audio.h"
+#include "asset_manager.h"
 #include "backgrounds.h"
 #include "colorpalette.h"
 #include "hiscores_state.h"
@@ -50,6 +51,95 @@ void menufunc_openHiscores(
     void *menu_data
 );
 
+/******************************************************************************
+ * Assets
+******************************************************************************/
+
+// Assets a MainMenuState holds for as long as it lives
+enum {
+    MAINMENU_ASSET_FONT,
+    MAINMENU_ASSET_MOVE_SOUND,
+    NUM_MAINMENU_ASSETS
+};
+
+static const AssetDesc mainmenu_assets[NUM_MAINMENU_ASSETS] = {
+    [MAINMENU_ASSET_FONT] = {ASSET_FONT, "fonts/VT323.ttf", 24},
+    [MAINMENU_ASSET_MOVE_SOUND] = {ASSET_SOUND, "sounds/mech_kb_click4.wav"}
+};
+
+// Title art, the bulk of the menu's memory, held only while the menu shows
+enum {
+    MAINMENU_ART_LOGO,
+    MAINMENU_ART_BACKGROUND,
+    NUM_MAINMENU_ART
+};
+
+static const AssetDesc mainmenu_art[NUM_MAINMENU_ART] = {
+    [MAINMENU_ART_LOGO] = {ASSET_IMAGE, "img/Logo.bmp"},
+    [MAINMENU_ART_BACKGROUND] = {ASSET_TILED_IMAGE, "img/BG_"}
+};
+
+
+int MainMenuState_prefetch(AssetManager *assets) {
+
+    AssetDesc descs[NUM_MAINMENU_ASSETS + NUM_MAINMENU_ART];
+    memcpy(descs, mainmenu_assets, sizeof(mainmenu_assets));
+    memcpy(descs + NUM_MAINMENU_ASSETS, mainmenu_art, sizeof(mainmenu_art));
+    return AssetManager_prefetch(
+        assets, descs, NUM_MAINMENU_ASSETS + NUM_MAINMENU_ART);
+}
+
+
+int MainMenuState_prefetchArt(AssetManager *assets) {
+    return AssetManager_prefetch(assets, mainmenu_art, NUM_MAINMENU_ART);
+}
+
+
+// Take (back) hold of title art, loading it if need be
+static int holdArt(MainMenuState *self, AssetManager *assets) {
+
+    if (AssetSet_acquire(&self->art, assets, mainmenu_art, NUM_MAINMENU_ART) != 0) {
+        return -1;
+    }
+
+    SDL_Texture *logo = AssetSet_texture(&self->art, MAINMENU_ART_LOGO);
+    SDL_Texture *background = AssetSet_texture(&self->art, MAINMENU_ART_BACKGROUND);
+    if (logo == NULL || background == NULL) {
+        AssetSet_release(&self->art);
+        return -1;
+    }
+
+    self->title_logo = logo;
+    SDL_QueryTexture(
+        logo, NULL, NULL, &self->title_logo_size.x, &self->title_logo_size.y);
+
+    // Carry on panning from wherever the background was let go
+    float xpos = self->background.xpos;
+    float ypos = self->background.ypos;
+    if (PanningBg_build(
+        &self->background,
+        0.866,  // cos(30deg)
+        0.500,  // sin(30deg)
+        background
+    ) != 0) {
+        AssetSet_release(&self->art);
+        return -1;
+    }
+    self->background.xpos = xpos;
+    self->background.ypos = ypos;
+
+    return 0;
+}
+
+
+// A state was pushed over the menu. Prefetched assets it didn't take are let
+// go of while it's covered, & prefetched again once the menu is back on top
+static void coverMenu(MainMenuState *self, AssetManager *assets) {
+    AssetManager_trim(assets);
+    self->prefetch_due = true;
+}
+
+
 /******************************************************************************
  * State Struct creation & destruction
 ******************************************************************************/
@@ -58,14 +148,9 @@ void menufunc_openHiscores(
 /**
  * @brief - Initialize state for the main menu
  * @param rend - SDL_Renderer pointer to render textures with
- * @param menu_font - TTF_Font pointer to render menu options with
+ * @param assets - AssetManager to hold the menu's font, sound & art from
  */
-MainMenuState* MainMenuState_init(
-    SDL_Renderer *rend, TTF_Font *menu_font, SDL_Texture *title_logo,
-    SDL_Texture *bg_tl, SDL_Texture *bg_tr, SDL_Texture *bg_bl,
-    SDL_Texture *bg_br,
-    SirtetAudio_sound menusound_move
-) {
+MainMenuState* MainMenuState_init(SDL_Renderer *rend, AssetManager *assets) {
 
     assert(INIT_TILE_SIZE >= MIN_TILE_SIZE);
     assert(INIT_TILE_SIZE <= MAX_TILE_SIZE);
@@ -79,6 +164,22 @@ MainMenuState* MainMenuState_init(
         return NULL;
     }
 
+    AssetSet held;
+    if (AssetSet_acquire(
+        &held, assets, mainmenu_assets, NUM_MAINMENU_ASSETS) != 0
+    ) {
+        free(menustate);
+        return NULL;
+    }
+    TTF_Font *menu_font = AssetSet_font(&held, MAINMENU_ASSET_FONT);
+    SirtetAudio_sound menusound_move = AssetSet_sound(
+        &held, MAINMENU_ASSET_MOVE_SOUND);
+    if (menu_font == NULL || SirtetAudio_soundInvalid(menusound_move)) {
+        AssetSet_release(&held);
+        free(menustate);
+        return NULL;
+    }
+
     // Preprocessing
     SDL_Surface *title_surf = TTF_RenderText_Solid(
         menu_font, "Sirtet", MENUCOL_ACTIVE
@@ -89,6 +190,7 @@ MainMenuState* MainMenuState_init(
         // snprintf(char *restrict s, size_t maxlen, const char *restrict format, ...)
         snprintf(buff, 64, "Error rendering text: %s\n", SDL_GetError());
         Sirtet_setError(buff);
+        AssetSet_release(&held);
         free(menustate);
         return NULL;
     }
@@ -103,8 +205,9 @@ MainMenuState* MainMenuState_init(
         .menucode_states=(bool*)calloc((int)NUM_MENUCODES, sizeof(bool)),
         .menucode_map=MenucodeMap_init(MAX_MENUCODE_MAPS),
 
+        .assets=held,
+        .prefetch_due=true,
         .label_font=menu_font,
-        .title_logo=title_logo,
         .title_banner=SDL_CreateTextureFromSurface(rend, title_surf)
     };
     SDL_FreeSurface(title_surf);
@@ -117,17 +220,9 @@ MainMenuState* MainMenuState_init(
 
     /*** Display setup (labels/texture/bgs) ***/
 
-    menustate->background = (PanningBg) {
-        .xpos = 0,
-        .ypos = 0,
-        .xvel = 0.866,  // cos(30deg)
-        .yvel = 0.500,  // sin(30deg)
-
-        .topleft = bg_tl,
-        .topright = bg_tr,
-        .bottomleft = bg_bl,
-        .bottomright = bg_br
-    };
+    if (holdArt(menustate, assets) != 0) {
+        return NULL;
+    }
 
 
     /*** Settings defaults ***/
@@ -144,25 +239,26 @@ MainMenuState* MainMenuState_init(
 
     // Key mapping
 
-    const int mv_delay_factor = 3;  // delay until key repeat
+    // Movement timing, in milliseconds, independent of frame rate
+    const Uint32 move_delay_ms = 200;  // delay until key repeat
+    const Uint32 move_repeat_ms = 66;  // delay between repeats
 
-    int move_cd = TARGET_FPS / 15;
     GamecodeMap *keymaps = menustate->settings->keymaps;
 
-    GamecodeMap_addMap(keymaps, GAMECODE_ROTATE, SDL_SCANCODE_DOWN, 1, 1, 1);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_ROTATE, SDL_SCANCODE_DOWN, 0, 0);
     GamecodeMap_addMap(keymaps, GAMECODE_QUIT, SDL_SCANCODE_ESCAPE, 1, 1, 1);
 
-    GamecodeMap_addMap(keymaps, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 1, 1, 1);
-    GamecodeMap_addMap(keymaps, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 1 + (mv_delay_factor * move_cd), INT_MAX, move_cd);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 0, 0);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, move_delay_ms, move_repeat_ms);
 
-    GamecodeMap_addMap(keymaps, GAMECODE_MOVE_RIGHT, SDL_SCANCODE_RIGHT, 1, 1, 1);
-    GamecodeMap_addMap(keymaps, GAMECODE_MOVE_RIGHT, SDL_SCANCODE_RIGHT, 1 + (mv_delay_factor * move_cd), INT_MAX, move_cd);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_MOVE_RIGHT, SDL_SCANCODE_RIGHT, 0, 0);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_MOVE_RIGHT, SDL_SCANCODE_RIGHT, move_delay_ms, move_repeat_ms);
 
-    GamecodeMap_addMap(keymaps, GAMECODE_MOVE_UP, SDL_SCANCODE_UP, 1, 1, 1);
-    GamecodeMap_addMap(keymaps, GAMECODE_MOVE_UP, SDL_SCANCODE_UP, 1 + (mv_delay_factor * move_cd), INT_MAX, move_cd);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_MOVE_UP, SDL_SCANCODE_UP, 0, 0);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_MOVE_UP, SDL_SCANCODE_UP, move_delay_ms, move_repeat_ms);
 
     GamecodeMap_addMap(keymaps, GAMECODE_PAUSE, SDL_SCANCODE_P, 1, 1, 1);
-    GamecodeMap_addMap(keymaps, GAMECODE_HARD_DROP, SDL_SCANCODE_SPACE, 1, 1, 1);
+    GamecodeMap_addTimedMap(keymaps, GAMECODE_HARD_DROP, SDL_SCANCODE_SPACE, 0, 0);
 
 
     // Block presets
@@ -231,6 +327,8 @@ int MainMenuState_deconstruct(void* self) {
     free(menustate->menucode_states);
     TextMenu_deconstruct(menustate->mainmenu);
     GameSettings_deconstruct(menustate->settings);
+    AssetSet_release(&menustate->art);
+    AssetSet_release(&menustate->assets);
 
     free(self);
     return 0;
@@ -253,17 +351,30 @@ void menufunc_startGame(
     ApplicationState *app_state = (ApplicationState*)app_data;
     GameSettings *settings = menu_state->settings;
 
+    Arena *arena = StateRunner_claimArena(state_runner);
+    if (arena == NULL) {
+        printf("Error in menufunc_startGame:\n    %s\n", Sirtet_getError());
+        return;
+    }
+
     GameState *new_state = GameState_init(
-        app_state->rend, app_state->fonts.vt323_24,
-        settings,
-        app_state->sounds.boop,
-        app_state->sounds.boop_scale,
-        app_state->sounds.boop_scale_reverse
+        arena, app_state->rend, app_state->asset_manager, settings
     );
 
-    StateRunner_addState(
-        state_runner, new_state, GameState_run, GameState_deconstruct
+    if (new_state == NULL) {
+        printf("Error in menufunc_startGame:\n    %s\n", Sirtet_getError());
+        StateRunner_returnArena(state_runner, arena);
+        return;
+    }
+
+    StateRunner_addArenaState(
+        state_runner, arena, new_state, GameState_run, GameState_deconstruct
     );
+
+    // The game covers the menu until it's over, so the menu's art needn't
+    // stay resident meanwhile
+    menu_state->release_art = true;
+    coverMenu(menu_state, app_state->asset_manager);
 }
 
 void menufunc_exitGame(
@@ -283,21 +394,26 @@ void menufunc_openSettings(
 
     SDL_Renderer *rend = app_state->rend;
 
-    SettingsMenuState *new_state = SettingsMenuState_init(
-        rend, app_state->fonts.vt323_24, menu_state->settings,
-        app_state->sounds.short_click
-    );
+    Arena *arena = StateRunner_claimArena(state_runner);
+    SettingsMenuState *new_state = NULL;
+    if (arena != NULL) {
+        new_state = SettingsMenuState_init(
+            arena, rend, app_state->asset_manager, menu_state->settings
+        );
+    }
 
     if (new_state == NULL) {
         printf("Error in menufunc_openSettings:\n    %s\n:", Sirtet_getError());
+        StateRunner_returnArena(state_runner, arena);
+        return;
     }
 
-    StateRunner_addState(
-        state_runner, (void*)new_state, 
+    StateRunner_addArenaState(
+        state_runner, arena, (void*)new_state, 
         SettingsMenuState_run,
         SettingsMenuState_deconstruct
     );
-
+    coverMenu(menu_state, app_state->asset_manager);
 }
 
 void menufunc_openHiscores(
@@ -306,9 +422,16 @@ void menufunc_openHiscores(
 ) {
 
     ApplicationState *app_state = (ApplicationState*)app_data;
+    MainMenuState *menu_state = (MainMenuState*)menu_data;
 
-    HiscoresState *new_state = HiscoresState_init(
-        app_state->rend, app_state->fonts.vt323_24, app_state->hiscores);
+    Arena *arena = StateRunner_claimArena(state_runner);
+    HiscoresState *new_state = NULL;
+    if (arena != NULL) {
+        new_state = HiscoresState_init(
+            arena, app_state->rend, app_state->asset_manager,
+            app_state->hiscores
+        );
+    }
 
     if (new_state == NULL) {
         printf(
@@ -316,8 +439,11 @@ void menufunc_openHiscores(
         exit(1);
     }
 
-    StateRunner_addState(
-        state_runner, new_state, HiscoresState_run, HiscoresState_deconstruct);
+    StateRunner_addArenaState(
+        state_runner, arena, new_state,
+        HiscoresState_run, HiscoresState_deconstruct
+    );
+    coverMenu(menu_state, app_state->asset_manager);
 }
 
 
@@ -339,21 +465,46 @@ int MainMenuState_run(
     // Extract for less typing
     SDL_Renderer *rend = app_state->rend;
     bool *menu_codes = menu_state->menucode_states;
-    int *hardware_codes = app_state->hardware_states;
+    InputTracker *inputs = app_state->inputs;
     MenucodeMap *keymaps = menu_state->menucode_map;
     TextMenu *menu = menu_state->mainmenu;
 
+    /***** Assets *****/
+
+    // Art let go while a game covered the menu is taken back on return
+    if (!AssetSet_held(&menu_state->art)) {
+        if (holdArt(menu_state, app_state->asset_manager) != 0) {
+            printf("%s", Sirtet_getError());
+            return -1;
+        }
+    }
+
+    // Starting a game is the likeliest way out of the menu, so have its
+    // assets decoded while the menu idles. Once per visit, as soon as any
+    // earlier prefetch is out of the way
+    if (
+        menu_state->prefetch_due
+        && !AssetManager_busy(app_state->asset_manager)
+    ) {
+        menu_state->prefetch_due = false;
+        if (AssetManager_prefetch(
+            app_state->asset_manager, GAME_ASSETS, NUM_GAME_ASSETS) != 0
+        ) {
+            printf("%s", Sirtet_getError());
+        }
+    }
+
+
     /***** Inputs *****/
 
-    processMenucodes(menu_codes, hardware_codes, keymaps);
+    processMenucodes(menu_codes, inputs, keymaps);
 
 
     /***** Process state *****/
 
-    SDL_Rect bg_dims = {.x=0, .y=0};
-    SDL_GetWindowSize(app_state->wind, &bg_dims.w, &bg_dims.h);
+    SDL_Rect bg_dims = app_state->layout.window;
 
-    if (PanningBg_move(&menu_state->background, &bg_dims) != 0) {
+    if (PanningBg_move(&menu_state->background) != 0) {
         printf("%s", Sirtet_getError());
         return -1;
     }
@@ -398,14 +549,13 @@ int MainMenuState_run(
 
     const int option_padding = 24;
 
-    SDL_Window *wind = app_state->wind;
-    int wind_w, wind_h;
-    SDL_GetWindowSize(wind, &wind_w, &wind_h);
+    int wind_w = app_state->layout.window.w;
+    int wind_h = app_state->layout.window.h;
     int yoffset = 0;
 
     // title
-    int title_w, title_h;
-    SDL_QueryTexture(menu_state->title_logo, NULL, NULL, &title_w, &title_h);
+    int title_w = menu_state->title_logo_size.x;
+    int title_h = menu_state->title_logo_size.y;
 
     SDL_Rect title_loc = {
         .x = (wind_w / 2) - (title_w / 2),
@@ -437,6 +587,11 @@ int MainMenuState_run(
         0
     );
 
+    if (menu_state->release_art) {
+        AssetSet_release(&menu_state->art);
+        menu_state->release_art = false;
+    }
+
     return 0;
 }
 
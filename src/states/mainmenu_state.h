@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "asset_manager.h"
 #include "sirtet_audio.h"
 #include "inputs.h"
 #include "state_runner.h"
@@ -23,6 +24,11 @@ typedef struct mainmenustate {
     MenucodeMap *menucode_map;  // Mapping collection of hardware codes to menu codes
     bool *menucode_states;      // Bool array indicating if menu signals are active
 
+    AssetSet assets;            // Holds label font & menu sound throughout
+    AssetSet art;               // Holds title logo & background while shown
+    bool release_art;           // Let go of art once drawn, as it's covered
+    bool prefetch_due;          // Prefetch game assets, as menu was (re)entered
+
     TTF_Font *label_font;
 
     /* Menu option meta info */
@@ -37,17 +43,23 @@ typedef struct mainmenustate {
     /* Labels & Display */
     SDL_Texture *title_banner;  // Texture with menu title showing
     SDL_Texture *title_logo;
+    SDL_Point title_logo_size;  // Dimensions of title_logo, queried once
     PanningBg background;
 
 
 } MainMenuState;
 
-MainMenuState* MainMenuState_init(
-    SDL_Renderer *rend, TTF_Font *menu_font, SDL_Texture *title_logo,
-    SDL_Texture *bg_tl, SDL_Texture *bg_tr, SDL_Texture *bg_bl,
-    SDL_Texture *bg_br,
-    SirtetAudio_sound menusound_move
-);
+// Initialize the main menu, holding its assets from assets until
+// deconstructed
+MainMenuState* MainMenuState_init(SDL_Renderer *rend, AssetManager *assets);
+
+// Start decoding the main menu's images & sounds in the background, ahead of
+// MainMenuState_init(...)
+int MainMenuState_prefetch(AssetManager *assets);
+
+// Start decoding the main menu's title art in the background, ahead of the
+// menu being returned to (it's let go while covered by a game)
+int MainMenuState_prefetchArt(AssetManager *assets);
 
 // Tear down a MainMenuState, following behaviour set by state_runner
 int MainMenuState_deconstruct(void* self);
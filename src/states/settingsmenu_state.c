@@ -5,6 +5,7 @@
 #include <SDL2/SDL_video.h>
 #include <stdio.h>
 
+#include "asset_manager.h"
 #include "colorpalette.h"
 #include "sirtet.h"
 #include "component_drawing.h"
@@ -55,9 +56,32 @@ static void menufunc_prevPalette(
  * State Struct creation & destruction
 ******************************************************************************/
 
+// Build a palette of the given colors within the state's arena
+static ColorPalette* SettingsMenuState_buildPalette(
+    Arena *arena, const char *name, size_t size, SDL_Color *colors
+) {
+    size_t nbytes = ColorPalette_requiredBytes(name, size);
+    return ColorPalette_build(
+        Arena_alloc(arena, nbytes), nbytes, name, size, colors);
+}
+
+
+// Assets a SettingsMenuState holds for as long as it lives
+enum {
+    SETTINGS_ASSET_FONT,
+    SETTINGS_ASSET_MOVE_SOUND,
+    NUM_SETTINGS_ASSETS
+};
+
+static const AssetDesc settings_assets[NUM_SETTINGS_ASSETS] = {
+    [SETTINGS_ASSET_FONT] = {ASSET_FONT, "fonts/VT323.ttf", 24},
+    [SETTINGS_ASSET_MOVE_SOUND] = {ASSET_SOUND, "sounds/mech_kb_click4.wav"}
+};
+
+
 SettingsMenuState* SettingsMenuState_init(
-    SDL_Renderer *rend, TTF_Font *menu_font, GameSettings *settings,
-    SirtetAudio_sound menusound_move
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets, GameSettings *settings
 ) {
 
     assert(MIN_TILE_SIZE <= MAX_TILE_SIZE);
@@ -65,7 +89,24 @@ SettingsMenuState* SettingsMenuState_init(
     assert(INIT_TILE_SIZE <= MAX_TILE_SIZE);
 
     size_t n = sizeof(SettingsMenuState);
-    SettingsMenuState *retval = (SettingsMenuState*)calloc(1, n);
+    SettingsMenuState *retval = (SettingsMenuState*)Arena_calloc(arena, 1, n);
+    if (retval == NULL) {
+        Sirtet_setError("Error allocating memory for SettingsMenuState\n");
+        return NULL;
+    }
+
+    if (AssetSet_acquire(
+        &retval->assets, assets, settings_assets, NUM_SETTINGS_ASSETS) != 0
+    ) {
+        return NULL;
+    }
+    TTF_Font *menu_font = AssetSet_font(&retval->assets, SETTINGS_ASSET_FONT);
+    SirtetAudio_sound menusound_move = AssetSet_sound(
+        &retval->assets, SETTINGS_ASSET_MOVE_SOUND);
+    if (menu_font == NULL || SirtetAudio_soundInvalid(menusound_move)) {
+        AssetSet_release(&retval->assets);
+        return NULL;
+    }
 
     // NOTE: This pointer is not created by the SettingsMenuState, thus it
     // will not be freed by it
@@ -75,7 +116,7 @@ SettingsMenuState* SettingsMenuState_init(
 
     /*** Block presets ***/
 
-    long** preset_arr = (long**)calloc(3, sizeof(long*));
+    long** preset_arr = (long**)Arena_calloc(arena, 3, sizeof(long*));
     if (preset_arr == NULL) {
         Sirtet_setError("Error allocating preset array in SettingMenuState\n");
         return NULL;
@@ -84,9 +125,9 @@ SettingsMenuState* SettingsMenuState_init(
     retval->blocksize_sel = settings->block_size;
     retval->presets = preset_arr;
     if (
-        (preset_arr[0] = (long*)calloc(2, sizeof(long))) == NULL ||
-        (preset_arr[1] = (long*)calloc(7, sizeof(long))) == NULL ||
-        (preset_arr[2] = (long*)calloc(18, sizeof(long))) == NULL
+        (preset_arr[0] = (long*)Arena_calloc(arena, 2, sizeof(long))) == NULL ||
+        (preset_arr[1] = (long*)Arena_calloc(arena, 7, sizeof(long))) == NULL ||
+        (preset_arr[2] = (long*)Arena_calloc(arena, 18, sizeof(long))) == NULL
     )
     {
         Sirtet_setError("Error allocating preset array in SettingsMenuState\n");
@@ -137,48 +178,57 @@ SettingsMenuState* SettingsMenuState_init(
     retval->num_palettes = 4;
 
     size_t sz = sizeof(ColorPalette*);
-    retval->palettes = (ColorPalette**)calloc(retval->num_palettes, sz);
+    retval->palettes = (ColorPalette**)Arena_calloc(
+        arena, retval->num_palettes, sz);
+    if (retval->palettes == NULL) {
+        Sirtet_setError("Error allocating palettes in SettingsMenuState\n");
+        return NULL;
+    }
 
     // TODO: STRETCH: Figure out a way to make this a parsable config file or something
-    retval->palettes[0] = ColorPalette_initVa(
-        "Default", 7, 
-        (SDL_Color){190,83,28, 255},
-        (SDL_Color){218,170,0, 255},
-        (SDL_Color){101,141,27, 255},
-        (SDL_Color){0,95,134, 255},
-        (SDL_Color){155,0,0, 255},
-        (SDL_Color){0,155,0, 255},
-        (SDL_Color){0,0,155, 255}
+    retval->palettes[0] = SettingsMenuState_buildPalette(
+        arena, "Default", 7, (SDL_Color[]){
+            (SDL_Color){190,83,28, 255},
+            (SDL_Color){218,170,0, 255},
+            (SDL_Color){101,141,27, 255},
+            (SDL_Color){0,95,134, 255},
+            (SDL_Color){155,0,0, 255},
+            (SDL_Color){0,155,0, 255},
+            (SDL_Color){0,0,155, 255}
+        }
     );
 
-    retval->palettes[1] = ColorPalette_initVa(
-        "Pastels", 8, 
-        (SDL_Color){255, 173, 173, 255},
-        (SDL_Color){255, 214, 165, 255},
-        (SDL_Color){253, 255, 182, 255},
-        (SDL_Color){202, 255, 191, 255},
-        (SDL_Color){155, 246, 255, 255},
-        (SDL_Color){160, 196, 255, 255},
-        (SDL_Color){189, 178, 255, 255},
-        (SDL_Color){255, 198, 255, 255}
+    retval->palettes[1] = SettingsMenuState_buildPalette(
+        arena, "Pastels", 8, (SDL_Color[]){
+            (SDL_Color){255, 173, 173, 255},
+            (SDL_Color){255, 214, 165, 255},
+            (SDL_Color){253, 255, 182, 255},
+            (SDL_Color){202, 255, 191, 255},
+            (SDL_Color){155, 246, 255, 255},
+            (SDL_Color){160, 196, 255, 255},
+            (SDL_Color){189, 178, 255, 255},
+            (SDL_Color){255, 198, 255, 255}
+        }
     );
 
-    retval->palettes[2] = ColorPalette_initVa(
-        "Beach", 4, 
-        (SDL_Color){250, 255, 175, 255},
-        (SDL_Color){150, 201, 244, 255},
-        (SDL_Color){63, 162, 246, 255},
-        (SDL_Color){15, 103, 177, 255},
-        (SDL_Color){15, 103, 177, 255}
+    retval->palettes[2] = SettingsMenuState_buildPalette(
+        arena, "Beach", 4, (SDL_Color[]){
+            (SDL_Color){250, 255, 175, 255},
+            (SDL_Color){150, 201, 244, 255},
+            (SDL_Color){63, 162, 246, 255},
+            (SDL_Color){15, 103, 177, 255},
+            (SDL_Color){15, 103, 177, 255}
+        }
     );
 
-    retval->palettes[3] = ColorPalette_initVa(
-        "Coffee", 5, 
-        (SDL_Color){55, 34, 20, 255},
-        (SDL_Color){121, 66, 40, 255},
-        (SDL_Color){184, 115, 58, 255},
-        (SDL_Color){190, 194, 203, 255},
-        (SDL_Color){52, 48, 44, 255}
+    retval->palettes[3] = SettingsMenuState_buildPalette(
+        arena, "Coffee", 5, (SDL_Color[]){
+            (SDL_Color){55, 34, 20, 255},
+            (SDL_Color){121, 66, 40, 255},
+            (SDL_Color){184, 115, 58, 255},
+            (SDL_Color){190, 194, 203, 255},
+            (SDL_Color){52, 48, 44, 255}
+        }
     );
 
 
@@ -198,9 +248,22 @@ SettingsMenuState* SettingsMenuState_init(
 
     /*** Menu Setup ***/
 
-    retval->menu = TextMenu_init(4, 64, menusound_move);
-    retval->menucode_states = (bool*)calloc(NUM_MENUCODES, sizeof(bool));
-    retval->menucode_map = MenucodeMap_init(MAX_MENUCODE_MAPS);
+    size_t menu_sz = TextMenu_requiredBytes(4, 64);
+    size_t map_sz = MenucodeMap_requiredBytes(MAX_MENUCODE_MAPS);
+    retval->menu = TextMenu_build(
+        Arena_alloc(arena, menu_sz), menu_sz, 4, 64, menusound_move);
+    retval->menucode_states = (bool*)Arena_calloc(
+        arena, NUM_MENUCODES, sizeof(bool));
+    retval->menucode_map = MenucodeMap_build(
+        Arena_alloc(arena, map_sz), map_sz, MAX_MENUCODE_MAPS);
+
+    if (
+        retval->menu == NULL || retval->menucode_states == NULL
+        || retval->menucode_map == NULL
+    ) {
+        Sirtet_setError("Error allocating menu in SettingsMenuState\n");
+        return NULL;
+    }
 
     char buffer[64];
 
@@ -233,7 +296,8 @@ int SettingsMenuState_deconstruct(void *self) {
     /* The deconstruction function for this menu state is twofolu -
      * (1) Copy the settings picked by the user during this state into
      *     the linked settings struct
-     * (2) Free all memory
+     * (2) Release the menu's label textures & the assets held (all memory
+     *     belongs to the state's arena, which is reclaimed by the StateRunner)
      *
      * By doing it this way, we can avoid new memory allocation and freeing
      * during the lifetime of the state. (The alternative, and previously used,
@@ -274,22 +338,10 @@ int SettingsMenuState_deconstruct(void *self) {
     );
 
 
-    /*** Free Memory ***/
-
-    TextMenu_deconstruct(settingsmenu->menu);
-    MenucodeMap_deconstruct(settingsmenu->menucode_map);
+    /*** Release Textures & Assets ***/
 
-    for (size_t sizei = 0; sizei <= MAX_TILE_SIZE - MIN_TILE_SIZE; sizei++) {
-        free(settingsmenu->presets[sizei]);
-    }
-    free(settingsmenu->presets);
-
-    for (size_t palidx = 0; palidx < settingsmenu->num_palettes; palidx++) {
-        ColorPalette_deconstruct(settingsmenu->palettes[palidx]);
-    }
-    free(settingsmenu->palettes);
-
-    free(self);
+    Menu_clearLabels(settingsmenu->menu->menu);
+    AssetSet_release(&settingsmenu->assets);
     return 0;
 }
 
@@ -320,12 +372,13 @@ int SettingsMenuState_run(
 
     processMenucodes(
         settings_state->menucode_states,
-        app_state->hardware_states,
+        app_state->inputs,
         settings_state->menucode_map
     );
 
-    if (app_state->hardware_states[(int)SDL_SCANCODE_Q] > 0) {
-        printf("Hardware states for q is %d\n", app_state->hardware_states[(int)SDL_SCANCODE_Q]);
+    int q_frames = InputTracker_frameCount(app_state->inputs, SDL_SCANCODE_Q);
+    if (q_frames > 0) {
+        printf("Hardware states for q is %d\n", q_frames);
         StateRunner_setPopCount(state_runner, 1);
     }
 
@@ -346,9 +399,11 @@ int SettingsMenuState_run(
     }
 
 
+    bool changed = false;
     for (int mc = 0; mc < NUM_MENUCODES; mc++) {
         if (Menucode_pressed(settings_state->menucode_states, mc)) {
 
+            changed = true;
             TextMenu_runCommand(
                 settings_state->menu, mc, state_runner,
                 application_data, state_data
@@ -359,14 +414,18 @@ int SettingsMenuState_run(
 
     /*** Draw ***/
 
-    int wind_w, wind_h;
+    // Display only changes in response to menu input
+    if (StateRunner_skipDraw(state_runner, changed)) {
+        return 0;
+    }
+
+    int wind_w = app_state->layout.window.w;
+    int wind_h = app_state->layout.window.h;
     SDL_Color bgcol = {155, 155, 155};
 
     SDL_SetRenderDrawColor(rend, bgcol.r, bgcol.g, bgcol.b, bgcol.a);
     SDL_RenderClear(rend);
 
-    SDL_GetWindowSize(app_state->wind, &wind_w, &wind_h);
-
 
     // menu
 
@@ -406,7 +465,7 @@ int SettingsMenuState_run(
         ColorPalette_getColor(palette, block_num % palette->size, &drawcol);
 
         drawBlockContents(
-            rend, block_size,
+            rend, NULL, block_size,
             presets[block_num],
             &drawcol, &drawpos, cell_size, cell_size
         );
@@ -9,6 +9,8 @@
 #include <stdbool.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "arena.h"
+#include "asset_manager.h"
 #include "sirtet_audio.h"
 #include "game_state.h"
 #include "state_runner.h"
@@ -21,6 +23,7 @@ typedef struct {
 
     // Menu 
     TextMenu *menu;
+    AssetSet assets;        // Holds menu font & sound
     TTF_Font *menu_font;
     bool *menucode_states;
     MenucodeMap *menucode_map;
@@ -39,9 +42,11 @@ typedef struct {
 
 } SettingsMenuState;
 
+// Initialize a SettingsMenuState, allocated from arena, holding its font &
+// sound from assets until deconstructed
 SettingsMenuState* SettingsMenuState_init(
-    SDL_Renderer *rend, TTF_Font *menu_font, GameSettings *settings,
-    SirtetAudio_sound menusound_move
+    Arena *arena,
+    SDL_Renderer *rend, AssetManager *assets, GameSettings *settings
 );
 
 // Tear down a MainMenuState, following behaviour set by state_runner
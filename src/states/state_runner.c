@@ -2,6 +2,7 @@
 *
 * Logic implementation for operating on a StateRunner struct
 */
+#include <stdint.h>
 #include <stdio.h>
 
 #include "state_runner.h"
@@ -13,6 +14,132 @@
  ============================================================================*/
 
 
+// Bucket of lookup hash for a state data pointer
+static int StateRunner_lookupBucket(StateRunner *self, void *state_data) {
+    uint64_t key = (uint64_t)(uintptr_t)state_data;
+    return (int)(((key >> 3) * 0x9E3779B97F4A7C15ULL) >> 32) & self->lookup_mask;
+}
+
+
+// Reset all records to free, and lookup buckets to empty
+static void StateRunner_clearRecords(StateRunner *self) {
+    for (int i = 0; i < self->num_records; i++) {
+        self->records[i] = (StateRecord){
+            .data=NULL, .deconstructor=NULL, .arena=NULL,
+            .refs=0, .next=i + 1
+        };
+    }
+    self->records[self->num_records - 1].next = -1;
+    self->free_record = 0;
+
+    for (int i = 0; i <= self->lookup_mask; i++) {
+        self->lookup[i] = -1;
+    }
+}
+
+
+// Find live handle for state data, or INVALID_STATE_HANDLE if none
+static StateHandle StateRunner_findHandle(StateRunner *self, void *state_data) {
+    if (state_data == NULL) {
+        return INVALID_STATE_HANDLE;
+    }
+
+    int idx = self->lookup[StateRunner_lookupBucket(self, state_data)];
+    for (; idx != -1; idx = self->records[idx].next) {
+        if (self->records[idx].data == state_data) {
+            return idx;
+        }
+    }
+    return INVALID_STATE_HANDLE;
+}
+
+
+// Claim a free record for state data. Starts with no references
+static StateHandle StateRunner_newHandle(
+    StateRunner *self, void *state_data, deconstruct_func_t deconstructor
+) {
+    StateHandle handle = self->free_record;
+    if (handle == -1) {
+        Sirtet_setError("StateRunner has no free state records\n");
+        return INVALID_STATE_HANDLE;
+    }
+
+    StateRecord *record = &self->records[handle];
+    self->free_record = record->next;
+
+    *record = (StateRecord){
+        .data=state_data, .deconstructor=deconstructor, .arena=NULL,
+        .refs=0, .next=-1
+    };
+
+    // NULL data is never aliased by pointer, so is never looked up
+    if (state_data != NULL) {
+        int bucket = StateRunner_lookupBucket(self, state_data);
+        record->next = self->lookup[bucket];
+        self->lookup[bucket] = handle;
+    }
+    return handle;
+}
+
+
+// Drop a reference to a handle, deconstructing its data if it was the last
+static void StateRunner_release(StateRunner *self, StateHandle handle) {
+
+    StateRecord *record = &self->records[handle];
+    if (--record->refs > 0) {
+        return;
+    }
+
+    void *state_data = record->data;
+    deconstruct_func_t decon = record->deconstructor;
+    Arena *arena = record->arena;
+
+    if (state_data != NULL) {
+        int *link = &self->lookup[StateRunner_lookupBucket(self, state_data)];
+        while (*link != handle) {
+            link = &self->records[*link].next;
+        }
+        *link = record->next;
+    }
+
+    *record = (StateRecord){
+        .data=NULL, .deconstructor=NULL, .arena=NULL,
+        .refs=0, .next=self->free_record
+    };
+    self->free_record = handle;
+
+    if (decon != NULL) {
+        decon(state_data);
+    }
+
+    // Deconstructor may still read state data, so the arena goes last
+    if (arena != NULL) {
+        StateRunner_returnArena(self, arena);
+    }
+}
+
+
+static bool StateRunner_bufferFull(StateRunner *self) {
+    return (self->buffer_head + 1) % self->buffer_size == self->buffer_tail;
+}
+
+
+// Queue a new reference to handle, to be run with state_runner
+static void StateRunner_enqueue(
+    StateRunner *self, StateHandle handle, state_func_t state_runner,
+    bool overlay
+) {
+    self->records[handle].refs++;
+
+    self->handles_buffer[self->buffer_head] = handle;
+    self->runners_buffer[self->buffer_head] = state_runner;
+    self->overlays_buffer[self->buffer_head] = overlay;
+
+    /* rotating buffer - queue-like (rather than stack-like) */
+    self->buffer_head = (self->buffer_head + 1) % self->buffer_size;
+}
+
+
 // Add a state to the StateRunner's buffer
 int StateRunner_addState(
     StateRunner* self, void* state_data,
@@ -20,21 +147,105 @@ int StateRunner_addState(
     deconstruct_func_t state_deconstructor
 ) {
 
-    self->states_buffer[self->buffer_head] = state_data;
-    self->runners_buffer[self->buffer_head] = state_runner;
-    self->deconstructors_buffer[self->buffer_head] = state_deconstructor;
+    // Caution around overflow & wraparound
+    if (StateRunner_bufferFull(self)) {
+        Sirtet_setError("StateRunner buffer is full\n");
+        return -1;
+    }
 
-    /* rotating buffer - queue-like (rather than stack-like) */
-    self->buffer_head = (self->buffer_head + 1) % self->buffer_size;
+    StateHandle handle = StateRunner_findHandle(self, state_data);
+    if (handle == INVALID_STATE_HANDLE) {
+        handle = StateRunner_newHandle(self, state_data, state_deconstructor);
+        if (handle == INVALID_STATE_HANDLE) {
+            return -1;
+        }
+    } else if (self->records[handle].deconstructor == NULL) {
+        self->records[handle].deconstructor = state_deconstructor;
+    }
 
-    // Caution around overflow & wraparound
-    if (self->buffer_head == self->buffer_tail) {
+    StateRunner_enqueue(self, handle, state_runner, false);
+    return 0;
+}
+
+
+int StateRunner_addArenaState(
+    StateRunner *self, Arena *arena, void *state_data,
+    state_func_t state_runner, deconstruct_func_t state_deconstructor
+) {
+
+    StateHandle handle = INVALID_STATE_HANDLE;
+    if (StateRunner_bufferFull(self)) {
+        Sirtet_setError("StateRunner buffer is full\n");
+    } else {
+        handle = StateRunner_newHandle(self, state_data, state_deconstructor);
+    }
+
+    // State is owned from here on, so is cleaned up even if it can't be added
+    if (handle == INVALID_STATE_HANDLE) {
+        if (state_deconstructor != NULL) {
+            state_deconstructor(state_data);
+        }
+        StateRunner_returnArena(self, arena);
         return -1;
     }
 
+    self->records[handle].arena = arena;
+    StateRunner_enqueue(self, handle, state_runner, false);
     return 0;
 }
 
+
+// Queue another reference to a live handle
+static int StateRunner_addReference(
+    StateRunner *self, StateHandle handle, state_func_t state_runner,
+    bool overlay
+) {
+
+    if (StateRunner_getRefCount(self, handle) == 0) {
+        Sirtet_setError("Cannot alias a state handle that is not live\n");
+        return -1;
+    }
+
+    if (StateRunner_bufferFull(self)) {
+        Sirtet_setError("StateRunner buffer is full\n");
+        return -1;
+    }
+
+    StateRunner_enqueue(self, handle, state_runner, overlay);
+    return 0;
+}
+
+
+int StateRunner_addAlias(
+    StateRunner *self, StateHandle handle, state_func_t state_runner
+) {
+    return StateRunner_addReference(self, handle, state_runner, false);
+}
+
+
+int StateRunner_addOverlay(
+    StateRunner *self, StateHandle handle, state_func_t state_runner
+) {
+    return StateRunner_addReference(self, handle, state_runner, true);
+}
+
+
+StateHandle StateRunner_currentHandle(StateRunner *self) {
+    if (self->head < 0 || self->head >= self->size) {
+        return INVALID_STATE_HANDLE;
+    }
+    return self->handles[self->head];
+}
+
+
+int StateRunner_getRefCount(StateRunner *self, StateHandle handle) {
+    if (handle < 0 || handle >= self->num_records) {
+        return 0;
+    }
+    return self->records[handle].refs;
+}
+
+
 // Migrate buffer states to the "live" state array
 int StateRunner_commitBuffer(StateRunner *self) {
 
@@ -43,14 +254,19 @@ int StateRunner_commitBuffer(StateRunner *self) {
         // Move write head
         self->head++;
 
+        // Top of stack changes - nothing presented belongs to it
+        self->drawn_state = INVALID_STATE_HANDLE;
+        self->drawn_runner = NULL;
+        self->underlay_valid = false;
+
         if (self->head >= self->size) {
             return -1;
         }
 
         // Copy from read head to write head
-        self->states[self->head] = self->states_buffer[self->buffer_tail];
+        self->handles[self->head] = self->handles_buffer[self->buffer_tail];
         self->runners[self->head] = self->runners_buffer[self->buffer_tail];
-        self->deconstructors[self->head] = self->deconstructors_buffer[self->buffer_tail];
+        self->overlays[self->head] = self->overlays_buffer[self->buffer_tail];
 
         // Move read head
         self->buffer_tail = (self->buffer_tail + 1) % self->buffer_size;
@@ -66,38 +282,20 @@ int StateRunner_commitBuffer(StateRunner *self) {
 
 
 /**
- * @brief Flush the StateRunner's pop buffer
+ * @brief Flush the StateRunner's pop buffer, releasing each popped entry's
+ *        reference to its state
  * @param self - StateRunner pointer to clear
  */
 void StateRunner_flushPop(StateRunner *self) {
 
     for (;self->pop_count > 0 && self->head >= 0; self->pop_count--, self->head--) {
 
-        deconstruct_func_t decon = self->deconstructors[self->head];
-        void *state = self->states[self->head];
-
-        if (decon != NULL) {
-            int refcount = 0;
-            for (int stack_i = 0; stack_i <= self->head; stack_i++) {
-                if (self->states[stack_i] == state) {
-                    refcount++;
-                }
-            }
-
-            for (int queue_i = self->buffer_tail;
-                 queue_i != self->buffer_head;
-                 queue_i = (queue_i + 1) % self->buffer_size) {
-
-                if (self->states_buffer[queue_i] == state) {
-                    refcount++;
-                }
-            }
+        // Popped data may be freed, and its handle reused
+        self->drawn_state = INVALID_STATE_HANDLE;
+        self->drawn_runner = NULL;
+        self->underlay_valid = false;
 
-            if (refcount == 1) {
-                decon(state);
-            }
-
-        }
+        StateRunner_release(self, self->handles[self->head]);
     }
 }
 
@@ -117,15 +315,32 @@ int StateRunner_runState(StateRunner *self, void* app_state) {
     }
 
     state_func_t top_runner = self->runners[self->head];
-    void* top_state = self->states[self->head];
+    StateHandle top_handle = self->handles[self->head];
+    void* top_state = self->records[top_handle].data;
 
     StateRunner_flushPop(self);
+
+    self->draw_skipped = false;
+    self->idle = false;
     int retval = top_runner(self, app_state, top_state);
     if (retval < 0) {
         char *errmsg = Sirtet_getError();
         printf("Error running state function:\n    %s\n", errmsg);
         return -1;
     }
+
+    // State below draws next frame instead
+    if (self->pop_count > 0) {
+        self->draw_skipped = true;
+        self->idle = false;
+    }
+
+    if (!self->draw_skipped) {
+        self->redraw_requested = false;
+        self->drawn_state = top_handle;
+        self->drawn_runner = top_runner;
+    }
+
     StateRunner_flushPop(self);
     return 0;
 
@@ -143,11 +358,154 @@ int StateRunner_setPopCount(StateRunner *self, int count) {
     return 0;
 }
 
+/* ============================================================================
+ * State arenas
+ ============================================================================*/
+
+
+int StateRunner_reserveArenas(StateRunner *self, int count, size_t capacity) {
+
+    if (count < 0) {
+        Sirtet_setError("Cannot reserve a negative number of arenas\n");
+        return -1;
+    }
+
+    // Shrinking the pool drops any arenas beyond its new size
+    for (; self->num_arenas > count; self->num_arenas--) {
+        Arena_deconstruct(self->arenas[self->num_arenas - 1]);
+    }
+
+    Arena **arenas = (Arena**)realloc(self->arenas, count * sizeof(Arena*));
+    if (arenas == NULL && count > 0) {
+        Sirtet_setError("Error allocating StateRunner arena pool\n");
+        return -1;
+    }
+    self->arenas = arenas;
+    self->max_arenas = count;
+    self->arena_capacity = capacity;
+
+    while (self->num_arenas < count) {
+        Arena *arena = Arena_init(capacity);
+        if (arena == NULL) {
+            return -1;
+        }
+        self->arenas[self->num_arenas++] = arena;
+    }
+    return 0;
+}
+
+
+Arena* StateRunner_claimArena(StateRunner *self) {
+    if (self->num_arenas > 0) {
+        return self->arenas[--self->num_arenas];
+    }
+    return Arena_init(self->arena_capacity);
+}
+
+
+void StateRunner_returnArena(StateRunner *self, Arena *arena) {
+
+    if (arena == NULL) {
+        return;
+    }
+
+    if (self->num_arenas >= self->max_arenas) {
+        Arena_deconstruct(arena);
+        return;
+    }
+
+    Arena_reset(arena);
+    self->arenas[self->num_arenas++] = arena;
+}
+
+
+// Free every pooled arena, along with the pool itself
+static void StateRunner_freeArenas(StateRunner *self) {
+    for (int i = 0; i < self->num_arenas; i++) {
+        Arena_deconstruct(self->arenas[i]);
+    }
+    free(self->arenas);
+    self->arenas = NULL;
+    self->num_arenas = 0;
+    self->max_arenas = 0;
+}
+
+
+/* ============================================================================
+ * Presentation
+ ============================================================================*/
+
+
+/**
+ * @brief - Identify if the currently running state may skip drawing this
+ *          frame, marking the frame as skipped if so.
+ * @param self - StateRunner pointer the state is being run from
+ * @param changed - Whether the state's display changed this frame
+ */
+bool StateRunner_skipDraw(StateRunner *self, bool changed) {
+
+    if (changed || self->redraw_requested || self->head < 0) {
+        return false;
+    }
+
+    // Whatever was last presented belongs to some other state
+    if (
+        self->drawn_state != self->handles[self->head]
+        || self->drawn_runner != self->runners[self->head]
+    ) {
+        return false;
+    }
+
+    self->draw_skipped = true;
+    self->idle = true;
+    return true;
+}
+
+void StateRunner_requestRedraw(StateRunner *self) {
+    self->redraw_requested = true;
+    self->underlay_valid = false;
+}
+
+bool StateRunner_drawSkipped(StateRunner *self) {
+    return self->draw_skipped;
+}
+
+bool StateRunner_idle(StateRunner *self) {
+    return self->idle;
+}
+
+
+bool StateRunner_underlayStale(StateRunner *self) {
+
+    if (self->head < 0 || !self->overlays[self->head]) {
+        return false;
+    }
+
+    bool stale = !self->underlay_valid;
+    self->underlay_valid = true;
+    return stale;
+}
+
+void StateRunner_invalidateUnderlay(StateRunner *self) {
+    self->underlay_valid = false;
+}
+
+
 /* ============================================================================
  * Initialization and deconstruction
  ============================================================================*/
 
 
+// Number of lookup buckets for a StateRunner with the given number of records
+static int StateRunner_lookupSize(int num_records) {
+    int lookup_size = 1;
+    while (lookup_size < num_records) {
+        lookup_size <<= 1;
+    }
+    return lookup_size;
+}
+
+
 /**
  * @brief - Calculate the number of bytes needed to fully
  *          build a StateRunner struct successfully
@@ -157,18 +515,25 @@ int StateRunner_setPopCount(StateRunner *self, int count) {
 size_t StateRunner_requiredBytes(int buffer_size, int q_size) {
 
     size_t bytes_needed = 0;
+    int num_records = buffer_size + q_size;
 
     // covers by-value memory stuff
     bytes_needed += sizeof(StateRunner);
 
-    // states & states buffer memory
-    bytes_needed += sizeof(void*) * (buffer_size + q_size);
+    // state records (one per possible stack & queue entry)
+    bytes_needed += sizeof(StateRecord) * num_records;
 
     // runners & runners buffer memory
     bytes_needed += sizeof(state_func_t) * (buffer_size + q_size);
 
-    // deconstructors & deconstructors buffer
-    bytes_needed += sizeof(deconstruct_func_t) * (buffer_size + q_size);
+    // handles & handles buffer memory
+    bytes_needed += sizeof(StateHandle) * (buffer_size + q_size);
+
+    // record lookup buckets
+    bytes_needed += sizeof(int) * StateRunner_lookupSize(num_records);
+
+    // overlay flags & overlay flags buffer
+    bytes_needed += sizeof(bool) * (buffer_size + q_size);
 
     return bytes_needed;
 }
@@ -187,7 +552,9 @@ size_t StateRunner_requiredBytes(int buffer_size, int q_size) {
 StateRunner* StateRunner_init(int buffer_size, int q_size) {
 
     size_t sf_sz = sizeof(state_func_t);
-    size_t decon_sz = sizeof(deconstruct_func_t);
+    size_t h_sz = sizeof(StateHandle);
+    int num_records = buffer_size + q_size;
+    int lookup_size = StateRunner_lookupSize(num_records);
 
     StateRunner *runner = (StateRunner*)malloc(sizeof(StateRunner));
 
@@ -201,15 +568,33 @@ StateRunner* StateRunner_init(int buffer_size, int q_size) {
         .buffer_size = q_size,
         .pop_count = 0,
 
-        .states = malloc(buffer_size * sizeof(void*)),
-        .states_buffer = malloc(q_size * sizeof(void*)),
+        .handles = (StateHandle*)malloc(buffer_size * h_sz),
+        .handles_buffer = (StateHandle*)malloc(q_size * h_sz),
 
         .runners = (state_func_t*)malloc(buffer_size * sf_sz),
         .runners_buffer = (state_func_t*)malloc(q_size * sf_sz),
 
-        .deconstructors = (deconstruct_func_t*)malloc(buffer_size * decon_sz),
-        .deconstructors_buffer = (deconstruct_func_t*)malloc(q_size * decon_sz)
+        .overlays = (bool*)malloc(buffer_size * sizeof(bool)),
+        .overlays_buffer = (bool*)malloc(q_size * sizeof(bool)),
+
+        .records = (StateRecord*)malloc(num_records * sizeof(StateRecord)),
+        .num_records = num_records,
+        .lookup = (int*)malloc(lookup_size * sizeof(int)),
+        .lookup_mask = lookup_size - 1,
+
+        .arenas = NULL,
+        .num_arenas = 0,
+        .max_arenas = 0,
+        .arena_capacity = 0,
+
+        .redraw_requested = true,
+        .draw_skipped = false,
+        .idle = false,
+        .drawn_state = INVALID_STATE_HANDLE,
+        .drawn_runner = NULL,
+        .underlay_valid = false
     };
+    StateRunner_clearRecords(runner);
     return runner;
 }
 
@@ -242,6 +627,9 @@ StateRunner* StateRunner_initSingleBlock(int buffer_size, int q_size) {
  */
 int StateRunner_build(char *memory, int buffer_size, int q_size) {
 
+    int num_records = buffer_size + q_size;
+    int lookup_size = StateRunner_lookupSize(num_records);
+
     *(StateRunner*)(memory) = (StateRunner){
 
         .head = -1,
@@ -249,17 +637,31 @@ int StateRunner_build(char *memory, int buffer_size, int q_size) {
 
         .buffer_head = 0,
         .buffer_tail = 0,
-        .buffer_size = 16
+        .buffer_size = q_size,
+        .pop_count = 0,
+
+        .num_records = num_records,
+        .lookup_mask = lookup_size - 1,
+
+        .arenas = NULL,
+        .num_arenas = 0,
+        .max_arenas = 0,
+        .arena_capacity = 0,
+
+        .redraw_requested = true,
+        .draw_skipped = false,
+        .idle = false,
+        .drawn_state = INVALID_STATE_HANDLE,
+        .drawn_runner = NULL,
+        .underlay_valid = false
     };
 
     StateRunner *runner = (StateRunner*)(memory);
     int offset = sizeof(StateRunner);
 
-    runner->states = (void*)(memory + offset);
-    offset += buffer_size * sizeof(void*);
-
-    runner->states_buffer = (void*)(memory + offset);
-    offset += q_size * sizeof(void*);
+    // Pointer-aligned members first, then ints, then bools
+    runner->records = (StateRecord*)(memory + offset);
+    offset += num_records * sizeof(StateRecord);
 
     runner->runners = (state_func_t*)(memory + offset);
     offset += buffer_size * sizeof(state_func_t);
@@ -267,12 +669,21 @@ int StateRunner_build(char *memory, int buffer_size, int q_size) {
     runner->runners_buffer = (state_func_t*)(memory + offset);
     offset += q_size * sizeof(state_func_t);
 
+    runner->handles = (StateHandle*)(memory + offset);
+    offset += buffer_size * sizeof(StateHandle);
+
+    runner->handles_buffer = (StateHandle*)(memory + offset);
+    offset += q_size * sizeof(StateHandle);
+
+    runner->lookup = (int*)(memory + offset);
+    offset += lookup_size * sizeof(int);
 
-    runner->deconstructors = (deconstruct_func_t*)(memory + offset);
-    offset += buffer_size * sizeof(deconstruct_func_t);
+    runner->overlays = (bool*)(memory + offset);
+    offset += buffer_size * sizeof(bool);
 
-    runner->deconstructors_buffer = (deconstruct_func_t*)(memory + offset);
+    runner->overlays_buffer = (bool*)(memory + offset);
 
+    StateRunner_clearRecords(runner);
     return 0;
 }
 
@@ -289,14 +700,19 @@ int StateRunner_deconstruct(StateRunner *self) {
     StateRunner_flushPop(self);
 
 
-    free(self->states);
-    free(self->states_buffer);
+    free(self->handles);
+    free(self->handles_buffer);
 
     free(self->runners);
     free(self->runners_buffer);
 
-    free(self->deconstructors);
-    free(self->deconstructors_buffer);
+    free(self->overlays);
+    free(self->overlays_buffer);
+
+    free(self->records);
+    free(self->lookup);
+
+    StateRunner_freeArenas(self);
 
 
     free(self);
@@ -304,7 +720,7 @@ int StateRunner_deconstruct(StateRunner *self) {
 }
 
 int StateRunner_deconstructSingleBlock(StateRunner *self) {
+    StateRunner_freeArenas(self);
     free(self);
     return 0;
 }
-
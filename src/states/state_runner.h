@@ -33,14 +33,47 @@
  *      Function points to functions that free up any memory and clear
  *      the state structs from (1). Expects a void pointer, corresponding
  *      to state, which is then recast and freed up (however needed).
- *      This function is called after a frame-run of the function indicated
- *      in (2) when said function returns -1.
+ *      This function is called once the last stack (or queue) entry
+ *      referring to the state data is popped.
+ *
+ * State data is owned through reference-counted handles. Each stack or
+ * queue entry holds one reference to a handle, and a handle's deconstructor
+ * runs when its last reference is popped. StateRunner_addAlias(...) pushes
+ * another runner over an existing handle (e.g. a pause screen over the game
+ * it pauses), sharing ownership explicitly. For convenience,
+ * StateRunner_addState(...) with state data that already has a live handle
+ * aliases that handle rather than creating another, so the data is still
+ * only deconstructed once.
+ *
+ * State data may instead be allocated from an Arena claimed from the
+ * StateRunner (see StateRunner_claimArena(...)) and added with
+ * StateRunner_addArenaState(...). Once the state's last reference is popped
+ * and its deconstructor has run (releasing anything the arena doesn't own,
+ * such as textures), the whole arena is reset in one step and returned to
+ * the StateRunner's pool for the next state, rather than each allocation
+ * being freed back to the heap.
+ *
+ * States pushed with StateRunner_addOverlay(...) are transparent overlays:
+ * they draw over the state beneath them, which does not run (and so does
+ * not change) while covered. StateRunner_underlayStale(...) tells an
+ * overlay when that layer must be rendered again, so it may be rendered
+ * once into a cache (see LayerCache) rather than on every frame.
+ *
+ * Runners whose display only changes in response to input may call
+ * StateRunner_skipDraw(...) before drawing. When it returns true, the
+ * previously presented frame is still accurate, so the runner skips
+ * drawing and the main loop can skip presenting (and sleep) for that frame.
+ * Frames in which the running state pops itself are likewise reported as
+ * skipped, as the state below it draws on the following frame.
  * 
  */
 #ifndef STATE_RUNNER_H
 #define STATE_RUNNER_H
 
 #include <stdlib.h>
+#include <stdbool.h>
+
+#include "arena.h"
 
 /******************************************************************************
  * Type definitions
@@ -49,6 +82,10 @@
 // typedefs for convenience
 typedef struct StateRunner StateRunner;
 
+// Reference to a state's data & deconstructor, held by the StateRunner
+typedef int StateHandle;
+#define INVALID_STATE_HANDLE -1
+
 // Parameter is a pointer to a struct of state data, cast as void
 typedef int (*deconstruct_func_t)(void*);
 
@@ -59,6 +96,18 @@ typedef int (*deconstruct_func_t)(void*);
 typedef int (*state_func_t)(StateRunner*, void*, void*);
 
 
+// A state's data, shared by every stack and queue entry referring to it
+typedef struct {
+    void *data;
+    deconstruct_func_t deconstructor;
+    Arena *arena;   // Arena data was allocated from, if any. Returned to
+                    // StateRunner's pool after deconstructor runs
+    int refs;   // Number of stack & queue entries referring to state. A
+                // record with no references is free
+    int next;   // Next record in data lookup chain (or free list)
+} StateRecord;
+
+
 // Struct to store information about states
 struct StateRunner {
 
@@ -75,19 +124,18 @@ struct StateRunner {
     
     int pop_count;
 
-    void **states;
-    // Array of state structs, stored as void pointers.
+    StateHandle *handles;
+    // Array of handles to state data, one reference each.
     // These represent state data for this index. Behaves
     // as a stack.
 
     state_func_t *runners;
     // Array of function pointers to run state logic.
-    // corresponds (by index) to data in `states`.
+    // corresponds (by index) to data in `handles`.
 
-    deconstruct_func_t *deconstructors;
-    // Array of function pointers
-    // deconstruct state structs.
-    // corresponds (by index) to data in `states`
+    bool *overlays;
+    // Array of flags marking transparent overlay states.
+    // corresponds (by index) to data in `handles`.
     
 
     /* Below are temporary buffers to handle states being
@@ -96,9 +144,33 @@ struct StateRunner {
     *  Each is cleared & copied into its corresponding "live" array upon
     *  StateRunner_commitBuffer()
     */
-    void **states_buffer;
+    StateHandle *handles_buffer;
     state_func_t *runners_buffer;
-    deconstruct_func_t *deconstructors_buffer;
+    bool *overlays_buffer;
+
+
+    /* State data, indexed by StateHandle */
+    StateRecord *records;
+    int num_records;    // Number of records (stack size + queue size)
+    int free_record;    // First unused record, or -1 if none
+    int *lookup;        // Hash of state data pointers to record chains
+    int lookup_mask;    // Number of lookup buckets - 1 (a power of two)
+
+
+    /* Arenas for state data - see StateRunner_claimArena() */
+    Arena **arenas;         // Reset arenas, ready to be claimed
+    int num_arenas;         // Number of arenas currently pooled
+    int max_arenas;         // Most arenas that can be pooled
+    size_t arena_capacity;  // Initial capacity of arenas created for pool
+
+
+    /* Presentation tracking - see StateRunner_skipDraw() */
+    bool redraw_requested;      // Force next StateRunner_skipDraw() to draw
+    bool draw_skipped;          // Whether the last run state skipped drawing
+    bool idle;                  // Whether it skipped because nothing changed
+    StateHandle drawn_state;    // State last drawn (and presented)
+    state_func_t drawn_runner;  // Runner that last drew
+    bool underlay_valid;        // Whether top overlay's underlay is rendered
 
 };
 
@@ -157,14 +229,78 @@ int StateRunner_deconstructSingleBlock(StateRunner *self);
 int StateRunner_build(char *memory, int buffer_size, int q_size);
 
 
+/******************************************************************************
+ * State arenas
+******************************************************************************/
+
+/**
+ * @brief - Pool arenas for state data, so states created later are
+ *          allocated without touching the heap.
+ * @param count - Most arenas to keep pooled at once
+ * @param capacity - Initial size (in bytes) of each arena. Arenas grow to
+ *                   fit the largest state allocated from them
+ * @return 0 on success, -1 on failure
+ */
+int StateRunner_reserveArenas(StateRunner *self, int count, size_t capacity);
+
+// Take an empty arena from the pool (creating one if the pool is empty) to
+// allocate a new state from. NULL on failure
+Arena* StateRunner_claimArena(StateRunner *self);
+
+// Give back a claimed arena that was never added with a state, resetting it
+void StateRunner_returnArena(StateRunner *self, Arena *arena);
+
+
 /******************************************************************************
  * State running
 ******************************************************************************/
 
 
-// Add a state to the StateRunner's buffer
+/**
+ * @brief - Add a state to the StateRunner's buffer. If state_data is already
+ *          held by a live handle, that handle is aliased instead (keeping
+ *          its deconstructor, unless it had none)
+ * @return 0 on success, -1 if the buffer is full
+ */
 int StateRunner_addState(StateRunner *self, void* state_data, state_func_t state_runner, deconstruct_func_t state_deconstructor);
 
+/**
+ * @brief - Add another runner over an existing state's data to the
+ *          StateRunner's buffer, sharing ownership of it
+ * @param handle - StateHandle of live state (see StateRunner_currentHandle)
+ * @return 0 on success, -1 if handle is not live or the buffer is full
+ */
+int StateRunner_addAlias(StateRunner *self, StateHandle handle, state_func_t state_runner);
+
+/**
+ * @brief - Add a transparent overlay over an existing state's data to the
+ *          StateRunner's buffer, sharing ownership of it. The overlay is
+ *          drawn over whatever is beneath it (see StateRunner_underlayStale)
+ * @param handle - StateHandle of live state (see StateRunner_currentHandle)
+ * @return 0 on success, -1 if handle is not live or the buffer is full
+ */
+int StateRunner_addOverlay(StateRunner *self, StateHandle handle, state_func_t state_runner);
+
+// Handle of the state on top of the stack (the one running, while a runner
+// executes), or INVALID_STATE_HANDLE if empty
+StateHandle StateRunner_currentHandle(StateRunner *self);
+
+// Number of stack & queue entries referring to a handle (0 if not live)
+int StateRunner_getRefCount(StateRunner *self, StateHandle handle);
+
+/**
+ * @brief - Add a state whose data was allocated from an arena claimed with
+ *          StateRunner_claimArena(...). The arena is owned by the state from
+ *          here on, and is reset & returned to the pool once the state's
+ *          deconstructor runs.
+ * @return 0 on success. -1 if the buffer is full, in which case the state
+ *         is deconstructed and its arena returned immediately
+ */
+int StateRunner_addArenaState(
+    StateRunner *self, Arena *arena, void *state_data,
+    state_func_t state_runner, deconstruct_func_t state_deconstructor
+);
+
 // Migrate buffer states to the "live" state array
 int StateRunner_commitBuffer(StateRunner *self);
 
@@ -185,5 +321,43 @@ int StateRunner_getStateCount(StateRunner *self);
 int StateRunner_setPopCount(StateRunner *self, int count);
 
 
+/******************************************************************************
+ * Presentation
+******************************************************************************/
+
+/**
+ * @brief - Identify if the currently running state may skip drawing this
+ *          frame, marking the frame as skipped if so. Drawing is never
+ *          skipped if the state reports a change, if a different state or
+ *          runner drew last, or if a redraw has been requested.
+ * @param self - StateRunner pointer the state is being run from
+ * @param changed - Whether the state's display changed this frame
+ * @return - true if drawing should be skipped, false if state should draw
+ */
+bool StateRunner_skipDraw(StateRunner *self, bool changed);
+
+// Force the next frame to be drawn (e.g. window was exposed or resized)
+void StateRunner_requestRedraw(StateRunner *self);
+
+// Identify if the last run state skipped drawing (nothing to present)
+bool StateRunner_drawSkipped(StateRunner *self);
+
+// Identify if the last run state skipped drawing because nothing changed,
+// rather than because it was popped. Only then may the caller wait for input
+bool StateRunner_idle(StateRunner *self);
+
+/**
+ * @brief - Identify if the running overlay must render the layer beneath it
+ *          again (it has just been uncovered or pushed, a redraw has been
+ *          requested, or it was invalidated). The layer is then considered
+ *          rendered, and this returns false until it next goes stale.
+ *          Always false for states that aren't overlays.
+ */
+bool StateRunner_underlayStale(StateRunner *self);
+
+// Mark the layer beneath the running overlay as changed
+void StateRunner_invalidateUnderlay(StateRunner *self);
+
+
 
 #endif
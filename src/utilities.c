@@ -5,10 +5,12 @@
 ******************************************************************************/
 #include <stdbool.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "scratch.h"
 #include "sirtet.h"
 
 
@@ -50,6 +52,7 @@ int parseInt(char* txt, int *out_num) {
                     "Cannot parse integer larger than %d\n",
                     INT_MAX
                 );
+                Sirtet_setError(buff);
                 return -1;
             }
             result = result * 10 + digit;
@@ -76,11 +79,11 @@ int parseName(const char* txt, char *out_str, size_t maxlen) {
 
         cur = txt[idx];
 
-        if (cur == EOF) {
+        if (cur == EOF || cur == '\0') {
             return -1;
         }
 
-        if (cur == ' ') {
+        if (cur == ' ' || cur == '\t' || cur == '\r' || cur == '\n') {
             out_str[idx] = '\0';
             return idx;
         }
@@ -95,11 +98,36 @@ int parseName(const char* txt, char *out_str, size_t maxlen) {
 
 
 
+// Supplemental memory of `needed` bytes for a function with a stack buffer
+// of `stack_sz` bytes. Larger needs come from frame scratch memory where
+// available, and only otherwise from the heap (flagged by `on_heap`, to be
+// freed by the caller)
+static void* supplementalMemory(
+    void *stack, size_t stack_sz, size_t needed, bool *on_heap
+) {
+
+    *on_heap = false;
+    if (needed <= stack_sz) {
+        return stack;
+    }
+
+    void *mem = Scratch_alloc(needed);
+    if (mem != NULL) {
+        return mem;
+    }
+
+    *on_heap = true;
+    return malloc(needed);
+}
+
+
 // Populate sort order of `basis` into `indices`
 void sortByBasisDesc(size_t len, int *indices, const int *basis) {
 
-    int st_supp[128];
-    int *supp = (len > 128 ? (int*)malloc(len * sizeof(int)) : st_supp);
+    int st_supp[STATIC_ARRMAX];
+    bool supp_heap;
+    int *supp = (int*)supplementalMemory(
+        st_supp, sizeof(st_supp), len * sizeof(int), &supp_heap);
 
     for (int i = 0; i < len; i++) {
         indices[i] = i;
@@ -162,7 +190,7 @@ void sortByBasisDesc(size_t len, int *indices, const int *basis) {
     // in case we've ended up unswapped
     memcpy(indices, result, sizeof(int) * len);
 
-    if (len > 128) {
+    if (supp_heap) {
         free(supp);
     }
 }
@@ -171,14 +199,16 @@ void sortByBasisDesc(size_t len, int *indices, const int *basis) {
 void sortByOrder(
     void *tosort, const int *order, size_t elem_sz, size_t elem_n) {
 
-    int st_curorder[128];
-    int *curorder = (
-        elem_n > 128 ?
-        (int*)malloc(elem_n * sizeof(int)) :
-        st_curorder);
+    int st_curorder[STATIC_ARRMAX];
+    bool curorder_heap;
+    int *curorder = (int*)supplementalMemory(
+        st_curorder, sizeof(st_curorder), elem_n * sizeof(int),
+        &curorder_heap);
 
-    char st_hold[128];
-    void *hold = (elem_sz > 128 ? malloc(elem_sz) : (void*)st_hold);
+    char st_hold[STATIC_ARRMAX];
+    bool hold_heap;
+    void *hold = supplementalMemory(
+        st_hold, sizeof(st_hold), elem_sz, &hold_heap);
 
 
     for (int i = 0; i < elem_n; i++) {
@@ -212,12 +242,29 @@ void sortByOrder(
         curorder[searchi] = idxhold;
     }
 
-    if (curorder != st_curorder) {
+    if (curorder_heap) {
         free(curorder);
     }
 
-    if (hold != st_hold) {
+    if (hold_heap) {
         free(hold);
     }
 
 }
+
+
+// Bitwise rather than table-driven - checksummed data is small, and this
+// keeps it free of shared state
+uint32_t checksumCrc32(const void *data, size_t len) {
+
+    const unsigned char *bytes = (const unsigned char*)data;
+    uint32_t crc = 0xFFFFFFFFu;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : (crc >> 1);
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
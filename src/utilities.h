@@ -26,8 +26,9 @@
 // parsed
 int parseInt(char* txt, int *out_num);
 
-// Parse a string for characters into out_str, returning the number of 
-// charactesr parsed
+// Parse a string for characters into out_str, up to the first whitespace,
+// returning the number of characters parsed. Returns -1 if the name is longer
+// than maxlen, or text ends before any whitespace
 int parseName(const char* txt, char *out_str, size_t maxlen);
 
 
@@ -38,3 +39,7 @@ void sortByBasisDesc(size_t len, int *indices, const int *basis);
 // Sort `tosort` given the index order in `order`
 void sortByOrder(void *tosort, const int *order, size_t elem_sz, size_t elem_n);
 
+
+
+// CRC-32 (as used by zip, png, etc.) of len bytes of data
+uint32_t checksumCrc32(const void *data, size_t len);
@@ -0,0 +1,90 @@
+/* bench_hiscores.c
+ *
+ * Load times of hiscores text files of increasing size. Not a test suite -
+ * built & run by `make run_benchmarks`
+ */
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hiscores.h"
+#include "sirtet.h"
+
+
+#define BENCH_NAMELEN 3
+#define BENCH_REPEATS 5
+
+
+// Write a text file of n rows, returning it rewound
+static FILE* makeScores(size_t n) {
+
+    FILE *f = tmpfile();
+    if (f == NULL) {
+        return NULL;
+    }
+
+    char name[BENCH_NAMELEN + 1] = {0};
+    for (size_t i = 0; i < n; i++) {
+        for (int c = 0; c < BENCH_NAMELEN; c++) {
+            name[c] = 'A' + (char)((i / (c + 1)) % 26);
+        }
+        fprintf(f, "%s %d\n", name, (int)((i * 7919) % 1000000) - 500);
+    }
+    rewind(f);
+    return f;
+}
+
+
+// Best of BENCH_REPEATS loads of f, in ms
+static double timeLoad(FILE *f, size_t n) {
+
+    double best = -1;
+    for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+
+        rewind(f);
+        Uint64 start = SDL_GetPerformanceCounter();
+        ScoreList *sl = ScoreList_initFromFile(f, 0, BENCH_NAMELEN);
+        Uint64 stop = SDL_GetPerformanceCounter();
+
+        if (sl == NULL || sl->len != n) {
+            printf("Load failed: %s\n", Sirtet_getError());
+            return -1;
+        }
+        ScoreList_deconstruct(sl);
+
+        double ms = (double)(stop - start) * 1000 / SDL_GetPerformanceFrequency();
+        if (best < 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+
+int main() {
+
+    const size_t sizes[3] = {100, 10000, 1000000};
+
+    printf("%10s %12s %14s\n", "rows", "load (ms)", "rows / ms");
+    for (int i = 0; i < 3; i++) {
+
+        FILE *f = makeScores(sizes[i]);
+        if (f == NULL) {
+            printf("Error creating score file\n");
+            return -1;
+        }
+
+        double ms = timeLoad(f, sizes[i]);
+        fclose(f);
+        if (ms < 0) {
+            return -1;
+        }
+
+        printf(
+            "%10zu %12.3f %14.0f\n",
+            sizes[i], ms, ms > 0 ? sizes[i] / ms : 0.0
+        );
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <EWENIT.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testArenaAlloc() {
+
+    Arena *arena = Arena_init(256);
+    ASSERT_TRUE(arena != NULL);
+    ASSERT_EQUAL_INT((int)Arena_used(arena), 0);
+
+    // Allocations are aligned, distinct and bumped from the block
+    char *a = Arena_alloc(arena, 3);
+    char *b = Arena_alloc(arena, 20);
+    char *c = Arena_alloc(arena, 0);
+    ASSERT_EQUAL_INT((int)((uintptr_t)a % ARENA_ALIGN), 0);
+    ASSERT_EQUAL_INT((int)((uintptr_t)b % ARENA_ALIGN), 0);
+    ASSERT_TRUE(a != b && b != c && a != c);
+    ASSERT_TRUE(a >= arena->memory && c < arena->memory + arena->capacity);
+    ASSERT_EQUAL_INT((int)Arena_used(arena), 4 * ARENA_ALIGN);
+
+    memset(a, 'a', 3);
+    memset(b, 'b', 20);
+    ASSERT_EQUAL_INT(a[2], 'a');
+
+    // Zeroed allocations
+    int *ints = Arena_calloc(arena, 8, sizeof(int));
+    bool zeroed = true;
+    for (int i = 0; i < 8; i++) {
+        zeroed = zeroed && ints[i] == 0;
+    }
+    ASSERT_TRUE(zeroed);
+
+    Arena_deconstruct(arena);
+}
+
+
+void testArenaOverflow() {
+
+    Arena *arena = Arena_init(64);
+    size_t capacity = arena->capacity;
+
+    // Exhausting the block still succeeds, from overflow
+    char *a = Arena_alloc(arena, 48);
+    char *b = Arena_alloc(arena, 100);
+    char *c = Arena_alloc(arena, 1000);
+    ASSERT_TRUE(a != NULL && b != NULL && c != NULL);
+    ASSERT_TRUE(arena->overflow != NULL);
+    ASSERT_TRUE(b < arena->memory || b >= arena->memory + capacity);
+    memset(c, 0, 1000);
+
+    size_t high_water = Arena_used(arena);
+    ASSERT_TRUE(high_water >= 48 + 100 + 1000);
+
+    // Reset grows block so the same allocations fit with no overflow
+    Arena_reset(arena);
+    ASSERT_EQUAL_INT((int)Arena_used(arena), 0);
+    ASSERT_TRUE(arena->overflow == NULL);
+    ASSERT_TRUE(arena->capacity >= high_water);
+
+    Arena_alloc(arena, 48);
+    Arena_alloc(arena, 100);
+    Arena_alloc(arena, 1000);
+    ASSERT_TRUE(arena->overflow == NULL);
+
+    // Without overflow, reset reuses the same block
+    char *memory = arena->memory;
+    Arena_reset(arena);
+    ASSERT_TRUE(arena->memory == memory);
+    ASSERT_TRUE(Arena_alloc(arena, 1) == memory);
+
+    Arena_deconstruct(arena);
+
+    // An empty arena works entirely from overflow until first reset
+    arena = Arena_init(0);
+    ASSERT_TRUE(Arena_alloc(arena, 10) != NULL);
+    Arena_reset(arena);
+    ASSERT_TRUE(arena->capacity >= 10);
+    Arena_deconstruct(arena);
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testArenaAlloc);
+    ADD_CASE(testArenaOverflow);
+    EWENIT_END;
+}
@@ -0,0 +1,58 @@
+#include <EWENIT.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "sirtet.h"
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testAssetLoaderFailure() {
+
+    Sirtet_setError("");
+
+    // Empty pack, so every job fails on a worker thread
+    ASSERT_EQUAL_INT(AssetPack_build("test.pack", ".", NULL, 0), 0);
+    AssetPack *pack = AssetPack_initFromFile("test.pack");
+    ASSERT_TRUE(pack != NULL);
+
+    AssetLoader *loader = AssetLoader_init(pack, ".");
+    int jobs[ASSET_LOADER_MAX_JOBS];
+    for (int i = 0; i < ASSET_LOADER_MAX_JOBS; i++) {
+        jobs[i] = (
+            i % 2 == 0
+            ? AssetLoader_addImage(loader, "img/missing.bmp")
+            : AssetLoader_addSound(loader, "sounds/missing.wav")
+        );
+        ASSERT_EQUAL_INT(jobs[i], i);
+    }
+    ASSERT_EQUAL_INT(AssetLoader_addImage(loader, "img/one_too_many.bmp"), -1);
+
+    ASSERT_EQUAL_INT(AssetLoader_start(loader), 0);
+    ASSERT_TRUE(loader->n_threads <= ASSET_LOADER_MAX_THREADS);
+
+    // First failure is reported on the waiting thread
+    Sirtet_setError("");
+    ASSERT_EQUAL_INT(AssetLoader_wait(loader), -1);
+    ASSERT_TRUE(strstr(Sirtet_getError(), "missing") != NULL);
+
+    ASSERT_TRUE(AssetLoader_takeImage(loader, jobs[0]) == NULL);
+    ASSERT_TRUE(AssetLoader_takeSound(loader, jobs[1]) == NULL);
+
+    AssetLoader_deconstruct(loader);
+    AssetPack_deconstruct(pack);
+    remove("test.pack");
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testAssetLoaderFailure);
+    EWENIT_END;
+}
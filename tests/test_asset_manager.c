@@ -0,0 +1,253 @@
+#include <EWENIT.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_manager.h"
+#include "asset_pack.h"
+#include "sirtet.h"
+
+
+/******************************************************************************
+ * Helpers
+******************************************************************************/
+
+// Manager over an empty pack, so that every load fails without touching
+// renderer, TTF or audio
+static AssetManager* emptyManager(AssetPack **out_pack) {
+
+    if (AssetPack_build("test.pack", ".", NULL, 0) != 0) {
+        TEST_FAIL("Error building empty pack");
+        return NULL;
+    }
+    *out_pack = AssetPack_initFromFile("test.pack");
+    return AssetManager_init(*out_pack, ".");
+}
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testAssetManagerRefcounts() {
+
+    AssetPack *pack;
+    AssetManager *mgr = emptyManager(&pack);
+    ASSERT_TRUE(mgr != NULL);
+
+    const AssetDesc font_12 = {ASSET_FONT, "fonts/VT323.ttf", 12};
+    const AssetDesc font_24 = {ASSET_FONT, "fonts/VT323.ttf", 24};
+    const AssetDesc click = {ASSET_SOUND, "sounds/mech_kb_click4.wav"};
+
+    // Same description, same asset. Font sizes are separate assets
+    AssetHandle a = AssetManager_acquire(mgr, &font_24);
+    AssetHandle b = AssetManager_acquire(mgr, &font_24);
+    AssetHandle c = AssetManager_acquire(mgr, &font_12);
+    ASSERT_EQUAL_INT(a, b);
+    ASSERT_NOT_EQUAL_INT(a, c);
+    ASSERT_EQUAL_INT(mgr->count, 2);
+    ASSERT_EQUAL_INT(mgr->entries[a].refs, 2);
+
+    // Nothing is loaded until used
+    ASSERT_FALSE(AssetManager_resident(mgr, a));
+    ASSERT_EQUAL_INT(mgr->n_loads, 0);
+
+    AssetManager_release(mgr, a);
+    ASSERT_EQUAL_INT(mgr->entries[a].refs, 1);
+    AssetManager_release(mgr, b);
+    ASSERT_EQUAL_INT(mgr->entries[a].refs, 0);
+
+    // Releasing what isn't held does nothing
+    AssetManager_release(mgr, a);
+    ASSERT_EQUAL_INT(mgr->entries[a].refs, 0);
+
+    /*** Sets ***/
+
+    const AssetDesc declared[3] = {click, font_24, font_12};
+    AssetSet set = {0};
+    ASSERT_FALSE(AssetSet_held(&set));
+    ASSERT_EQUAL_INT(AssetSet_acquire(&set, mgr, declared, 3), 0);
+    ASSERT_TRUE(AssetSet_held(&set));
+    ASSERT_EQUAL_INT(set.handles[1], a);
+    ASSERT_EQUAL_INT(set.handles[2], c);
+    ASSERT_EQUAL_INT(mgr->entries[set.handles[0]].refs, 1);
+    ASSERT_EQUAL_INT(mgr->entries[c].refs, 2);
+
+    AssetSet_release(&set);
+    AssetSet_release(&set);
+    ASSERT_FALSE(AssetSet_held(&set));
+    ASSERT_EQUAL_INT(mgr->entries[c].refs, 1);
+    ASSERT_EQUAL_INT(mgr->entries[a].refs, 0);
+
+    AssetDesc too_many[ASSET_SET_MAX + 1];
+    for (int i = 0; i < ASSET_SET_MAX + 1; i++) {
+        too_many[i] = click;
+    }
+    ASSERT_EQUAL_INT(AssetSet_acquire(&set, mgr, too_many, ASSET_SET_MAX + 1), -1);
+    ASSERT_FALSE(AssetSet_held(&set));
+
+    /*** Table full ***/
+
+    char names[ASSET_MANAGER_MAX][32];
+    int n_known = mgr->count;
+    for (int i = n_known; i < ASSET_MANAGER_MAX; i++) {
+        snprintf(names[i], 32, "img/%d.bmp", i);
+        AssetDesc desc = {ASSET_IMAGE, names[i]};
+        ASSERT_EQUAL_INT(AssetManager_acquire(mgr, &desc), i);
+    }
+    AssetDesc one_more = {ASSET_IMAGE, "img/one_more.bmp"};
+    ASSERT_EQUAL_INT(AssetManager_acquire(mgr, &one_more), INVALID_ASSET_HANDLE);
+
+    // Failing part way through a set holds nothing
+    const AssetDesc partly_known[2] = {click, one_more};
+    int click_refs = mgr->entries[set.handles[0]].refs;
+    ASSERT_EQUAL_INT(AssetSet_acquire(&set, mgr, partly_known, 2), -1);
+    ASSERT_EQUAL_INT(mgr->entries[AssetManager_acquire(mgr, &click)].refs, click_refs + 1);
+
+    AssetManager_deconstruct(mgr);
+    AssetPack_deconstruct(pack);
+    remove("test.pack");
+}
+
+
+void testAssetManagerMissing() {
+
+    AssetPack *pack;
+    AssetManager *mgr = emptyManager(&pack);
+    ASSERT_TRUE(mgr != NULL);
+
+    const AssetDesc font = {ASSET_FONT, "fonts/missing.ttf", 24};
+    const AssetDesc logo = {ASSET_IMAGE, "img/missing.bmp"};
+    const AssetDesc bg = {ASSET_TILED_IMAGE, "img/missing_"};
+    const AssetDesc boop = {ASSET_SOUND, "sounds/missing.wav"};
+
+    AssetHandle h_font = AssetManager_acquire(mgr, &font);
+    AssetHandle h_logo = AssetManager_acquire(mgr, &logo);
+    AssetHandle h_bg = AssetManager_acquire(mgr, &bg);
+    AssetHandle h_boop = AssetManager_acquire(mgr, &boop);
+
+    // Failed loads say which asset failed
+    Sirtet_setError("");
+    ASSERT_TRUE(AssetManager_font(mgr, h_font) == NULL);
+    ASSERT_TRUE(strstr(Sirtet_getError(), "fonts/missing.ttf") != NULL);
+
+    ASSERT_TRUE(AssetManager_texture(mgr, h_logo) == NULL);
+    ASSERT_TRUE(strstr(Sirtet_getError(), "img/missing.bmp") != NULL);
+
+    // Tiled images are read a quadrant at a time
+    ASSERT_TRUE(AssetManager_texture(mgr, h_bg) == NULL);
+    ASSERT_TRUE(strstr(Sirtet_getError(), "img/missing_TopLeft.bmp") != NULL);
+
+    ASSERT_TRUE(AssetManager_sound(mgr, h_boop) == NULLSOUND);
+    ASSERT_EQUAL_INT(AssetManager_load(mgr, h_boop), -1);
+
+    // Asking for the wrong kind, or an unknown handle
+    Sirtet_setError("");
+    ASSERT_TRUE(AssetManager_texture(mgr, h_boop) == NULL);
+    ASSERT_TRUE(strstr(Sirtet_getError(), "kind") != NULL);
+    ASSERT_TRUE(AssetManager_font(mgr, mgr->count) == NULL);
+    ASSERT_TRUE(AssetManager_font(mgr, INVALID_ASSET_HANDLE) == NULL);
+
+    ASSERT_EQUAL_INT(mgr->n_loads, 0);
+    ASSERT_EQUAL_INT((int)mgr->resident_bytes, 0);
+
+    AssetManager_deconstruct(mgr);
+    AssetPack_deconstruct(pack);
+    remove("test.pack");
+}
+
+
+void testAssetManagerPrefetchFailure() {
+
+    AssetPack *pack;
+    AssetManager *mgr = emptyManager(&pack);
+    ASSERT_TRUE(mgr != NULL);
+
+    const AssetDesc descs[3] = {
+        {ASSET_FONT, "fonts/missing.ttf", 24},
+        {ASSET_TILED_IMAGE, "img/missing_"},
+        {ASSET_SOUND, "sounds/missing.wav"}
+    };
+
+    // Fonts are left to first use. Prefetching registers, but holds nothing
+    ASSERT_EQUAL_INT(AssetManager_prefetch(mgr, descs, 3), 0);
+    ASSERT_TRUE(mgr->loader != NULL);
+    ASSERT_EQUAL_INT(mgr->loader->n_jobs, 5);
+    ASSERT_EQUAL_INT(mgr->count, 2);
+    ASSERT_EQUAL_INT(mgr->entries[0].refs, 0);
+
+    // Already running - nothing more is queued
+    AssetLoader *loader = mgr->loader;
+    ASSERT_EQUAL_INT(AssetManager_prefetch(mgr, descs, 3), 0);
+    ASSERT_TRUE(mgr->loader == loader);
+
+    // First use of an asset in flight waits on the prefetch, then reports
+    // its failure
+    AssetHandle h_boop = AssetManager_acquire(mgr, &descs[2]);
+    Sirtet_setError("");
+    ASSERT_TRUE(AssetManager_sound(mgr, h_boop) == NULLSOUND);
+    ASSERT_TRUE(strstr(Sirtet_getError(), "missing") != NULL);
+    ASSERT_TRUE(mgr->loader == NULL);
+    ASSERT_EQUAL_INT(AssetManager_poll(mgr), 0);
+
+    // Assets that failed to prefetch aren't retried in the background
+    ASSERT_EQUAL_INT(AssetManager_prefetch(mgr, descs, 3), 0);
+    ASSERT_TRUE(mgr->loader == NULL);
+
+    AssetManager_release(mgr, h_boop);
+    AssetManager_deconstruct(mgr);
+    AssetPack_deconstruct(pack);
+    remove("test.pack");
+}
+
+
+void testAssetManagerTrim() {
+
+    AssetPack *pack;
+    AssetManager *mgr = emptyManager(&pack);
+    ASSERT_TRUE(mgr != NULL);
+
+    const AssetDesc descs[2] = {
+        {ASSET_IMAGE, "img/missing.bmp"},
+        {ASSET_SOUND, "sounds/missing.wav"}
+    };
+
+    ASSERT_FALSE(AssetManager_busy(mgr));
+    ASSERT_EQUAL_INT(AssetManager_prefetch(mgr, descs, 2), 0);
+    ASSERT_TRUE(AssetManager_busy(mgr));
+
+    // Trimming assets in flight drops them once picked up, unless they're
+    // acquired in the meantime
+    AssetManager_trim(mgr);
+    ASSERT_TRUE(mgr->entries[0].trimmed);
+    ASSERT_TRUE(mgr->entries[1].trimmed);
+    AssetHandle h_boop = AssetManager_acquire(mgr, &descs[1]);
+
+    while (AssetManager_busy(mgr)) {
+        AssetManager_poll(mgr);
+        SDL_Delay(1);
+    }
+    ASSERT_FALSE(mgr->entries[0].trimmed);
+    ASSERT_FALSE(mgr->entries[0].prefetch_failed);
+    ASSERT_TRUE(mgr->entries[h_boop].prefetch_failed);
+
+    // Dropped assets may be prefetched again
+    ASSERT_EQUAL_INT(AssetManager_prefetch(mgr, descs, 2), 0);
+    ASSERT_TRUE(AssetManager_busy(mgr));
+
+    AssetManager_release(mgr, h_boop);
+    AssetManager_deconstruct(mgr);
+    AssetPack_deconstruct(pack);
+    remove("test.pack");
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testAssetManagerRefcounts);
+    ADD_CASE(testAssetManagerMissing);
+    ADD_CASE(testAssetManagerPrefetchFailure);
+    ADD_CASE(testAssetManagerTrim);
+    EWENIT_END;
+}
@@ -0,0 +1,135 @@
+#include <EWENIT.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+#include "sirtet.h"
+
+
+/******************************************************************************
+ * Helpers
+******************************************************************************/
+
+static void makeAsset(const char *path, const char *content) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        TEST_FAIL("File failed to open for writing");
+        return;
+    }
+    fputs(content, f);
+    fclose(f);
+}
+
+
+// Whether the pack holds the named asset with exactly the given content
+static bool holds(AssetPack *pack, const char *name, const char *content) {
+    size_t size;
+    const char *data = (const char*)AssetPack_find(pack, name, &size);
+    return (
+        data != NULL
+        && size == strlen(content)
+        && memcmp(data, content, size) == 0
+    );
+}
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testAssetPackRoundTrip() {
+
+    Sirtet_setError("");
+
+    makeAsset("test_pack_b.dat", "second asset");
+    makeAsset("test_pack_a.dat", "first");
+    makeAsset("test_pack_c.dat", "");
+
+    // Names given out of order are sorted for lookup
+    const char *names[3] = {"test_pack_b.dat", "test_pack_c.dat", "test_pack_a.dat"};
+    int retval = AssetPack_build("test.pack", ".", names, 3);
+    ASSERT_EQUAL_INT(retval, 0);
+    if (retval != 0) {
+        INFO(Sirtet_getError());
+    }
+
+    AssetPack *pack = AssetPack_initFromFile("test.pack");
+    ASSERT_TRUE(pack != NULL);
+    ASSERT_EQUAL_INT((int)pack->count, 3);
+
+    ASSERT_TRUE(holds(pack, "test_pack_a.dat", "first"));
+    ASSERT_TRUE(holds(pack, "test_pack_b.dat", "second asset"));
+    ASSERT_TRUE(holds(pack, "test_pack_c.dat", ""));
+    ASSERT_TRUE(AssetPack_find(pack, "test_pack_d.dat", NULL) == NULL);
+    ASSERT_TRUE(AssetPack_find(pack, "", NULL) == NULL);
+
+    /*** Same pack, from memory ***/
+
+    unsigned char *copy = (unsigned char*)malloc(pack->size);
+    memcpy(copy, pack->data, pack->size);
+    size_t size = pack->size;
+    AssetPack_deconstruct(pack);
+
+    pack = AssetPack_initFromMemory(copy, size);
+    ASSERT_TRUE(pack != NULL);
+    ASSERT_TRUE(holds(pack, "test_pack_b.dat", "second asset"));
+    AssetPack_deconstruct(pack);
+
+    /*** Damaged packs are refused ***/
+
+    // Index
+    copy[ASSET_PACK_HEADER_SZ] ^= 1;
+    ASSERT_TRUE(AssetPack_initFromMemory(copy, size) == NULL);
+    copy[ASSET_PACK_HEADER_SZ] ^= 1;
+
+    // Truncated data
+    ASSERT_TRUE(AssetPack_initFromMemory(copy, size - 1) == NULL);
+    ASSERT_TRUE(AssetPack_initFromMemory(copy, ASSET_PACK_HEADER_SZ) == NULL);
+
+    // Not a pack
+    copy[0] = 'X';
+    ASSERT_TRUE(AssetPack_initFromMemory(copy, size) == NULL);
+
+    free(copy);
+    remove("test.pack");
+    remove("test_pack_a.dat");
+    remove("test_pack_b.dat");
+    remove("test_pack_c.dat");
+}
+
+
+void testAssetPackBuildErrors() {
+
+    makeAsset("test_pack_a.dat", "first");
+
+    const char *dup[2] = {"test_pack_a.dat", "test_pack_a.dat"};
+    ASSERT_EQUAL_INT(AssetPack_build("test.pack", ".", dup, 2), -1);
+
+    const char *missing[2] = {"test_pack_a.dat", "test_pack_missing.dat"};
+    ASSERT_EQUAL_INT(AssetPack_build("test.pack", ".", missing, 2), -1);
+
+    // No partial pack is left behind
+    FILE *f = fopen("test.pack", "rb");
+    ASSERT_TRUE(f == NULL);
+    if (f != NULL) {
+        fclose(f);
+    }
+
+    char longname[ASSET_PACK_NAME_SZ + 1];
+    memset(longname, 'a', ASSET_PACK_NAME_SZ);
+    longname[ASSET_PACK_NAME_SZ] = '\0';
+    const char *toolong[1] = {longname};
+    ASSERT_EQUAL_INT(AssetPack_build("test.pack", ".", toolong, 1), -1);
+
+    remove("test_pack_a.dat");
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testAssetPackRoundTrip);
+    ADD_CASE(testAssetPackBuildErrors);
+    EWENIT_END;
+}
@@ -432,6 +432,68 @@ void testGameGridAnimation() {
     GameGrid_deconstruct(grid);
 }
 
+void testGameGridDirtyRows() {
+
+    GameGrid *grid = GameGrid_init(4, 4);
+    BlockDb *db = BlockDb_init(8);
+
+    // Freshly cleared grid must be fully redrawn
+    for (int row = 0; row < grid->height; row++) {
+        INFO_FMT("Row %d", row);
+        ASSERT_TRUE(GameGrid_isRowDirty(grid, row));
+    }
+
+    GameGrid_clearDirty(grid);
+    for (int row = 0; row < grid->height; row++) {
+        INFO_FMT("Row %d", row);
+        ASSERT_FALSE(GameGrid_isRowDirty(grid, row));
+    }
+
+    // Out of range rows are never dirty
+    GameGrid_markRowDirty(grid, -1);
+    GameGrid_markRowDirty(grid, 4);
+    ASSERT_FALSE(grid->any_dirty);
+    ASSERT_FALSE(GameGrid_isRowDirty(grid, 4));
+
+    /*
+     * 0 0 0 0
+     * 0 1 1 0
+     * 0 1 1 0
+     * 0 0 0 0
+     */
+    long content_mask = ( 1L << 5 | 1L << 6 | 1L << 9 | 1L << 10 );
+    int block_id = BlockDb_createBlock(
+        db, 4, content_mask, (Point){2, 2}, (SDL_Color){}
+    );
+    GameGrid_commitBlock(grid, db, block_id);
+
+    // Only rows the block landed in are affected
+    ASSERT_FALSE(GameGrid_isRowDirty(grid, 0));
+    ASSERT_TRUE(GameGrid_isRowDirty(grid, 1));
+    ASSERT_TRUE(GameGrid_isRowDirty(grid, 2));
+    ASSERT_FALSE(GameGrid_isRowDirty(grid, 3));
+    GameGrid_clearDirty(grid);
+
+    // Resolving without full rows moves nothing
+    GameGrid_resolveRowsUp(grid, db);
+    ASSERT_FALSE(grid->any_dirty);
+
+    // A full row shifts itself and every row after it
+    for (int col = 0; col < grid->width; col++) {
+        grid->contents[col + 2 * grid->width] = block_id;
+    }
+    BlockDb_incrementCellCount(db, block_id, 2);
+
+    ASSERT_EQUAL_INT(GameGrid_resolveRowsUp(grid, db), 1);
+    ASSERT_FALSE(GameGrid_isRowDirty(grid, 0));
+    ASSERT_FALSE(GameGrid_isRowDirty(grid, 1));
+    ASSERT_TRUE(GameGrid_isRowDirty(grid, 2));
+    ASSERT_TRUE(GameGrid_isRowDirty(grid, 3));
+
+    GameGrid_deconstruct(grid);
+    BlockDb_deconstruct(db);
+}
+
 
 int main() {
     EWENIT_START;
@@ -445,6 +507,7 @@ int main() {
 
     ADD_CASE(testGameGridAssessScore);
     ADD_CASE(testGameGridAnimation);
+    ADD_CASE(testGameGridDirtyRows);
 
 
     // EWENIT_END_COMPACT;
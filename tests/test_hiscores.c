@@ -73,6 +73,9 @@ void testScoreList() {
 
 
     ScoreList_deconstruct(sl);
+
+    // Safe on lists never created (ie: partially initialized state)
+    ScoreList_deconstruct(NULL);
 }
 
 
@@ -118,6 +121,52 @@ void testScoreListSort() {
     ScoreList_deconstruct(sl);
 }
 
+void testScoreListInsert() {
+
+    ScoreList *sl = ScoreList_init(4, 3);
+    char name[16];
+    int score;
+
+    // Ranks of an empty list
+    ASSERT_EQUAL_INT(ScoreList_rankOf(sl, 0), 0);
+
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "BBB", 20), 0);
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "DDD", 5), 1);
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "AAA", 30), 0);
+
+    // Ties go after existing entries with the same score
+    ASSERT_EQUAL_INT(ScoreList_rankOf(sl, 20), 2);
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "CCC", 20), 2);
+    ASSERT_EQUAL_INT(sl->len, 4);
+
+    const char *names[4] = {"AAA", "BBB", "CCC", "DDD"};
+    const int scores[4] = {30, 20, 20, 5};
+    for (int i = 0; i < 4; i++) {
+        ScoreList_get(sl, i, name, &score);
+        ASSERT_EQUAL_STR(name, names[i]);
+        ASSERT_EQUAL_INT(score, scores[i]);
+    }
+
+    // A full list drops its last entry to make room...
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "EEE", 25), 1);
+    ASSERT_EQUAL_INT(sl->len, 4);
+    ScoreList_get(sl, 3, name, &score);
+    ASSERT_EQUAL_STR(name, "CCC");
+    ASSERT_EQUAL_INT(score, 20);
+
+    // ...or leaves out scores that don't rank
+    ASSERT_EQUAL_INT(ScoreList_rankOf(sl, 20), 4);
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "FFF", 20), -1);
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "GGG", 31), 0);
+    ScoreList_get(sl, 3, name, &score);
+    ASSERT_EQUAL_STR(name, "BBB");
+
+    ASSERT_EQUAL_INT(ScoreList_insert(sl, "TOOLONG", 100), -1);
+    ASSERT_EQUAL_INT(sl->len, 4);
+
+    ScoreList_deconstruct(sl);
+}
+
 // make a test_txt file in current directory with provided content
 static inline void makefile(const char* content) {
     FILE *f_write = fopen("test.txt", "w");
@@ -245,10 +294,166 @@ void testFileInteraction() {
 
 
 
+void testInitFromFile() {
+
+    Sirtet_setError("");
+
+    // Sized to fit every row, however few asked for. Last row needn't end
+    // in a newline
+    FILE *f = tmpfile();
+    for (int i = 0; i < 100; i++) {
+        fprintf(f, "N%d %d\n", i % 100, i);
+    }
+    fprintf(f, "\r\n  LST\t-7");
+    rewind(f);
+
+    ScoreList *sl = ScoreList_initFromFile(f, 10, 3);
+    ASSERT_TRUE(sl != NULL);
+    ASSERT_TRUE(sl->size >= 101);
+    ASSERT_EQUAL_INT(sl->len, 101);
+
+    char outname[16];
+    int outscore;
+    ScoreList_get(sl, 42, outname, &outscore);
+    ASSERT_EQUAL_STR(outname, "N42");
+    ASSERT_EQUAL_INT(outscore, 42);
+    ScoreList_get(sl, 100, outname, &outscore);
+    ASSERT_EQUAL_STR(outname, "LST");
+    ASSERT_EQUAL_INT(outscore, -7);
+    fclose(f);
+
+    // Nothing is added from a file that fails partway through
+    const char *bad[4] = {
+        "ABC 10\nDEF 12a\n", "ABC 10\nDEF\n", "ABC 10\nDEF x\n",
+        "ABC 10\nDEF 20\nGHI 30\nJKL 40\n"
+    };
+    ScoreList_deconstruct(sl);
+    sl = ScoreList_init(3, 3);
+    for (int i = 0; i < 4; i++) {
+        f = tmpfile();
+        fprintf(f, "%s", bad[i]);
+        rewind(f);
+        ASSERT_EQUAL_INT(ScoreList_readFile(sl, f), -1);
+        ASSERT_EQUAL_INT(sl->len, 0);
+        fclose(f);
+    }
+
+    ScoreList_deconstruct(sl);
+}
+
+
+void testBinaryFile() {
+
+    Sirtet_setError("");
+
+    ScoreList *sl = ScoreList_init(10, 3);
+    ScoreList_add(sl, "ABC", 10);
+    ScoreList_add(sl, "DE", INT_MIN);
+    ScoreList_add(sl, "F", INT_MAX);
+
+    remove("test.bin");
+    ASSERT_EQUAL_INT(ScoreList_writeBinary(sl, "test.bin"), 0);
+
+    // Temporary file has been renamed into place
+    FILE *f = fopen("test.bin.tmp", "rb");
+    ASSERT_TRUE(f == NULL);
+    if (f != NULL) {
+        fclose(f);
+    }
+
+    /*** Round trip ***/
+
+    ScoreList *read = ScoreList_init(10, 3);
+    int retval = ScoreList_readBinary(read, "test.bin");
+    ASSERT_EQUAL_INT(retval, 0);
+    if (retval != 0) {
+        INFO(Sirtet_getError());
+    }
+    ASSERT_EQUAL_INT(read->len, 3);
+
+    char outname[16];
+    int outscore;
+    ScoreList_get(read, 0, outname, &outscore);
+    ASSERT_EQUAL_STR(outname, "ABC");
+    ASSERT_EQUAL_INT(outscore, 10);
+    ScoreList_get(read, 1, outname, &outscore);
+    ASSERT_EQUAL_STR(outname, "DE");
+    ASSERT_EQUAL_INT(outscore, INT_MIN);
+    ScoreList_get(read, 2, outname, &outscore);
+    ASSERT_EQUAL_STR(outname, "F");
+    ASSERT_EQUAL_INT(outscore, INT_MAX);
+    ScoreList_deconstruct(read);
+
+    // Replacing an existing file
+    ScoreList_pop(sl, NULL, NULL);
+    ASSERT_EQUAL_INT(ScoreList_writeBinary(sl, "test.bin"), 0);
+    read = ScoreList_init(10, 3);
+    ASSERT_EQUAL_INT(ScoreList_readBinary(read, "test.bin"), 0);
+    ASSERT_EQUAL_INT(read->len, 2);
+    ScoreList_deconstruct(read);
+
+    /*** Invalid contents add nothing ***/
+
+    size_t size = HISCORES_HEADER_SZ + 2 * (4 + 3 + 1);
+    unsigned char data[HISCORES_HEADER_SZ + 2 * (4 + 3 + 1)];
+    f = fopen("test.bin", "rb");
+    ASSERT_EQUAL_INT((int)fread(data, 1, size, f), (int)size);
+    fclose(f);
+
+    read = ScoreList_init(10, 3);
+    ASSERT_EQUAL_INT(ScoreList_readBinaryData(read, data, size), 0);
+    ASSERT_EQUAL_INT(read->len, 2);
+    read->len = 0;
+
+    // Corrupted record
+    data[size - 2] ^= 0x01;
+    ASSERT_EQUAL_INT(ScoreList_readBinaryData(read, data, size), -1);
+    data[size - 2] ^= 0x01;
+
+    // Truncated
+    ASSERT_EQUAL_INT(ScoreList_readBinaryData(read, data, size - 1), -1);
+    ASSERT_EQUAL_INT(ScoreList_readBinaryData(read, data, 4), -1);
+
+    // Unknown version
+    data[4]++;
+    ASSERT_EQUAL_INT(ScoreList_readBinaryData(read, data, size), -1);
+    data[4]--;
+
+    // Bad magic
+    data[0] = 'X';
+    ASSERT_EQUAL_INT(ScoreList_readBinaryData(read, data, size), -1);
+    ASSERT_EQUAL_INT(read->len, 0);
+    ScoreList_deconstruct(read);
+
+    // Names that don't fit, or more entries than fit
+    read = ScoreList_init(10, 2);
+    ASSERT_EQUAL_INT(ScoreList_readBinary(read, "test.bin"), -1);
+    ASSERT_EQUAL_INT(read->len, 0);
+    ScoreList_deconstruct(read);
+
+    read = ScoreList_init(1, 3);
+    ASSERT_EQUAL_INT(ScoreList_readBinary(read, "test.bin"), -1);
+    ASSERT_EQUAL_INT(read->len, 0);
+    ScoreList_deconstruct(read);
+
+    // Missing file
+    remove("test.bin");
+    read = ScoreList_init(10, 3);
+    ASSERT_EQUAL_INT(ScoreList_readBinary(read, "test.bin"), -1);
+    ScoreList_deconstruct(read);
+
+    ScoreList_deconstruct(sl);
+}
+
+
+
 int main() {
     EWENIT_START;
     ADD_CASE(testScoreList);
     ADD_CASE(testScoreListSort);
+    ADD_CASE(testScoreListInsert);
     ADD_CASE(testFileInteraction);
+    ADD_CASE(testInitFromFile);
+    ADD_CASE(testBinaryFile);
     EWENIT_END;
 }
@@ -0,0 +1,106 @@
+#include <EWENIT.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hiscores.h"
+#include "hiscores_saver.h"
+#include "sirtet.h"
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testSaverCoalesces() {
+
+    Sirtet_setError("");
+    remove("test_saver.bin");
+
+    HiscoresSaver *saver = HiscoresSaver_init("test_saver.bin", 10, 3);
+    ASSERT_TRUE(saver != NULL);
+
+    // A burst of submissions is written once, as its last snapshot
+    ScoreList *sl = ScoreList_init(10, 3);
+    for (int i = 0; i < 10; i++) {
+        ScoreList_insert(sl, "ABC", i * 10);
+        ASSERT_EQUAL_INT(HiscoresSaver_submit(saver, sl), 0);
+    }
+
+    // Submitted list can change freely once submitted
+    ScoreList_insert(sl, "XYZ", 1000);
+
+    HiscoresSaver_flush(saver);
+    ASSERT_EQUAL_INT((int)saver->n_writes, 1);
+    ASSERT_EQUAL_INT(HiscoresSaver_poll(saver), 0);
+
+    ScoreList *read = ScoreList_init(10, 3);
+    ASSERT_EQUAL_INT(ScoreList_readBinary(read, "test_saver.bin"), 0);
+    ASSERT_EQUAL_INT((int)read->len, 10);
+
+    char name[16];
+    int score;
+    ScoreList_get(read, 0, name, &score);
+    ASSERT_EQUAL_STR(name, "ABC");
+    ASSERT_EQUAL_INT(score, 90);
+
+    // Pending scores are written when the saver stops
+    ASSERT_EQUAL_INT(HiscoresSaver_submit(saver, sl), 0);
+    ASSERT_EQUAL_INT(HiscoresSaver_deconstruct(saver), 0);
+
+    ScoreList_deconstruct(read);
+    read = ScoreList_init(10, 3);
+    ASSERT_EQUAL_INT(ScoreList_readBinary(read, "test_saver.bin"), 0);
+    ScoreList_get(read, 0, name, &score);
+    ASSERT_EQUAL_STR(name, "XYZ");
+    ASSERT_EQUAL_INT(score, 1000);
+
+    // Lists that don't fit are refused
+    saver = HiscoresSaver_init("test_saver.bin", 5, 3);
+    ASSERT_EQUAL_INT(HiscoresSaver_submit(saver, sl), -1);
+    ASSERT_EQUAL_INT(HiscoresSaver_deconstruct(saver), 0);
+
+    ScoreList_deconstruct(read);
+    ScoreList_deconstruct(sl);
+    remove("test_saver.bin");
+}
+
+
+void testSaverReportsFailure() {
+
+    Sirtet_setError("");
+
+    HiscoresSaver *saver = HiscoresSaver_init(
+        "no_such_directory/test_saver.bin", 10, 3);
+    ScoreList *sl = ScoreList_init(10, 3);
+    ScoreList_insert(sl, "ABC", 10);
+
+    HiscoresSaver_submit(saver, sl);
+    HiscoresSaver_flush(saver);
+
+    // Error raised on the worker reaches this thread only through polling
+    ASSERT_EQUAL_STR(Sirtet_getError(), "");
+    ASSERT_EQUAL_INT(HiscoresSaver_poll(saver), -1);
+    ASSERT_TRUE(strlen(Sirtet_getError()) > 0);
+
+    // Reported once
+    Sirtet_setError("");
+    ASSERT_EQUAL_INT(HiscoresSaver_poll(saver), 0);
+    ASSERT_EQUAL_STR(Sirtet_getError(), "");
+
+    // Failures not yet polled are reported on deconstruction
+    HiscoresSaver_submit(saver, sl);
+    ASSERT_EQUAL_INT(HiscoresSaver_deconstruct(saver), -1);
+    ASSERT_TRUE(strlen(Sirtet_getError()) > 0);
+
+    ScoreList_deconstruct(sl);
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testSaverCoalesces);
+    ADD_CASE(testSaverReportsFailure);
+    EWENIT_END;
+}
@@ -0,0 +1,422 @@
+#include <EWENIT.h>
+#include <limits.h>
+#include "inputs.h"
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testInputTrackerFrameCount() {
+
+    InputTracker *tracker = InputTracker_init();
+    InputTracker_beginFrame(tracker, 0);
+
+    // Never pressed
+    ASSERT_EQUAL_INT(
+        InputTracker_frameCount(tracker, SDL_SCANCODE_A), INT_MIN);
+
+    // Pressed, counting up
+    InputTracker_press(tracker, SDL_SCANCODE_A, 0);
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_A), 1);
+
+    for (int i = 2; i <= 10; i++) {
+        InputTracker_beginFrame(tracker, 0);
+        ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_A), i);
+    }
+
+    // Auto-repeat presses are ignored
+    InputTracker_press(tracker, SDL_SCANCODE_A, 0);
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_A), 10);
+
+    // Released, counting down
+    InputTracker_beginFrame(tracker, 0);
+    InputTracker_release(tracker, SDL_SCANCODE_A, 0);
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_A), -1);
+
+    for (int i = 2; i <= 10; i++) {
+        InputTracker_beginFrame(tracker, 0);
+        ASSERT_EQUAL_INT(
+            InputTracker_frameCount(tracker, SDL_SCANCODE_A), -i);
+    }
+
+    // Release and re-press within one frame registers as a fresh press
+    InputTracker_beginFrame(tracker, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_A, 0);
+    InputTracker_beginFrame(tracker, 0);
+    InputTracker_release(tracker, SDL_SCANCODE_A, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_A, 0);
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_A), 1);
+
+    // Press and release within one frame registers only the release
+    InputTracker_press(tracker, SDL_SCANCODE_B, 0);
+    InputTracker_release(tracker, SDL_SCANCODE_B, 0);
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_B), -1);
+
+    InputTracker_deconstruct(tracker);
+}
+
+
+void testInputTrackerActiveSet() {
+
+    InputTracker *tracker = InputTracker_init();
+    InputTracker_beginFrame(tracker, 0);
+
+    ASSERT_EQUAL_INT(tracker->n_active, 0);
+    ASSERT_EQUAL_INT(tracker->n_held, 0);
+
+    InputTracker_press(tracker, SDL_SCANCODE_A, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_B, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_C, 0);
+    ASSERT_EQUAL_INT(tracker->n_active, 3);
+    ASSERT_EQUAL_INT(tracker->n_held, 3);
+
+    // Released keys remain active through the frame they're released in
+    InputTracker_beginFrame(tracker, 0);
+    InputTracker_release(tracker, SDL_SCANCODE_A, 0);
+    ASSERT_EQUAL_INT(tracker->n_active, 3);
+    ASSERT_EQUAL_INT(tracker->n_held, 2);
+
+    InputTracker_beginFrame(tracker, 0);
+    ASSERT_EQUAL_INT(tracker->n_active, 2);
+    ASSERT_EQUAL_INT(tracker->n_held, 2);
+
+    // Remaining entries still index back to their own position
+    for (int i = 0; i < tracker->n_active; i++) {
+        ASSERT_EQUAL_INT(tracker->active_idx[tracker->active[i]], i);
+    }
+    ASSERT_EQUAL_INT(tracker->active_idx[SDL_SCANCODE_A], -1);
+
+    InputTracker_release(tracker, SDL_SCANCODE_B, 0);
+    InputTracker_release(tracker, SDL_SCANCODE_C, 0);
+    InputTracker_beginFrame(tracker, 0);
+    ASSERT_EQUAL_INT(tracker->n_active, 0);
+    ASSERT_EQUAL_INT(tracker->n_held, 0);
+
+    // Counts of inactive keys continue aging regardless
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_A), -3);
+    ASSERT_EQUAL_INT(InputTracker_frameCount(tracker, SDL_SCANCODE_B), -2);
+
+    InputTracker_deconstruct(tracker);
+}
+
+
+void testProcessGamecodes() {
+
+    InputTracker *tracker = InputTracker_init();
+    GamecodeMap *map = GamecodeMap_init(8);
+    bool states[NUM_GAMECODES];
+
+    // Once on press, then every 2 frames from frame 4 through 8
+    GamecodeMap_addMap(map, GAMECODE_ROTATE, SDL_SCANCODE_UP, 1, 1, 0);
+    GamecodeMap_addMap(map, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 4, 8, 2);
+
+    bool expected_left[10] = {
+        false, false, false, true, false, true, false, true, false, false
+    };
+
+    InputTracker_beginFrame(tracker, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_UP, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_LEFT, 0);
+
+    for (int i = 0; i < 10; i++) {
+        if (i > 0) {
+            InputTracker_beginFrame(tracker, 0);
+        }
+        processGamecodes(states, NULL, tracker, map);
+
+        INFO_FMT("Frame %d", i + 1);
+        ASSERT_EQUAL_INT(
+            Gamecode_pressed(states, GAMECODE_ROTATE), i == 0);
+        ASSERT_EQUAL_INT(
+            Gamecode_pressed(states, GAMECODE_MOVE_LEFT), expected_left[i]);
+    }
+
+    GamecodeMap_deconstruct(map);
+    InputTracker_deconstruct(tracker);
+}
+
+
+// Stateless reference for when a mapping should emit
+static bool moduloEmits(int start, int end, int interval, int frame_count) {
+    return (
+        frame_count >= start && frame_count <= end
+        && (interval == 0 || (frame_count - start) % interval == 0)
+    );
+}
+
+
+void testRepeatSchedule() {
+
+    int params[][3] = {
+        {1, 1, 1}, {1, 1, 0}, {3, 20, 4}, {1, INT_MAX, 3}, {5, 9, 0},
+        {-3, -1, 1}, {-6, -2, 2}
+    };
+    int n_params = sizeof(params) / sizeof(params[0]);
+
+    InputTracker *tracker = InputTracker_init();
+    GamecodeMap *map = GamecodeMap_init(n_params);
+    for (int i = 0; i < n_params; i++) {
+        GamecodeMap_addMap(
+            map, (Gamecode)i, SDL_SCANCODE_A,
+            params[i][0], params[i][1], params[i][2]
+        );
+    }
+
+    bool states[NUM_GAMECODES];
+
+    // Two presses, the second evaluated only on some frames
+    for (int frame = 0; frame < 80; frame++) {
+
+        InputTracker_beginFrame(tracker, 0);
+        if (frame == 0 || frame == 40) {
+            InputTracker_press(tracker, SDL_SCANCODE_A, 0);
+        }
+        if (frame == 30 || frame == 70) {
+            InputTracker_release(tracker, SDL_SCANCODE_A, 0);
+        }
+
+        if (frame > 40 && frame % 3 == 0) {
+            continue;
+        }
+
+        int count = InputTracker_frameCount(tracker, SDL_SCANCODE_A);
+        processGamecodes(states, NULL, tracker, map);
+
+        for (int i = 0; i < n_params; i++) {
+            INFO_FMT("Frame %d, mapping %d", frame, i);
+            ASSERT_EQUAL_INT(
+                Gamecode_pressed(states, (Gamecode)i),
+                moduloEmits(params[i][0], params[i][1], params[i][2], count)
+            );
+        }
+
+        // Processing again within a frame gives the same result
+        bool again[NUM_GAMECODES];
+        processGamecodes(again, NULL, tracker, map);
+        for (int i = 0; i < n_params; i++) {
+            ASSERT_EQUAL_INT(again[i], states[i]);
+        }
+    }
+
+    GamecodeMap_deconstruct(map);
+    InputTracker_deconstruct(tracker);
+}
+
+
+void testMenucodeLookup() {
+
+    InputTracker *tracker = InputTracker_init();
+    MenucodeMap *map = MenucodeMap_init(MAX_MENUCODE_MAPS);
+    bool states[NUM_MENUCODES];
+
+    MenucodePreset_standard(map, 1, 1, 1);
+    MenucodePreset_upperAlpha(map, 1, 1, 1);
+
+    // Duplicate codes on a single key share its lookup chain
+    ASSERT_EQUAL_INT(
+        Menucode_addMap(map, MENUCODE_SELECT, SDL_SCANCODE_Q, 1, 1, 1), 0);
+
+    ASSERT_EQUAL_INT(
+        Menucode_addMap(map, MENUCODE_SELECT, SDL_NUM_SCANCODES, 1, 1, 1), -1);
+
+    InputTracker_beginFrame(tracker, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_Q, 0);
+    InputTracker_press(tracker, SDL_SCANCODE_UP, 0);
+    processMenucodes(states, tracker, map);
+
+    for (int mc = 0; mc < NUM_MENUCODES; mc++) {
+        INFO_FMT("Menucode %d", mc);
+        ASSERT_EQUAL_INT(
+            Menucode_pressed(states, (Menucode)mc),
+            (
+                mc == MENUCODE_ALPHA_UC_Q
+                || mc == MENUCODE_SELECT
+                || mc == MENUCODE_MOVE_UP
+            )
+        );
+    }
+
+    InputTracker_beginFrame(tracker, 0);
+    processMenucodes(states, tracker, map);
+    for (int mc = 0; mc < NUM_MENUCODES; mc++) {
+        ASSERT_FALSE(Menucode_pressed(states, (Menucode)mc));
+    }
+
+    MenucodeMap_deconstruct(map);
+    InputTracker_deconstruct(tracker);
+}
+
+
+void testTimedMappings() {
+
+    InputTracker *tracker = InputTracker_init();
+    GamecodeMap *map = GamecodeMap_init(8);
+    bool states[NUM_GAMECODES];
+    GamecodeEmission emissions[NUM_GAMECODES];
+
+    // Once on press, then after 200ms, every 50ms
+    GamecodeMap_addTimedMap(map, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 0, 0);
+    GamecodeMap_addTimedMap(
+        map, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 200, 50);
+    GamecodeMap_addTimedMap(map, GAMECODE_MOVE_RIGHT, SDL_SCANCODE_RIGHT, 0, 0);
+
+    // Press part way through a frame
+    InputTracker_beginFrame(tracker, 1000);
+    InputTracker_press(tracker, SDL_SCANCODE_LEFT, 990);
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_EQUAL_INT(Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).count, 1);
+    ASSERT_EQUAL_INT(
+        Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).first_ms, 990);
+
+    // Nothing until delay has passed
+    InputTracker_beginFrame(tracker, 1189);
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_FALSE(Gamecode_pressed(states, GAMECODE_MOVE_LEFT));
+
+    // A long frame catches up on every repeat due within it
+    InputTracker_beginFrame(tracker, 1340);
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_EQUAL_INT(Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).count, 4);
+    ASSERT_EQUAL_INT(
+        Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).first_ms, 1190);
+
+    // Processing again within a frame gives the same result
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_EQUAL_INT(Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).count, 4);
+
+    // Repeats up until release are counted, but none after
+    InputTracker_beginFrame(tracker, 1400);
+    InputTracker_release(tracker, SDL_SCANCODE_LEFT, 1395);
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_EQUAL_INT(Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).count, 1);
+
+    InputTracker_beginFrame(tracker, 1500);
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_FALSE(Gamecode_pressed(states, GAMECODE_MOVE_LEFT));
+
+    // A tap within a single frame still emits, ordered by press time
+    InputTracker_beginFrame(tracker, 1600);
+    InputTracker_press(tracker, SDL_SCANCODE_RIGHT, 1580);
+    InputTracker_press(tracker, SDL_SCANCODE_LEFT, 1590);
+    InputTracker_release(tracker, SDL_SCANCODE_RIGHT, 1585);
+    processGamecodes(states, emissions, tracker, map);
+    ASSERT_TRUE(Gamecode_pressed(states, GAMECODE_MOVE_RIGHT));
+    ASSERT_TRUE(Gamecode_pressed(states, GAMECODE_MOVE_LEFT));
+    ASSERT_TRUE(
+        Gamecode_emission(emissions, GAMECODE_MOVE_RIGHT).first_ms
+        < Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).first_ms
+    );
+
+    // A key already held when a map is first evaluated (ie: by a state just
+    // started) emits only what comes due from then on
+    GamecodeMap *fresh = GamecodeMap_init(8);
+    GamecodeMap_addTimedMap(fresh, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 0, 0);
+    GamecodeMap_addTimedMap(
+        fresh, GAMECODE_MOVE_LEFT, SDL_SCANCODE_LEFT, 200, 50);
+
+    InputTracker_beginFrame(tracker, 2000);
+    processGamecodes(states, emissions, tracker, fresh);
+    ASSERT_FALSE(Gamecode_pressed(states, GAMECODE_MOVE_LEFT));
+
+    InputTracker_beginFrame(tracker, 2050);
+    processGamecodes(states, emissions, tracker, fresh);
+    ASSERT_EQUAL_INT(Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).count, 1);
+    ASSERT_EQUAL_INT(
+        Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).first_ms, 2040);
+
+    // As do frames the map wasn't evaluated in (ie: state paused)
+    InputTracker_beginFrame(tracker, 2100);
+    InputTracker_beginFrame(tracker, 2300);
+    processGamecodes(states, emissions, tracker, fresh);
+    ASSERT_FALSE(Gamecode_pressed(states, GAMECODE_MOVE_LEFT));
+
+    InputTracker_beginFrame(tracker, 2350);
+    processGamecodes(states, emissions, tracker, fresh);
+    ASSERT_EQUAL_INT(Gamecode_emission(emissions, GAMECODE_MOVE_LEFT).count, 1);
+
+    GamecodeMap_deconstruct(fresh);
+    GamecodeMap_deconstruct(map);
+    InputTracker_deconstruct(tracker);
+}
+
+
+void testInputRing() {
+
+    InputRing *ring = InputRing_init(5);
+    ASSERT_EQUAL_INT(ring->mask, 7);
+
+    InputRingEvent event = {.type=SDL_KEYDOWN};
+    InputRingEvent out;
+
+    ASSERT_FALSE(InputRing_pop(ring, &out));
+
+    // Fill past capacity, wrapping around several times
+    for (int round = 0; round < 5; round++) {
+
+        for (int i = 0; i < 10; i++) {
+            event.timestamp = round * 100 + i;
+            ASSERT_EQUAL_INT(InputRing_push(ring, &event), i < 8);
+        }
+
+        for (int i = 0; i < 8; i++) {
+            ASSERT_TRUE(InputRing_pop(ring, &out));
+            ASSERT_EQUAL_INT(out.timestamp, round * 100 + i);
+        }
+        ASSERT_FALSE(InputRing_pop(ring, &out));
+    }
+    ASSERT_EQUAL_INT(SDL_AtomicGet(&ring->dropped), 10);
+
+    InputRing_deconstruct(ring);
+}
+
+
+#define RING_THREAD_EVENTS 100000
+
+static int ringProducer(void *data) {
+    InputRing *ring = (InputRing*)data;
+    InputRingEvent event = {.type=SDL_KEYDOWN};
+    for (Uint32 i = 0; i < RING_THREAD_EVENTS; i++) {
+        event.timestamp = i;
+        while (!InputRing_push(ring, &event)) {}
+    }
+    return 0;
+}
+
+void testInputRingThreaded() {
+
+    InputRing *ring = InputRing_init(64);
+    SDL_Thread *producer = SDL_CreateThread(ringProducer, "producer", ring);
+
+    // Every event arrives, in order
+    Uint32 expected = 0;
+    bool in_order = true;
+    InputRingEvent out;
+    while (expected < RING_THREAD_EVENTS) {
+        if (InputRing_pop(ring, &out)) {
+            in_order = in_order && out.timestamp == expected;
+            expected++;
+        }
+    }
+    SDL_WaitThread(producer, NULL);
+
+    ASSERT_TRUE(in_order);
+    ASSERT_FALSE(InputRing_pop(ring, &out));
+
+    InputRing_deconstruct(ring);
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testInputTrackerFrameCount);
+    ADD_CASE(testInputTrackerActiveSet);
+    ADD_CASE(testProcessGamecodes);
+    ADD_CASE(testRepeatSchedule);
+    ADD_CASE(testMenucodeLookup);
+    ADD_CASE(testTimedMappings);
+    ADD_CASE(testInputRing);
+    ADD_CASE(testInputRingThreaded);
+    EWENIT_END;
+}
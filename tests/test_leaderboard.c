@@ -0,0 +1,217 @@
+#include <EWENIT.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hiscores.h"
+#include "leaderboard.h"
+#include "sirtet.h"
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testLeaderboardRanks() {
+
+    Leaderboard *lb = Leaderboard_init(3);
+    ASSERT_TRUE(lb != NULL);
+
+    ASSERT_EQUAL_INT((int)Leaderboard_rankOf(lb, 0), 0);
+    ASSERT_EQUAL_INT(Leaderboard_get(lb, 0, NULL, NULL), -1);
+
+    ASSERT_EQUAL_INT(Leaderboard_add(lb, "BBB", 20), 0);
+    ASSERT_EQUAL_INT(Leaderboard_add(lb, "DDD", 5), 1);
+    ASSERT_EQUAL_INT(Leaderboard_add(lb, "AAA", 30), 0);
+
+    // Ties go after existing entries with the same score
+    ASSERT_EQUAL_INT(Leaderboard_add(lb, "CCC", 20), 2);
+    ASSERT_EQUAL_INT(Leaderboard_add(lb, "TOOLONG", 20), -1);
+    ASSERT_EQUAL_INT((int)lb->len, 4);
+
+    const char *names[4] = {"AAA", "BBB", "CCC", "DDD"};
+    const int scores[4] = {30, 20, 20, 5};
+    char name[16];
+    int score;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQUAL_INT(Leaderboard_get(lb, i, name, &score), 0);
+        ASSERT_EQUAL_STR(name, names[i]);
+        ASSERT_EQUAL_INT(score, scores[i]);
+    }
+
+    // Many entries, checked against counting directly
+    srand(1234);
+    int *added = (int*)malloc(20000 * sizeof(int));
+    for (int i = 0; i < 20000; i++) {
+        added[i] = rand() % 5000 - 100;
+        Leaderboard_add(lb, "X", added[i]);
+    }
+
+    bool ranks_match = true;
+    for (int probe = -200; probe < 5100; probe += 37) {
+        size_t expected = 0;
+        for (int i = 0; i < 20000; i++) {
+            expected += added[i] >= probe;
+        }
+        for (int i = 0; i < 4; i++) {
+            expected += scores[i] >= probe;
+        }
+        ranks_match = ranks_match && Leaderboard_rankOf(lb, probe) == expected;
+    }
+    ASSERT_TRUE(ranks_match);
+
+    bool ordered = true;
+    int last = INT_MAX;
+    for (size_t rank = 0; rank < lb->len; rank++) {
+        Leaderboard_get(lb, rank, NULL, &score);
+        ordered = ordered && score <= last;
+        last = score;
+    }
+    ASSERT_TRUE(ordered);
+
+    free(added);
+    Leaderboard_deconstruct(lb);
+}
+
+
+void testLeaderboardScoreList() {
+
+    Leaderboard *lb = Leaderboard_init(3);
+    for (int i = 0; i < 50; i++) {
+        Leaderboard_add(lb, "ABC", i);
+    }
+
+    ScoreList *sl = ScoreList_init(10, 3);
+    ASSERT_EQUAL_INT(Leaderboard_toScoreList(lb, sl), 10);
+    ASSERT_EQUAL_INT((int)sl->len, 10);
+
+    int score;
+    ScoreList_get(sl, 0, NULL, &score);
+    ASSERT_EQUAL_INT(score, 49);
+    ScoreList_get(sl, 9, NULL, &score);
+    ASSERT_EQUAL_INT(score, 40);
+
+    // Only fills empty lists
+    ASSERT_EQUAL_INT(Leaderboard_toScoreList(lb, sl), -1);
+
+    ScoreList_deconstruct(sl);
+    Leaderboard_deconstruct(lb);
+}
+
+
+void testLeaderboardIngest() {
+
+    FILE *f = tmpfile();
+    fprintf(f, "ABC 10\n\n  DEF -45\r\nGHI 2147483647");
+    rewind(f);
+
+    Leaderboard *lb = Leaderboard_init(3);
+    ASSERT_EQUAL_INT(Leaderboard_ingest(lb, f), 3);
+
+    char name[16];
+    int score;
+    Leaderboard_get(lb, 0, name, &score);
+    ASSERT_EQUAL_STR(name, "GHI");
+    ASSERT_EQUAL_INT(score, 2147483647);
+    Leaderboard_get(lb, 2, name, &score);
+    ASSERT_EQUAL_STR(name, "DEF");
+    ASSERT_EQUAL_INT(score, -45);
+    fclose(f);
+
+    // Malformed lines stop ingestion
+    const char *bad[3] = {"ABCD 10\n", "ABC ten\n", "ABC 10 extra\n"};
+    for (int i = 0; i < 3; i++) {
+        f = tmpfile();
+        fprintf(f, "XYZ 1\n%s", bad[i]);
+        rewind(f);
+        ASSERT_EQUAL_INT(Leaderboard_ingest(lb, f), -1);
+        fclose(f);
+    }
+
+    Leaderboard_deconstruct(lb);
+}
+
+
+// Sort n generated lines in runs of run_len, checking output is in order
+static void checkSortFile(int n, size_t run_len) {
+
+    FILE *in = tmpfile();
+    for (int i = 0; i < n; i++) {
+        // Plenty of ties, named by position to check they stay in order
+        fprintf(in, "%d %d\n", i, (i * 7919) % 1000);
+    }
+    rewind(in);
+
+    FILE *out = tmpfile();
+    long written = Leaderboard_sortFile(in, out, 8, run_len);
+    ASSERT_EQUAL_INT((int)written, n);
+    rewind(out);
+
+    Leaderboard *lb = Leaderboard_init(8);
+    ASSERT_EQUAL_INT(Leaderboard_ingest(lb, out), n);
+    rewind(out);
+
+    // Output lines appear exactly in rank order
+    char line[32];
+    char expected[32];
+    char name[16];
+    int score;
+    bool in_order = true;
+    for (int rank = 0; rank < n; rank++) {
+        Leaderboard_get(lb, rank, name, &score);
+        snprintf(expected, 32, "%s %d\n", name, score);
+        in_order = (
+            in_order
+            && fgets(line, 32, out) != NULL
+            && strcmp(line, expected) == 0
+        );
+    }
+    ASSERT_TRUE(in_order);
+
+    bool stable = true;
+    int last_score = INT_MAX;
+    int last_pos = -1;
+    for (int rank = 0; rank < n; rank++) {
+        Leaderboard_get(lb, rank, name, &score);
+        int pos = atoi(name);
+        stable = stable && (score < last_score || pos > last_pos);
+        last_score = score;
+        last_pos = pos;
+    }
+    ASSERT_TRUE(stable);
+
+    Leaderboard_deconstruct(lb);
+    fclose(in);
+    fclose(out);
+}
+
+
+void testLeaderboardSortFile() {
+
+    // In memory, then spilled to runs, then merged through levels
+    checkSortFile(500, 1000);
+    checkSortFile(500, 16);
+    checkSortFile(5000, 7);
+
+    // Malformed input
+    FILE *in = tmpfile();
+    FILE *out = tmpfile();
+    fprintf(in, "ABC 10\nABC\n");
+    rewind(in);
+    ASSERT_EQUAL_INT((int)Leaderboard_sortFile(in, out, 3, 1), -1);
+    fclose(in);
+    fclose(out);
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testLeaderboardRanks);
+    ADD_CASE(testLeaderboardScoreList);
+    ADD_CASE(testLeaderboardIngest);
+    ADD_CASE(testLeaderboardSortFile);
+    EWENIT_END;
+}
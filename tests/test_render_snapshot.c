@@ -0,0 +1,151 @@
+#include <EWENIT.h>
+#include <stdbool.h>
+#include "render_snapshot.h"
+
+
+/******************************************************************************
+ * Test definition
+******************************************************************************/
+
+
+void testSnapshotPublishAcquire() {
+
+    SnapshotBuffer *buffer = SnapshotBuffer_init(4, 3);
+
+    // Nothing published yet
+    ASSERT_TRUE(SnapshotBuffer_acquire(buffer) == NULL);
+
+    RenderSnapshot *slot = SnapshotBuffer_writeSlot(buffer);
+    slot->score = 10;
+    SnapshotBuffer_publish(buffer);
+
+    const RenderSnapshot *snapshot = SnapshotBuffer_acquire(buffer);
+    ASSERT_TRUE(snapshot != NULL);
+    ASSERT_EQUAL_INT(snapshot->score, 10);
+    ASSERT_EQUAL_INT((int)snapshot->tick, 1);
+
+    // Producer never writes into the slot being drawn
+    ASSERT_TRUE(SnapshotBuffer_writeSlot(buffer) != snapshot);
+
+    // Acquiring again with nothing new keeps the same snapshot
+    ASSERT_TRUE(SnapshotBuffer_acquire(buffer) == snapshot);
+
+    // Only the newest of several publishes is seen
+    for (int i = 1; i <= 5; i++) {
+        slot = SnapshotBuffer_writeSlot(buffer);
+        ASSERT_TRUE(slot != snapshot);
+        slot->score = 10 + i;
+        SnapshotBuffer_publish(buffer);
+    }
+    ASSERT_EQUAL_INT(snapshot->score, 10);
+
+    snapshot = SnapshotBuffer_acquire(buffer);
+    ASSERT_EQUAL_INT(snapshot->score, 15);
+    ASSERT_EQUAL_INT((int)snapshot->tick, 6);
+
+    SnapshotBuffer_deconstruct(buffer);
+}
+
+
+void testSnapshotRowStaleness() {
+
+    SnapshotBuffer *buffer = SnapshotBuffer_init(4, 3);
+
+    // Rows are stale in each slot until that slot is first written
+    bool written[SNAPSHOT_SLOTS] = {false};
+    for (int i = 0; i < 2 * SNAPSHOT_SLOTS; i++) {
+        int slot = SnapshotBuffer_writeSlot(buffer) - buffer->slots;
+        for (int row = 0; row < 3; row++) {
+            ASSERT_EQUAL_INT(
+                SnapshotBuffer_isRowStale(buffer, row), !written[slot]);
+        }
+        written[slot] = true;
+        SnapshotBuffer_publish(buffer);
+
+        // Let consumer take a slot now and then, cycling all three
+        if (i % 2 == 0) {
+            SnapshotBuffer_acquire(buffer);
+        }
+    }
+
+    // A change is stale in each slot until that slot is next written
+    SnapshotBuffer_markRowChanged(buffer, 1);
+    Uint64 changed_tick = buffer->n_published + 1;
+    bool rewritten[SNAPSHOT_SLOTS] = {false};
+    for (int i = 0; i < 2 * SNAPSHOT_SLOTS; i++) {
+        int slot = SnapshotBuffer_writeSlot(buffer) - buffer->slots;
+        ASSERT_FALSE(SnapshotBuffer_isRowStale(buffer, 0));
+        ASSERT_EQUAL_INT(
+            SnapshotBuffer_isRowStale(buffer, 1), !rewritten[slot]);
+        ASSERT_FALSE(SnapshotBuffer_isRowStale(buffer, 2));
+        rewritten[slot] = true;
+        SnapshotBuffer_publish(buffer);
+        SnapshotBuffer_acquire(buffer);
+    }
+
+    // Published snapshots record when each row changed
+    const RenderSnapshot *snapshot = SnapshotBuffer_acquire(buffer);
+    ASSERT_EQUAL_INT((int)snapshot->row_ticks[0], 1);
+    ASSERT_EQUAL_INT((int)snapshot->row_ticks[1], (int)changed_tick);
+
+    // Out of range rows are ignored
+    SnapshotBuffer_markRowChanged(buffer, -1);
+    SnapshotBuffer_markRowChanged(buffer, 3);
+    ASSERT_FALSE(SnapshotBuffer_isRowStale(buffer, 3));
+
+    ASSERT_TRUE(SnapshotBuffer_init(0, 3) == NULL);
+
+    SnapshotBuffer_deconstruct(buffer);
+}
+
+
+#define SNAPSHOT_THREAD_PUBLISHES 100000
+
+static int snapshotProducer(void *data) {
+    SnapshotBuffer *buffer = (SnapshotBuffer*)data;
+    for (int i = 1; i <= SNAPSHOT_THREAD_PUBLISHES; i++) {
+        RenderSnapshot *slot = SnapshotBuffer_writeSlot(buffer);
+        slot->score = i;
+        slot->level = i;
+        SnapshotBuffer_publish(buffer);
+    }
+    return 0;
+}
+
+void testSnapshotThreaded() {
+
+    SnapshotBuffer *buffer = SnapshotBuffer_init(4, 3);
+    SDL_Thread *producer = SDL_CreateThread(
+        snapshotProducer, "snapshot producer", (void*)buffer
+    );
+
+    // Snapshots are never torn, and never go backwards
+    bool consistent = true;
+    int last = 0;
+    while (last < SNAPSHOT_THREAD_PUBLISHES) {
+        const RenderSnapshot *snapshot = SnapshotBuffer_acquire(buffer);
+        if (snapshot == NULL) {
+            continue;
+        }
+        consistent = (
+            consistent
+            && snapshot->score == snapshot->level
+            && snapshot->score >= last
+        );
+        last = snapshot->score;
+    }
+    SDL_WaitThread(producer, NULL);
+
+    ASSERT_TRUE(consistent);
+
+    SnapshotBuffer_deconstruct(buffer);
+}
+
+
+int main() {
+    EWENIT_START;
+    ADD_CASE(testSnapshotPublishAcquire);
+    ADD_CASE(testSnapshotRowStaleness);
+    ADD_CASE(testSnapshotThreaded);
+    EWENIT_END;
+}
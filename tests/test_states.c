@@ -41,6 +41,18 @@ int runFuncPop5(StateRunner *runner, void *app_data, void *state_data) {
          return 0;
 }
 
+// A state runner that only counts frames it actually draws, with a static
+// display (never reports a change)
+int runFuncStatic(StateRunner *runner, void *app_data, void *state_data) {
+    TestStruct *local_state = (TestStruct*)state_data;
+
+    if (StateRunner_skipDraw(runner, false)) {
+        return 0;
+    }
+    local_state->run_count++;
+    return 0;
+}
+
 static int deconFunc(void *state_data) {
     TestStruct *local_state = (TestStruct*)state_data;
     local_state->deconstruct_count++;
@@ -84,7 +96,8 @@ void testStateRunnerInit() {
 
 void testRunState() {
 
-    char mem_buffer[1000];
+    assert(10000 >= StateRunner_requiredBytes(32, 16));
+    char mem_buffer[10000];
     StateRunner_build(mem_buffer, 32, 16);
     StateRunner *runner = (StateRunner*)mem_buffer;
 
@@ -265,6 +278,243 @@ void testFreesMemory() {
 }
 
 
+void testStateHandles() {
+
+    StateRunner *runner = StateRunner_init(32, 4);
+    TestStruct test_struct = {0, 0};
+    TestStruct other_struct = {0, 0};
+
+    ASSERT_EQUAL_INT(StateRunner_currentHandle(runner), INVALID_STATE_HANDLE);
+
+    StateRunner_addState(runner, (void*)&test_struct, runFunc, deconFunc);
+    StateRunner_commitBuffer(runner);
+    StateHandle handle = StateRunner_currentHandle(runner);
+    ASSERT_EQUAL_INT(StateRunner_getRefCount(runner, handle), 1);
+
+    // Aliases share a single reference-counted handle
+    ASSERT_EQUAL_INT(
+        StateRunner_addAlias(runner, handle, runFuncTerminates), 0);
+    ASSERT_EQUAL_INT(StateRunner_getRefCount(runner, handle), 2);
+    StateRunner_commitBuffer(runner);
+    ASSERT_EQUAL_INT(StateRunner_currentHandle(runner), handle);
+
+    // Alias pops itself - its state lives on below it
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(test_struct.run_count, 1);
+    ASSERT_EQUAL_INT(test_struct.deconstruct_count, 0);
+    ASSERT_EQUAL_INT(StateRunner_getRefCount(runner, handle), 1);
+
+    // Unrelated data gets its own handle
+    StateRunner_addState(runner, (void*)&other_struct, runFunc, NULL);
+    StateRunner_commitBuffer(runner);
+    ASSERT_NOT_EQUAL_INT(StateRunner_currentHandle(runner), handle);
+
+    // Queue holds one less than its size, and rejects aliases of dead handles
+    ASSERT_EQUAL_INT(StateRunner_addAlias(runner, handle, runFunc), 0);
+    ASSERT_EQUAL_INT(StateRunner_addAlias(runner, handle, runFunc), 0);
+    ASSERT_EQUAL_INT(StateRunner_addAlias(runner, handle, runFunc), 0);
+    ASSERT_EQUAL_INT(StateRunner_addAlias(runner, handle, runFunc), -1);
+    ASSERT_EQUAL_INT(StateRunner_getRefCount(runner, handle), 4);
+    ASSERT_EQUAL_INT(StateRunner_addAlias(runner, 30, runFunc), -1);
+    ASSERT_EQUAL_INT(
+        StateRunner_addAlias(runner, INVALID_STATE_HANDLE, runFunc), -1);
+    StateRunner_commitBuffer(runner);
+    ASSERT_EQUAL_INT(StateRunner_getStateCount(runner), 5);
+
+    // Deconstructed once, when the last reference pops
+    StateRunner_setPopCount(runner, 4);
+    StateRunner_flushPop(runner);
+    ASSERT_EQUAL_INT(test_struct.deconstruct_count, 0);
+    ASSERT_EQUAL_INT(StateRunner_getRefCount(runner, handle), 1);
+
+    StateRunner_setPopCount(runner, 1);
+    StateRunner_flushPop(runner);
+    ASSERT_EQUAL_INT(test_struct.deconstruct_count, 1);
+    ASSERT_EQUAL_INT(StateRunner_getRefCount(runner, handle), 0);
+    ASSERT_EQUAL_INT(StateRunner_addAlias(runner, handle, runFunc), -1);
+
+    StateRunner_deconstruct(runner);
+    ASSERT_EQUAL_INT(test_struct.deconstruct_count, 1);
+}
+
+
+void testSkipDraw() {
+
+    StateRunner *runner = StateRunner_init(32, 16);
+    TestStruct static_struct = {0, 0};
+    TestStruct other_struct = {0, 0};
+
+    StateRunner_addState(runner, (void*)&static_struct, runFuncStatic, NULL);
+    StateRunner_commitBuffer(runner);
+
+    // First frame must always be drawn
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(static_struct.run_count, 1);
+    ASSERT_FALSE(StateRunner_drawSkipped(runner));
+
+    // Nothing changed - subsequent frames skipped
+    StateRunner_runState(runner, NULL);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(static_struct.run_count, 1);
+    ASSERT_TRUE(StateRunner_drawSkipped(runner));
+    ASSERT_TRUE(StateRunner_idle(runner));
+
+    // Requested redraws are honored once
+    StateRunner_requestRedraw(runner);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(static_struct.run_count, 2);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(static_struct.run_count, 2);
+
+    // A state drawn over the static one forces it to redraw once uncovered
+    StateRunner_addState(runner, (void*)&other_struct, runFuncTerminates, NULL);
+    StateRunner_commitBuffer(runner);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(other_struct.run_count, 1);
+
+    // popping frame has nothing to present, but mustn't wait for input
+    ASSERT_TRUE(StateRunner_drawSkipped(runner));
+    ASSERT_FALSE(StateRunner_idle(runner));
+
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(static_struct.run_count, 3);
+    ASSERT_FALSE(StateRunner_drawSkipped(runner));
+
+    StateRunner_deconstruct(runner);
+}
+
+
+// An overlay runner that counts frames in which it re-renders its underlay
+int runFuncOverlay(StateRunner *runner, void *app_data, void *state_data) {
+    TestStruct *local_state = (TestStruct*)state_data;
+
+    if (StateRunner_underlayStale(runner)) {
+        local_state->run_count++;
+    }
+    return 0;
+}
+
+void testOverlayUnderlay() {
+
+    StateRunner *runner = StateRunner_init(32, 16);
+    TestStruct base_struct = {0, 0};
+
+    StateRunner_addState(runner, (void*)&base_struct, runFunc, NULL);
+    StateRunner_commitBuffer(runner);
+
+    // Non-overlay states have no underlay
+    ASSERT_FALSE(StateRunner_underlayStale(runner));
+
+    StateRunner_addOverlay(
+        runner, StateRunner_currentHandle(runner), runFuncOverlay);
+    StateRunner_commitBuffer(runner);
+
+    // Rendered once when pushed, then cached
+    StateRunner_runState(runner, NULL);
+    StateRunner_runState(runner, NULL);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(base_struct.run_count, 1);
+
+    // Redraw requests & invalidation re-render it once
+    StateRunner_requestRedraw(runner);
+    StateRunner_runState(runner, NULL);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(base_struct.run_count, 2);
+
+    StateRunner_invalidateUnderlay(runner);
+    StateRunner_runState(runner, NULL);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(base_struct.run_count, 3);
+
+    // Covered by a state that runs once (counted) & pops...
+    StateRunner_addAlias(
+        runner, StateRunner_currentHandle(runner), runFuncTerminates);
+    StateRunner_commitBuffer(runner);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(base_struct.run_count, 4);
+
+    // ...so is re-rendered once uncovered
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(base_struct.run_count, 5);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(base_struct.run_count, 5);
+
+    StateRunner_deconstruct(runner);
+}
+
+
+static int arena_decon_count = 0;
+
+static int arenaDeconFunc(void *state_data) {
+    TestStruct *local_state = (TestStruct*)state_data;
+    arena_decon_count += 1 + local_state->deconstruct_count;
+    return 0;
+}
+
+void testArenaStates() {
+
+    StateRunner *runner = StateRunner_init(32, 2);
+    ASSERT_EQUAL_INT(StateRunner_reserveArenas(runner, 2, 1024), 0);
+    ASSERT_EQUAL_INT(runner->num_arenas, 2);
+
+    // State data is allocated from a claimed arena
+    Arena *arena = StateRunner_claimArena(runner);
+    ASSERT_EQUAL_INT(runner->num_arenas, 1);
+    TestStruct *test_struct = Arena_calloc(arena, 1, sizeof(TestStruct));
+    ASSERT_EQUAL_INT(
+        StateRunner_addArenaState(
+            runner, arena, test_struct, runFuncTerminates, arenaDeconFunc),
+        0
+    );
+    StateRunner_commitBuffer(runner);
+
+    // Aliases keep it alive, as with any other state
+    StateRunner_addAlias(
+        runner, StateRunner_currentHandle(runner), runFuncTerminates);
+    StateRunner_commitBuffer(runner);
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(arena_decon_count, 0);
+    ASSERT_EQUAL_INT(runner->num_arenas, 1);
+
+    // Arena is reset & pooled again once the state is deconstructed
+    StateRunner_runState(runner, NULL);
+    ASSERT_EQUAL_INT(arena_decon_count, 1);
+    ASSERT_EQUAL_INT(runner->num_arenas, 2);
+    ASSERT_EQUAL_INT((int)Arena_used(arena), 0);
+
+    // State that can't be added is deconstructed, and its arena returned
+    StateRunner_addState(runner, NULL, runFunc, NULL);
+    arena = StateRunner_claimArena(runner);
+    test_struct = Arena_calloc(arena, 1, sizeof(TestStruct));
+    ASSERT_EQUAL_INT(
+        StateRunner_addArenaState(
+            runner, arena, test_struct, runFunc, arenaDeconFunc),
+        -1
+    );
+    ASSERT_EQUAL_INT(arena_decon_count, 2);
+    ASSERT_EQUAL_INT(runner->num_arenas, 2);
+
+    // An empty pool hands out new arenas, keeping only as many as reserved
+    Arena *extra[3];
+    for (int i = 0; i < 3; i++) {
+        extra[i] = StateRunner_claimArena(runner);
+        ASSERT_TRUE(extra[i] != NULL);
+    }
+    ASSERT_EQUAL_INT(runner->num_arenas, 0);
+    for (int i = 0; i < 3; i++) {
+        StateRunner_returnArena(runner, extra[i]);
+    }
+    ASSERT_EQUAL_INT(runner->num_arenas, 2);
+
+    // Live arena states are deconstructed along with the StateRunner
+    StateRunner_commitBuffer(runner);
+    arena = StateRunner_claimArena(runner);
+    test_struct = Arena_calloc(arena, 1, sizeof(TestStruct));
+    StateRunner_addArenaState(runner, arena, test_struct, runFunc, arenaDeconFunc);
+    StateRunner_deconstruct(runner);
+    ASSERT_EQUAL_INT(arena_decon_count, 3);
+}
+
 
 int main() {
     EWENIT_START;
@@ -279,6 +529,10 @@ int main() {
     ADD_CASE(testPopMultiple);
 
     ADD_CASE(testFreesMemory);
+    ADD_CASE(testStateHandles);
+    ADD_CASE(testOverlayUnderlay);
+    ADD_CASE(testArenaStates);
+    ADD_CASE(testSkipDraw);
     EWENIT_END;
 
 }
@@ -1,5 +1,7 @@
 
 #include <EWENIT.h>
+#include <stdbool.h>
+#include "scratch.h"
 #include "utilities.h"
 
 
@@ -100,6 +102,44 @@ void testSortByOrder() {
 
 }
 
+void testSortScratch() {
+
+    ASSERT_EQUAL_INT(Scratch_init(0), 0);
+
+    int basis[1000];
+    int indices[1000];
+    for (int i = 0; i < 1000; i++) {
+        basis[i] = rand();
+    }
+
+    // Large sorts take their working memory from scratch
+    sortByBasisDesc(1000, indices, basis);
+    size_t frame_used = Scratch_used();
+    ASSERT_TRUE(frame_used >= 1000 * sizeof(int));
+
+    // ...which is released at once, and fits the same work next frame
+    Scratch_reset();
+    ASSERT_EQUAL_INT((int)Scratch_used(), 0);
+
+    sortByBasisDesc(1000, indices, basis);
+    ASSERT_EQUAL_INT((int)Scratch_used(), (int)frame_used);
+
+    bool ordered = true;
+    for (int i = 1; i < 1000; i++) {
+        ordered = ordered && basis[indices[i - 1]] >= basis[indices[i]];
+    }
+    ASSERT_TRUE(ordered);
+
+    // Small sorts stay on the stack
+    Scratch_reset();
+    sortByBasisDesc(8, indices, basis);
+    ASSERT_EQUAL_INT((int)Scratch_used(), 0);
+
+    Scratch_deconstruct();
+    ASSERT_TRUE(Scratch_alloc(1) == NULL);
+}
+
+
 void testParseInt() {
 
     int num;
@@ -205,11 +245,21 @@ void testParseName() {
  * Test running
 ******************************************************************************/
 
+void testChecksumCrc32() {
+    ASSERT_EQUAL_INT((int)checksumCrc32("", 0), 0);
+    ASSERT_TRUE(checksumCrc32("123456789", 9) == 0xCBF43926u);
+    ASSERT_TRUE(checksumCrc32("123456789", 8) != 0xCBF43926u);
+}
+
+
+
 int main() {
     EWENIT_START;
     ADD_CASE(testParseInt);
     ADD_CASE(testParseName);
     ADD_CASE(testSortByBasis);
     ADD_CASE(testSortByOrder);
+    ADD_CASE(testSortScratch);
+    ADD_CASE(testChecksumCrc32);
     EWENIT_END;
 }
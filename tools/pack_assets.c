@@ -0,0 +1,32 @@
+/* pack_assets.c
+ *
+ * Build-time tool that packs asset files into a single asset pack (see
+ * asset_pack.h). Run by `make build_pack`:
+ *
+ *     pack_assets OUT_FILE ASSET_DIR ASSET...
+ *
+ * where each ASSET is a path relative to ASSET_DIR, and becomes the name the
+ * asset is found by in the pack.
+ */
+
+#include <stdio.h>
+
+#include "asset_pack.h"
+#include "sirtet.h"
+
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        printf("Usage: %s OUT_FILE ASSET_DIR ASSET...\n", argv[0]);
+        return 1;
+    }
+
+    if (AssetPack_build(argv[1], argv[2], (const char *const *)(argv + 3), argc - 3) != 0) {
+        printf("%s", Sirtet_getError());
+        return 1;
+    }
+
+    printf("Packed %d assets into %s\n", argc - 3, argv[1]);
+    return 0;
+}